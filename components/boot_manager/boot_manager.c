@@ -0,0 +1,180 @@
+/**
+ * @file boot_manager.c
+ * @brief Boot Manager implementacija
+ */
+#include "boot_manager.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/event_groups.h"
+
+static const char *TAG = "boot_mgr";
+
+static const boot_stage_t *s_stages = NULL;
+static size_t s_count = 0;
+static boot_stage_result_t s_results[BOOT_MANAGER_MAX_STAGES];
+static EventGroupHandle_t s_done_group = NULL;     // Bit n = stage n končal
+static uint32_t s_ok_mask = 0;                     // Bit n = stage n uspel
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void stage_task(void *arg)
+{
+    size_t id = (size_t)arg;
+    const boot_stage_t *stage = &s_stages[id];
+    boot_stage_result_t *result = &s_results[id];
+    uint32_t wait_mask = stage->requires | stage->after;
+    
+    if (wait_mask) {
+        xEventGroupWaitBits(s_done_group, wait_mask, pdFALSE, pdTRUE, portMAX_DELAY);
+    }
+    
+    portENTER_CRITICAL(&s_mux);
+    bool deps_ok = (s_ok_mask & stage->requires) == stage->requires;
+    portEXIT_CRITICAL(&s_mux);
+    
+    result->start_us = esp_timer_get_time();
+    
+    if (deps_ok) {
+        result->result = stage->fn();
+    } else {
+        result->skipped = true;
+        result->result = ESP_ERR_INVALID_STATE;
+    }
+    
+    result->ready_us = esp_timer_get_time();
+    result->done = true;
+    
+    if (result->skipped) {
+        ESP_LOGW(TAG, "[%6lld ms] %s skipped (dependency failed)",
+                 (long long)(result->ready_us / 1000), stage->name);
+    } else if (result->result == ESP_OK) {
+        ESP_LOGI(TAG, "[%6lld ms] %s ready (%lld ms)",
+                 (long long)(result->ready_us / 1000), stage->name,
+                 (long long)((result->ready_us - result->start_us) / 1000));
+    } else {
+        ESP_LOGE(TAG, "[%6lld ms] %s failed: %s (%lld ms)",
+                 (long long)(result->ready_us / 1000), stage->name, esp_err_to_name(result->result),
+                 (long long)((result->ready_us - result->start_us) / 1000));
+    }
+    
+    portENTER_CRITICAL(&s_mux);
+    if (result->result == ESP_OK) {
+        s_ok_mask |= BOOT_STAGE_BIT(id);
+    }
+    portEXIT_CRITICAL(&s_mux);
+    
+    xEventGroupSetBits(s_done_group, BOOT_STAGE_BIT(id));
+    vTaskDelete(NULL);
+}
+
+esp_err_t boot_manager_run(const boot_stage_t *stages, size_t count, uint32_t timeout_ms)
+{
+    if (stages == NULL || count == 0 || count > BOOT_MANAGER_MAX_STAGES) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_stages != NULL) {
+        ESP_LOGE(TAG, "Boot already started");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    uint32_t all_mask = (uint32_t)(BOOT_STAGE_BIT(count) - 1);
+    for (size_t i = 0; i < count; i++) {
+        uint32_t deps = stages[i].requires | stages[i].after;
+        // Samo odvisnosti na prejšnje stage-e - tako cikli niso možni
+        if (stages[i].fn == NULL || (deps & ~(BOOT_STAGE_BIT(i) - 1)) != 0) {
+            ESP_LOGE(TAG, "Invalid stage %u (%s)", (unsigned)i, stages[i].name ? stages[i].name : "?");
+            return ESP_ERR_INVALID_ARG;
+        }
+    }
+    
+    s_done_group = xEventGroupCreate();
+    if (s_done_group == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    s_stages = stages;
+    s_count = count;
+    s_ok_mask = 0;
+    
+    int64_t boot_start_us = esp_timer_get_time();
+    UBaseType_t prio = uxTaskPriorityGet(NULL);
+    
+    for (size_t i = 0; i < count; i++) {
+        s_results[i] = (boot_stage_result_t){
+            .name = stages[i].name,
+            .result = ESP_ERR_TIMEOUT,
+        };
+    }
+    
+    for (size_t i = 0; i < count; i++) {
+        uint32_t stack = stages[i].stack_size ? stages[i].stack_size : BOOT_STAGE_DEFAULT_STACK;
+        if (xTaskCreate(stage_task, stages[i].name, stack, (void *)i, prio, NULL) != pdPASS) {
+            // Odvisni stage-i se preskočijo, ostali tečejo naprej
+            ESP_LOGE(TAG, "Failed to start stage %s", stages[i].name);
+            s_results[i].result = ESP_ERR_NO_MEM;
+            s_results[i].done = true;
+            xEventGroupSetBits(s_done_group, BOOT_STAGE_BIT(i));
+        }
+    }
+    
+    EventBits_t bits = xEventGroupWaitBits(s_done_group, all_mask, pdFALSE, pdTRUE,
+                                           pdMS_TO_TICKS(timeout_ms));
+    
+    ESP_LOGI(TAG, "Boot finished in %lld ms", (long long)((esp_timer_get_time() - boot_start_us) / 1000));
+    boot_manager_log_timeline();
+    
+    if ((bits & all_mask) != all_mask) {
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    portENTER_CRITICAL(&s_mux);
+    bool all_ok = (s_ok_mask == all_mask);
+    portEXIT_CRITICAL(&s_mux);
+    
+    return all_ok ? ESP_OK : ESP_FAIL;
+}
+
+bool boot_manager_stage_ok(size_t id)
+{
+    if (id >= s_count) {
+        return false;
+    }
+    
+    portENTER_CRITICAL(&s_mux);
+    bool ok = (s_ok_mask & BOOT_STAGE_BIT(id)) != 0;
+    portEXIT_CRITICAL(&s_mux);
+    
+    return ok;
+}
+
+esp_err_t boot_manager_get_result(size_t id, boot_stage_result_t *result)
+{
+    if (id >= s_count || result == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    *result = s_results[id];
+    return ESP_OK;
+}
+
+void boot_manager_log_timeline(void)
+{
+    ESP_LOGI(TAG, "Boot timeline:");
+    ESP_LOGI(TAG, "  %-12s %8s %8s %8s  %s", "stage", "start", "ready", "took", "result");
+    
+    for (size_t i = 0; i < s_count; i++) {
+        const boot_stage_result_t *r = &s_results[i];
+        
+        if (!r->done) {
+            ESP_LOGW(TAG, "  %-12s %8lld %8s %8s  still running", r->name,
+                     (long long)(r->start_us / 1000), "-", "-");
+        } else if (r->skipped) {
+            ESP_LOGW(TAG, "  %-12s %8s %8s %8s  skipped", r->name, "-", "-", "-");
+        } else {
+            ESP_LOGI(TAG, "  %-12s %8lld %8lld %8lld  %s", r->name,
+                     (long long)(r->start_us / 1000), (long long)(r->ready_us / 1000),
+                     (long long)((r->ready_us - r->start_us) / 1000), esp_err_to_name(r->result));
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/**
+ * @file boot_manager.h
+ * @brief Boot Manager - vzporedna inicializacija podsistemov z odvisnostmi
+ *
+ * Vsak stage teče v svojem tasku in začne takoj, ko so izpolnjene njegove
+ * odvisnosti. Počasni stage-i (WiFi) tako ne zadržijo hitrih (senzor, UI).
+ */
+#ifndef BOOT_MANAGER_H
+#define BOOT_MANAGER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+
+#define BOOT_MANAGER_MAX_STAGES     16
+#define BOOT_STAGE_DEFAULT_STACK    4096
+
+/** Maska za stage z indeksom n (za requires / after) */
+#define BOOT_STAGE_BIT(n)           (1UL << (n))
+
+/**
+ * @brief Funkcija stage-a (teče v lastnem tasku)
+ * @return ESP_OK če je podsistem pripravljen
+ */
+typedef esp_err_t (*boot_stage_fn_t)(void);
+
+/**
+ * @brief Opis enega stage-a; indeks v tabeli je njegov ID
+ */
+typedef struct {
+    const char *name;
+    boot_stage_fn_t fn;
+    uint32_t requires;      // Stage-i, ki morajo uspeti (sicer se ta preskoči)
+    uint32_t after;         // Stage-i, ki morajo le končati (uspeh ni pogoj)
+    uint32_t stack_size;    // 0 = BOOT_STAGE_DEFAULT_STACK
+} boot_stage_t;
+
+/**
+ * @brief Rezultat stage-a za boot timeline
+ */
+typedef struct {
+    const char *name;
+    esp_err_t result;       // ESP_ERR_INVALID_STATE če je bil preskočen
+    bool done;
+    bool skipped;
+    int64_t start_us;       // Čas od boot-a (esp_timer)
+    int64_t ready_us;
+} boot_stage_result_t;
+
+/**
+ * @brief Zažene vse stage-e in počaka, da končajo
+ *
+ * Vsak zaključen stage se sproti zapiše v log, na koncu pa še celoten
+ * timeline. Stage-i, ki ob timeout-u še tečejo, nadaljujejo v ozadju.
+ *
+ * @param stages Tabela stage-ov (mora živeti do konca boot-a)
+ * @param count Število stage-ov (max BOOT_MANAGER_MAX_STAGES)
+ * @param timeout_ms Največji čas čakanja
+ * @return ESP_OK če so vsi uspeli, ESP_FAIL če je kakšen padel ali bil
+ *         preskočen, ESP_ERR_TIMEOUT če kakšen še teče
+ */
+esp_err_t boot_manager_run(const boot_stage_t *stages, size_t count, uint32_t timeout_ms);
+
+/**
+ * @brief Ali je stage uspešno končal (za stage-e z "after" odvisnostjo)
+ * @param id Indeks stage-a
+ * @return true če je končal z ESP_OK
+ */
+bool boot_manager_stage_ok(size_t id);
+
+/**
+ * @brief Dobi rezultat stage-a
+ * @param id Indeks stage-a
+ * @param result Output struktura
+ * @return ESP_OK, ESP_ERR_INVALID_ARG za neveljaven ID
+ */
+esp_err_t boot_manager_get_result(size_t id, boot_stage_result_t *result);
+
+/**
+ * @brief Izpiše boot timeline (vsi stage-i, začetek in čas do pripravljenosti)
+ */
+void boot_manager_log_timeline(void);
+
+#endif // BOOT_MANAGER_H
@@ -1,4 +1,3 @@
-
 /**
  * @file display_manager.c
  * @brief Display Manager implementacija
@@ -6,12 +5,280 @@
 #include "display_manager.h" 
 #include "bsp/esp-bsp.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <time.h>
 
 static const char *TAG = "display_mgr";
 
+#define POLICY_PERIOD_MS        100     // Kako pogosto preverimo neaktivnost
+#define TIME_VALID_YEAR         2024    // Pred tem letom ura ni sinhronizirana
+
 // File-scope spremenljivke
 static lv_display_t *display_handle = NULL;
 
+// Idle policy
+static display_power_config_t s_power_cfg = DISPLAY_POWER_DEFAULT_CONFIG();
+static uint8_t s_brightness_active = 100;
+static uint8_t s_brightness_applied = 100;
+static display_power_state_t s_power_state = DISPLAY_POWER_ACTIVE;
+static lv_timer_t *s_policy_timer = NULL;
+
+// Dotik, ki zbudi display, se ne sme videti kot pritisk
+static lv_indev_t *s_touch_indev = NULL;
+static lv_indev_read_cb_t s_touch_read_orig = NULL;
+static bool s_swallow_touch = false;
+
+// Statistika (pišeta LVGL task in set_brightness, bere poljuben task)
+static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+static display_power_stats_t s_power_stats = {0};
+static uint64_t s_time_us[DISPLAY_POWER_STATE_COUNT];
+static uint64_t s_render_us[DISPLAY_POWER_STATE_COUNT];
+static uint64_t s_backlight_weighted;   // Σ svetlost × čas
+static uint64_t s_backlight_reference;  // Σ ACTIVE svetlost × čas (brez policy)
+static int64_t s_account_us = 0;
+static int64_t s_refr_start_us = 0;
+
+// Render budget (piše LVGL task)
+static display_render_stats_t s_render_stats = {0};
+static uint32_t s_frame_px = 0;
+
+/**
+ * @brief Prišteje pretečeni čas trenutnemu stanju (kliči pod s_stats_mux)
+ */
+static void account_time(int64_t now)
+{
+    uint64_t elapsed = (uint64_t)(now - s_account_us);
+    
+    s_time_us[s_power_state] += elapsed;
+    s_backlight_weighted += elapsed * s_brightness_applied;
+    s_backlight_reference += elapsed * s_brightness_active;
+    s_account_us = now;
+}
+
+static void apply_brightness(uint8_t brightness)
+{
+    if (brightness == s_brightness_applied) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_stats_mux);
+    account_time(esp_timer_get_time());
+    s_brightness_applied = brightness;
+    portEXIT_CRITICAL(&s_stats_mux);
+    
+    bsp_display_brightness_set(brightness);
+    ESP_LOGD(TAG, "Brightness → %d%%", brightness);
+}
+
+static bool is_night(void)
+{
+    if (s_power_cfg.night_start_hour == s_power_cfg.night_end_hour) {
+        return false;
+    }
+    
+    time_t now = time(NULL);
+    struct tm tm_now;
+    localtime_r(&now, &tm_now);
+    
+    if (tm_now.tm_year + 1900 < TIME_VALID_YEAR) {
+        // Ura še ni nastavljena - nočnega režima ne uganemo
+        return false;
+    }
+    
+    int h = tm_now.tm_hour;
+    if (s_power_cfg.night_start_hour > s_power_cfg.night_end_hour) {
+        // Čez polnoč (npr. 22-6)
+        return h >= s_power_cfg.night_start_hour || h < s_power_cfg.night_end_hour;
+    }
+    return h >= s_power_cfg.night_start_hour && h < s_power_cfg.night_end_hour;
+}
+
+static uint8_t active_brightness(void)
+{
+    if (is_night() && s_power_cfg.brightness_night < s_brightness_active) {
+        return s_power_cfg.brightness_night;
+    }
+    return s_brightness_active;
+}
+
+static void set_refresh_period(uint32_t period_ms)
+{
+    lv_timer_t *refr = lv_display_get_refr_timer(display_handle);
+    
+    if (refr != NULL && period_ms > 0) {
+        lv_timer_set_period(refr, period_ms);
+    }
+}
+
+/**
+ * @brief Prehod med stanji idle policy (teče v LVGL tasku)
+ */
+static void enter_power_state(display_power_state_t next)
+{
+    display_power_state_t prev = s_power_state;
+    
+    portENTER_CRITICAL(&s_stats_mux);
+    account_time(esp_timer_get_time());
+    s_power_state = next;
+    if (prev == DISPLAY_POWER_BLANK && next == DISPLAY_POWER_ACTIVE) {
+        s_power_stats.wakeups++;
+    }
+    portEXIT_CRITICAL(&s_stats_mux);
+    
+    switch (next) {
+        case DISPLAY_POWER_ACTIVE:
+            if (prev == DISPLAY_POWER_BLANK) {
+                lv_display_enable_invalidation(display_handle, true);
+                lv_obj_invalidate(lv_screen_active());
+            }
+            set_refresh_period(s_power_cfg.refr_active_ms);
+            apply_brightness(active_brightness());
+            break;
+            
+        case DISPLAY_POWER_DIM:
+            set_refresh_period(s_power_cfg.refr_idle_ms);
+            apply_brightness(s_power_cfg.brightness_dim < active_brightness() ?
+                             s_power_cfg.brightness_dim : active_brightness());
+            break;
+            
+        case DISPLAY_POWER_BLANK:
+            apply_brightness(0);
+            // Brez invalidacije LVGL ne renderira in ne pošilja po SPI
+            lv_display_enable_invalidation(display_handle, false);
+            set_refresh_period(s_power_cfg.refr_idle_ms);
+            break;
+            
+        default:
+            break;
+    }
+    
+    ESP_LOGI(TAG, "Power state: %d → %d", prev, next);
+}
+
+static void policy_timer_cb(lv_timer_t *timer)
+{
+    uint32_t idle_ms = lv_display_get_inactive_time(display_handle);
+    display_power_state_t next = DISPLAY_POWER_ACTIVE;
+    
+    if (s_power_cfg.blank_after_ms > 0 && idle_ms >= s_power_cfg.blank_after_ms) {
+        next = DISPLAY_POWER_BLANK;
+    } else if (s_power_cfg.dim_after_ms > 0 && idle_ms >= s_power_cfg.dim_after_ms) {
+        next = DISPLAY_POWER_DIM;
+    }
+    
+    if (next != s_power_state) {
+        enter_power_state(next);
+    } else if (next == DISPLAY_POWER_ACTIVE) {
+        // Nočni režim se lahko spremeni tudi brez dotika
+        apply_brightness(active_brightness());
+    }
+}
+
+/**
+ * @brief Touch read ovoj: dotik iz BLANK zbudi display in ga pogoltne
+ *
+ * Teče v LVGL tasku pred obdelavo dotika, zato widget PRESSED nikoli ne
+ * dobi. Pritisk ostane pogoltnjen do release-a (tudi LONG_PRESSED_REPEAT).
+ */
+static void touch_read_cb(lv_indev_t *indev, lv_indev_data_t *data)
+{
+    s_touch_read_orig(indev, data);
+    
+    if (data->state != LV_INDEV_STATE_PRESSED) {
+        s_swallow_touch = false;
+        return;
+    }
+    
+    if (s_power_state == DISPLAY_POWER_BLANK) {
+        s_swallow_touch = true;
+        // LVGL spuščenega dotika ne šteje kot aktivnost
+        lv_display_trigger_activity(display_handle);
+        enter_power_state(DISPLAY_POWER_ACTIVE);
+    }
+    
+    if (s_swallow_touch) {
+        data->state = LV_INDEV_STATE_RELEASED;
+    }
+}
+
+/**
+ * @brief Ovije read callback touch indev-a (kliči pod bsp_display_lock)
+ */
+static void install_touch_filter(void)
+{
+    if (s_touch_indev != NULL) {
+        return;
+    }
+    
+    for (lv_indev_t *indev = lv_indev_get_next(NULL); indev != NULL;
+         indev = lv_indev_get_next(indev)) {
+        if (lv_indev_get_type(indev) == LV_INDEV_TYPE_POINTER) {
+            s_touch_indev = indev;
+            s_touch_read_orig = lv_indev_get_read_cb(indev);
+            lv_indev_set_read_cb(indev, touch_read_cb);
+            return;
+        }
+    }
+    
+    ESP_LOGW(TAG, "No touch input - wake touch is not filtered");
+}
+
+/**
+ * @brief Display eventi: render čas, invalidirana in poslana območja
+ */
+static void display_event_cb(lv_event_t *e)
+{
+    lv_event_code_t code = lv_event_get_code(e);
+    const lv_area_t *area = lv_event_get_param(e);
+    int64_t now = esp_timer_get_time();
+    
+    portENTER_CRITICAL(&s_stats_mux);
+    switch (code) {
+        case LV_EVENT_INVALIDATE_AREA:
+            if (area != NULL) {
+                s_render_stats.invalidations++;
+                s_render_stats.invalidated_px += lv_area_get_size(area);
+            }
+            break;
+            
+        case LV_EVENT_FLUSH_START:
+            if (area != NULL) {
+                uint32_t px = lv_area_get_size(area);
+                s_render_stats.flushes++;
+                s_render_stats.flushed_px += px;
+                s_frame_px += px;
+            }
+            break;
+            
+        case LV_EVENT_REFR_START:
+            s_refr_start_us = now;
+            s_frame_px = 0;
+            break;
+            
+        case LV_EVENT_REFR_READY:
+            s_render_us[s_power_state] += (uint64_t)(now - s_refr_start_us);
+            if (s_frame_px > 0) {
+                uint32_t render_us = (uint32_t)(now - s_refr_start_us);
+                s_render_stats.last_render_us = render_us;
+                if (render_us > s_render_stats.max_render_us) {
+                    s_render_stats.max_render_us = render_us;
+                }
+                s_power_stats.frames[s_power_state]++;
+                s_render_stats.frames++;
+                s_render_stats.last_frame_px = s_frame_px;
+                if (s_frame_px > s_render_stats.max_frame_px) {
+                    s_render_stats.max_frame_px = s_frame_px;
+                }
+            }
+            break;
+            
+        default:
+            break;
+    }
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
 esp_err_t display_manager_init(void)
 {
     ESP_LOGI(TAG, "Inicializiram display manager...");
@@ -25,6 +292,15 @@ esp_err_t display_manager_init(void)
     
     // Vklopi backlight
     bsp_display_backlight_on();
+    s_account_us = esp_timer_get_time();
+    
+    // Render budget + render čas za idle policy
+    bsp_display_lock(0);
+    lv_display_add_event_cb(display_handle, display_event_cb, LV_EVENT_INVALIDATE_AREA, NULL);
+    lv_display_add_event_cb(display_handle, display_event_cb, LV_EVENT_FLUSH_START, NULL);
+    lv_display_add_event_cb(display_handle, display_event_cb, LV_EVENT_REFR_START, NULL);
+    lv_display_add_event_cb(display_handle, display_event_cb, LV_EVENT_REFR_READY, NULL);
+    bsp_display_unlock();
     
     ESP_LOGI(TAG, "Display je uspešno inicializiran");
     return ESP_OK;
@@ -42,7 +318,109 @@ esp_err_t display_manager_set_brightness(uint8_t brightness)
         return ESP_ERR_INVALID_ARG;
     }
     
-    bsp_display_brightness_set(brightness);
+    portENTER_CRITICAL(&s_stats_mux);
+    account_time(esp_timer_get_time());
+    s_brightness_active = brightness;
+    portEXIT_CRITICAL(&s_stats_mux);
+    
+    if (s_policy_timer != NULL) {
+        // Policy odloči o dejanski svetlosti (dim/blank/noč)
+        bsp_display_lock(0);
+        if (s_power_state == DISPLAY_POWER_ACTIVE) {
+            apply_brightness(active_brightness());
+        }
+        bsp_display_unlock();
+    } else {
+        portENTER_CRITICAL(&s_stats_mux);
+        s_brightness_applied = brightness;
+        portEXIT_CRITICAL(&s_stats_mux);
+        bsp_display_brightness_set(brightness);
+    }
+    
     ESP_LOGI(TAG, "Display brightness set to %d%%", brightness);
     return ESP_OK;
-}
\ No newline at end of file
+}
+
+esp_err_t display_manager_set_power_policy(const display_power_config_t *config)
+{
+    if (display_handle == NULL) {
+        ESP_LOGE(TAG, "Display not initialized");
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    display_power_config_t cfg = DISPLAY_POWER_DEFAULT_CONFIG();
+    if (config != NULL) {
+        cfg = *config;
+    }
+    
+    if (cfg.night_start_hour > 23 || cfg.night_end_hour > 23 ||
+        cfg.brightness_dim > 100 || cfg.brightness_night > 100) {
+        ESP_LOGE(TAG, "Invalid power policy config");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    bsp_display_lock(0);
+    
+    s_power_cfg = cfg;
+    
+    if (s_policy_timer == NULL) {
+        s_policy_timer = lv_timer_create(policy_timer_cb, POLICY_PERIOD_MS, NULL);
+    }
+    install_touch_filter();
+    
+    // Začni v ACTIVE z novimi nastavitvami
+    lv_display_trigger_activity(display_handle);
+    enter_power_state(DISPLAY_POWER_ACTIVE);
+    
+    bsp_display_unlock();
+    
+    if (s_policy_timer == NULL) {
+        ESP_LOGE(TAG, "Failed to create power policy timer");
+        return ESP_FAIL;
+    }
+    
+    ESP_LOGI(TAG, "Power policy: dim %lus → %d%%, blank %lus, night %02d-%02d → %d%%",
+             (unsigned long)(cfg.dim_after_ms / 1000), cfg.brightness_dim,
+             (unsigned long)(cfg.blank_after_ms / 1000),
+             cfg.night_start_hour, cfg.night_end_hour, cfg.brightness_night);
+    return ESP_OK;
+}
+
+display_power_state_t display_manager_get_power_state(void)
+{
+    return s_power_state;
+}
+
+void display_manager_get_power_stats(display_power_stats_t *stats)
+{
+    if (stats == NULL) return;
+    
+    portENTER_CRITICAL(&s_stats_mux);
+    account_time(esp_timer_get_time());
+    *stats = s_power_stats;
+    stats->state = s_power_state;
+    for (int i = 0; i < DISPLAY_POWER_STATE_COUNT; i++) {
+        stats->time_ms[i] = s_time_us[i] / 1000;
+        stats->cpu_load_pct[i] = (s_time_us[i] > 0) ?
+                                 100.0f * (float)s_render_us[i] / (float)s_time_us[i] : 0.0f;
+    }
+    stats->backlight_saving_pct = (s_backlight_reference > 0) ?
+        100.0f * (1.0f - (float)s_backlight_weighted / (float)s_backlight_reference) : 0.0f;
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
+void display_manager_get_render_stats(display_render_stats_t *stats)
+{
+    if (stats == NULL) return;
+    
+    portENTER_CRITICAL(&s_stats_mux);
+    *stats = s_render_stats;
+    portEXIT_CRITICAL(&s_stats_mux);
+}
+
+void display_manager_reset_render_stats(void)
+{
+    portENTER_CRITICAL(&s_stats_mux);
+    s_render_stats = (display_render_stats_t){0};
+    portEXIT_CRITICAL(&s_stats_mux);
+}
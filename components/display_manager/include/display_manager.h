@@ -8,6 +8,68 @@
 #include "esp_err.h"
 #include "lvgl.h"
 
+/**
+ * @brief Stanje porabe displaya (idle policy)
+ */
+typedef enum {
+    DISPLAY_POWER_ACTIVE = 0,   // Polna svetlost, polni refresh
+    DISPLAY_POWER_DIM,          // Zatemnjen, počasnejši refresh
+    DISPLAY_POWER_BLANK,        // Backlight izklopljen, brez renderiranja
+    DISPLAY_POWER_STATE_COUNT
+} display_power_state_t;
+
+/**
+ * @brief Nastavitve idle policy
+ */
+typedef struct {
+    uint8_t brightness_dim;     // Svetlost po dim_after_ms (%)
+    uint8_t brightness_night;   // Največja svetlost ponoči (%)
+    uint32_t dim_after_ms;      // Neaktivnost do zatemnitve (0 = nikoli)
+    uint32_t blank_after_ms;    // Neaktivnost do izklopa (0 = nikoli)
+    uint32_t refr_active_ms;    // LVGL refresh perioda v ACTIVE
+    uint32_t refr_idle_ms;      // LVGL refresh perioda v DIM/BLANK
+    uint8_t night_start_hour;   // Začetek nočnega režima (0-23)
+    uint8_t night_end_hour;     // Konec nočnega režima (enako kot start = izklopljeno)
+} display_power_config_t;
+
+#define DISPLAY_POWER_DEFAULT_CONFIG() {    \
+    .brightness_dim = 10,                   \
+    .brightness_night = 10,                 \
+    .dim_after_ms = 30000,                  \
+    .blank_after_ms = 300000,               \
+    .refr_active_ms = 33,                   \
+    .refr_idle_ms = 250,                    \
+    .night_start_hour = 22,                 \
+    .night_end_hour = 6,                    \
+}
+
+/**
+ * @brief Statistika idle policy
+ */
+typedef struct {
+    display_power_state_t state;                        // Trenutno stanje
+    uint32_t wakeups;                                   // Prebujanja iz BLANK
+    uint64_t time_ms[DISPLAY_POWER_STATE_COUNT];        // Čas v posameznem stanju
+    uint32_t frames[DISPLAY_POWER_STATE_COUNT];         // Izrisani frame-i
+    float cpu_load_pct[DISPLAY_POWER_STATE_COUNT];      // LVGL render čas / čas v stanju
+    float backlight_saving_pct;                         // Ocena prihranka backlight-a
+} display_power_stats_t;
+
+/**
+ * @brief Render budget - koliko pikslov LVGL invalidira in pošlje na panel
+ */
+typedef struct {
+    uint32_t invalidations;     // LV_EVENT_INVALIDATE_AREA klici
+    uint64_t invalidated_px;    // Σ invalidiranih pikslov (pred združevanjem)
+    uint32_t frames;            // Refresh cikli z vsaj enim flush-em
+    uint32_t flushes;           // Flush klici (kosi draw bufferja)
+    uint64_t flushed_px;        // Σ pikslov, poslanih na panel
+    uint32_t last_frame_px;     // Piksli zadnjega frame-a
+    uint32_t max_frame_px;      // Največji frame
+    uint32_t last_render_us;    // Render + flush čas zadnjega frame-a
+    uint32_t max_render_us;     // Najdaljši frame
+} display_render_stats_t;
+
 /**
  * @brief Inicializira display manager
  * @return ESP_OK če uspešno
@@ -22,9 +84,50 @@ lv_obj_t* display_manager_get_screen(void);
 
 /**
  * @brief Nastavi svetlost backlight-a
+ * 
+ * Če je idle policy aktivna, je to svetlost v stanju ACTIVE.
+ * 
  * @param brightness Vrednost 0-100%
  * @return ESP_OK če uspešno
  */
 esp_err_t display_manager_set_brightness(uint8_t brightness);
 
-#endif // DISPLAY_MANAGER_H
\ No newline at end of file
+/**
+ * @brief Vklopi idle policy (dim/blank po neaktivnosti, nočni režim)
+ * 
+ * Dotik takoj vrne display v ACTIVE; dotik, ki zbudi display iz BLANK,
+ * se do release-a ne posreduje widgetom (filter v touch read callbacku).
+ * Nočni režim deluje šele, ko je ura sinhronizirana.
+ * 
+ * @param config Nastavitve (NULL = privzete)
+ * @return ESP_OK če uspešno
+ */
+esp_err_t display_manager_set_power_policy(const display_power_config_t *config);
+
+/**
+ * @brief Trenutno stanje idle policy
+ * 
+ * Namenjeno LVGL callbackom (isti task kot policy).
+ * 
+ * @return Stanje porabe displaya
+ */
+display_power_state_t display_manager_get_power_state(void);
+
+/**
+ * @brief Vrne statistiko idle policy
+ * @param stats Output struktura
+ */
+void display_manager_get_power_stats(display_power_stats_t *stats);
+
+/**
+ * @brief Vrne render budget statistiko
+ * @param stats Output struktura
+ */
+void display_manager_get_render_stats(display_render_stats_t *stats);
+
+/**
+ * @brief Ponastavi render budget statistiko
+ */
+void display_manager_reset_render_stats(void);
+
+#endif // DISPLAY_MANAGER_H
@@ -3,34 +3,232 @@
  * @brief Furnace controller implementation
  */
 #include "furnace_controller.h"
+#include "furnace_logic.h"
+#include "furnace_model.h"
 #include "shelly_manager.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include "freertos/task.h"
 #include <math.h>
+#include <stdatomic.h>
 
 static const char *TAG = "furnace_ctrl";
 
-// Hysteresis nastavitve
-#define TEMP_HYSTERESIS_HIGH  0.3f   // °C nad target → izklopi
-#define TEMP_HYSTERESIS_LOW   0.5f   // °C pod target → vklopi
+// Kontrolna strategija (histereza ali PID) - pod s_eval_lock
+static furnace_control_t s_control;
+static bool s_control_ready = false;
 
-static float s_target_temp = 21.0f;
-static float s_current_temp = 20.0f;
-static furnace_state_t s_state = FURNACE_OFF;
-static furnace_state_callback_t s_callback = NULL;
+// Toplotni model + optimal start - pod s_eval_lock
+static furnace_model_t s_model;
+static float s_upcoming_target = 0.0f;
+static int64_t s_upcoming_at_us = 0;    // 0 = ni napovedanega targeta
+static bool s_preheating = false;
+
+// Objavljeno stanje (seqlock): pisci so serializirani s s_core_mux, bralci
+// ne zaklepajo - le ponovijo kopijo, če je med branjem prišel zapis
+static furnace_snapshot_t s_core = {
+    .state = FURNACE_OFF,
+    .target_temp = 21.0f,
+    .current_temp = NAN,
+};
+static atomic_uint s_core_seq = 0;                // Liho = zapis v teku
+static portMUX_TYPE s_core_mux = portMUX_INITIALIZER_UNLOCKED;
+static furnace_state_callback_t s_callback = NULL;  // Pod s_core_mux
 static uint8_t s_relay_channel = 0;
+static bool s_have_temp = false;              // Vsaj ena meritev je že prišla
+static SemaphoreHandle_t s_eval_lock = NULL;  // Sensor task vs. takojšnja re-evalvacija
+
+// Relay write suppression - zadnje potrjeno stanje releja
+#define DEFAULT_RELAY_REFRESH_MS    300000  // Periodični resync tudi brez spremembe
+#define DEFAULT_STATUS_INTERVAL_MS  30000   // Branje power/statusa brez relay ukaza
+
+// Tracker, pending in števce pišejo sensor task (evaluate), Shelly I/O task
+// (rezultati), WebSocket task (push) in manual override - vsi pod s_relay_mux,
+// vsakič le kratka kopija/posodobitev brez logov in klicev navzven
+static portMUX_TYPE s_relay_mux = portMUX_INITIALIZER_UNLOCKED;
+static furnace_relay_tracker_t s_relay = {
+    .refresh_ms = DEFAULT_RELAY_REFRESH_MS,
+    .status_interval_ms = DEFAULT_STATUS_INTERVAL_MS,
+};
+static bool s_cmd_pending = false;            // Ukaz čaka v Shelly I/O vrsti
+static furnace_cmd_stats_t s_cmd_stats = {0};
+
+#define POWER_REPORT_DELTA_W        1.0f    // Manjše spremembe moči ne obvestijo UI
+#define CORE_READ_SPINS             16      // Poskusi pred umikom (taskYIELD)
+
+/**
+ * @brief Začetek zapisa v s_core (kratko - brez logov in klicev navzven)
+ */
+static inline void core_write_begin(void)
+{
+    portENTER_CRITICAL(&s_core_mux);
+    atomic_fetch_add_explicit(&s_core_seq, 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+}
+
+static inline void core_write_end(void)
+{
+    s_core.updated_us = esp_timer_get_time();
+    atomic_fetch_add_explicit(&s_core_seq, 1, memory_order_release);
+    portEXIT_CRITICAL(&s_core_mux);
+}
+
+static void core_read(furnace_snapshot_t *snap)
+{
+    for (unsigned spins = 0;; spins++) {
+        if (spins >= CORE_READ_SPINS) {
+            // Pisec je bil prekinjen sredi zapisa (ali piše neprestano) - ne vrti se
+            taskYIELD();
+            spins = 0;
+        }
+        
+        unsigned seq0 = atomic_load_explicit(&s_core_seq, memory_order_acquire);
+        if (seq0 & 1) {
+            continue;   // Pisec na drugem jedru - zapis traja nekaj ukazov
+        }
+        
+        *snap = *(volatile furnace_snapshot_t *)&s_core;
+        atomic_thread_fence(memory_order_acquire);
+        
+        if (atomic_load_explicit(&s_core_seq, memory_order_relaxed) == seq0) {
+            snap->version = seq0 / 2;
+            return;
+        }
+    }
+}
 
 /**
  * @brief Posodobi state in obvesti callback
+ *
+ * Callback se kliče ob spremembi stanja ali opazni spremembi moči, izven
+ * kritične sekcije in z najnovejšim stanjem - ob sočasnih posodobitvah
+ * (Shelly I/O, WebSocket) zadnji klic vedno prikaže zadnje stanje.
  */
 static void update_state(furnace_state_t new_state, float power)
 {
-    if (new_state != s_state) {
-        ESP_LOGI(TAG, "State change: %d → %d", s_state, new_state);
-        s_state = new_state;
+    core_write_begin();
+    furnace_state_t old_state = s_core.state;
+    bool notify = (new_state != old_state) || fabsf(power - s_core.power_w) >= POWER_REPORT_DELTA_W;
+    s_core.state = new_state;
+    s_core.power_w = power;
+    furnace_state_callback_t callback = s_callback;
+    core_write_end();
+    
+    if (new_state != old_state) {
+        ESP_LOGI(TAG, "State change: %d → %d", old_state, new_state);
+    }
+    
+    if (notify && callback) {
+        furnace_snapshot_t snap;
+        core_read(&snap);
+        callback(snap.state, snap.power_w);
+    }
+}
+
+/**
+ * @brief Potrjeno stanje releja iz Shelly statusa
+ */
+static bool relay_output(const shelly_status_t *status)
+{
+    return (s_relay_channel == 0) ? status->output_0 : status->output_1;
+}
+
+/**
+ * @brief Rezultat asinhronega Shelly ukaza (kliče Shelly I/O task)
+ */
+static void shelly_result_cb(const shelly_result_t *result)
+{
+    if (result->cmd.type == SHELLY_CMD_SET_RELAY) {
+        return;
+    }
+    
+    int64_t now_us = esp_timer_get_time();
+    
+    if (result->err != ESP_OK || !result->status.online) {
+        portENTER_CRITICAL(&s_relay_mux);
+        s_cmd_pending = false;
+        s_relay.last_status_us = now_us;
+        s_relay.known = false;      // Po napaki vedno resync
+        portEXIT_CRITICAL(&s_relay_mux);
         
-        if (s_callback) {
-            s_callback(new_state, power);
+        ESP_LOGE(TAG, "Failed to control Shelly relay");
+        update_state(FURNACE_ERROR, 0.0f);
+        return;
+    }
+    
+    float power = (s_relay_channel == 0) ? result->status.power_0 : result->status.power_1;
+    bool heating = relay_output(&result->status);
+    bool external = false;
+    
+    portENTER_CRITICAL(&s_relay_mux);
+    s_cmd_pending = false;
+    s_relay.last_status_us = now_us;
+    if (result->cmd.type == SHELLY_CMD_SET_AND_STATUS) {
+        s_relay.last_write_us = now_us;
+    } else if (s_relay.known && heating != s_relay.on) {
+        // Nekdo je preklopil relay mimo nas (app, tipka na Shelly)
+        external = true;
+        s_cmd_stats.resyncs++;
+    }
+    s_relay.on = heating;
+    s_relay.known = true;
+    portEXIT_CRITICAL(&s_relay_mux);
+    
+    if (result->cmd.type == SHELLY_CMD_SET_AND_STATUS && heating != result->cmd.on) {
+        ESP_LOGW(TAG, "Relay reports %s after %s command", 
+                 heating ? "ON" : "OFF", result->cmd.on ? "ON" : "OFF");
+    } else if (external) {
+        ESP_LOGW(TAG, "Relay changed externally to %s, resyncing", heating ? "ON" : "OFF");
+    }
+    
+    update_state(heating ? FURNACE_HEATING : FURNACE_OFF, power);
+    
+    furnace_snapshot_t snap;
+    core_read(&snap);
+    ESP_LOGI(TAG, "Furnace %s, Power: %.1fW, Temp: %.1f/%.1f°C (%lu ms)", 
+             heating ? "HEATING" : "OFF", power, snap.current_temp, snap.target_temp,
+             (unsigned long)result->latency_ms);
+}
+
+/**
+ * @brief Push obvestilo iz Shelly (NotifyStatus) - kliče WebSocket task
+ */
+static void shelly_notify_cb(const shelly_notify_t *event)
+{
+    if (event->channel != s_relay_channel) {
+        return;
+    }
+    
+    furnace_snapshot_t snap;
+    core_read(&snap);
+    float power = event->has_power ? event->power : snap.power_w;
+    int64_t now_us = esp_timer_get_time();
+    bool external = false;
+    
+    portENTER_CRITICAL(&s_relay_mux);
+    if (event->has_output) {
+        if (s_relay.known && event->output != s_relay.on && !s_cmd_pending) {
+            external = true;
+            s_cmd_stats.resyncs++;
         }
+        s_relay.on = event->output;
+        s_relay.known = true;
+    }
+    bool known = s_relay.known;
+    bool heating = s_relay.on;
+    if (known) {
+        s_relay.last_status_us = now_us;
+    }
+    portEXIT_CRITICAL(&s_relay_mux);
+    
+    if (external) {
+        ESP_LOGW(TAG, "Relay changed externally to %s", heating ? "ON" : "OFF");
+    }
+    
+    if (known) {
+        update_state(heating ? FURNACE_HEATING : FURNACE_OFF, power);
     }
 }
 
@@ -41,19 +239,49 @@ esp_err_t furnace_controller_init(const char *shelly_ip, uint8_t relay_channel)
     
     s_relay_channel = relay_channel;
     
+    if (!s_control_ready) {
+        furnace_control_init(&s_control, NULL);
+        s_control_ready = true;
+    }
+    
+    if (s_eval_lock == NULL) {
+        furnace_model_init(&s_model);
+        s_eval_lock = xSemaphoreCreateMutex();
+        if (s_eval_lock == NULL) {
+            ESP_LOGE(TAG, "Failed to create eval lock");
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
     esp_err_t ret = shelly_manager_init(shelly_ip);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Failed to initialize Shelly manager");
         return ret;
     }
     
+    shelly_manager_register_result_callback(shelly_result_cb);
+    
+    // Gen2+: relay/power spremembe pridejo kot push obvestila, polling le kot fallback
+    if (shelly_manager_get_api() == SHELLY_API_RPC) {
+        shelly_manager_register_notify_callback(shelly_notify_cb);
+        if (shelly_manager_notify_start() != ESP_OK) {
+            ESP_LOGW(TAG, "Shelly notifications unavailable, using polling");
+        }
+    }
+    
     // Prvo branje statusa
     shelly_status_t status;
     ret = shelly_manager_get_status(&status);
     if (ret == ESP_OK && status.online) {
         ESP_LOGI(TAG, "Shelly is online, relay %d is %s", 
                  relay_channel,
-                 (relay_channel == 0 ? status.output_0 : status.output_1) ? "ON" : "OFF");
+                 relay_output(&status) ? "ON" : "OFF");
+        int64_t now_us = esp_timer_get_time();
+        portENTER_CRITICAL(&s_relay_mux);
+        s_relay.on = relay_output(&status);
+        s_relay.known = true;
+        s_relay.last_write_us = s_relay.last_status_us = now_us;
+        portEXIT_CRITICAL(&s_relay_mux);
     } else {
         ESP_LOGW(TAG, "Shelly is offline or unreachable");
         update_state(FURNACE_ERROR, 0.0f);
@@ -70,75 +298,262 @@ void furnace_controller_set_target(float target_temp)
         return;
     }
     
-    ESP_LOGI(TAG, "Target temperature changed: %.1f°C → %.1f°C", s_target_temp, target_temp);
-    s_target_temp = target_temp;
+    core_write_begin();
+    float old_target = s_core.target_temp;
+    s_core.target_temp = target_temp;
+    core_write_end();
+    
+    ESP_LOGI(TAG, "Target temperature changed: %.1f°C → %.1f°C", old_target, target_temp);
 }
 
 float furnace_controller_get_target(void)
 {
-    return s_target_temp;
+    furnace_snapshot_t snap;
+    core_read(&snap);
+    return snap.target_temp;
 }
 
-esp_err_t furnace_controller_update_temperature(float current_temp)
+/**
+ * @brief Target za ta cikel - napovedan target že prej, če ga model potrebuje
+ */
+static float effective_target(float target, float current, int64_t now_us)
 {
-    s_current_temp = current_temp;
+    if (s_upcoming_at_us == 0) {
+        return target;
+    }
+    
+    if (now_us >= s_upcoming_at_us) {
+        // Rok je mimo - urnik je nastavil novi target sam
+        s_upcoming_at_us = 0;
+        s_preheating = false;
+        return target;
+    }
+    
+    if (s_preheating) {
+        return s_upcoming_target;
+    }
     
-    float delta = s_target_temp - current_temp;
+    if (s_upcoming_target <= target || !furnace_model_ready(&s_model)) {
+        return target;
+    }
+    
+    uint32_t lead_s = furnace_model_preheat_s(&s_model, current, s_upcoming_target);
+    if (now_us + (int64_t)lead_s * 1000000 < s_upcoming_at_us) {
+        return target;
+    }
+    
+    // Zaklep do roka - sicer bi se z naraščanjem temperature lead skrajšal in gretje ugasnilo
+    s_preheating = true;
+    ESP_LOGI(TAG, "Optimal start: heating to %.1f°C, %lld min before schedule",
+             s_upcoming_target, (long long)((s_upcoming_at_us - now_us) / 60000000));
+    return s_upcoming_target;
+}
+
+/**
+ * @brief En cikel kontrolne zanke (kliči z s_eval_lock)
+ */
+static esp_err_t evaluate(float current_temp)
+{
+    furnace_snapshot_t snap;
+    
+    core_write_begin();
+    s_core.current_temp = current_temp;
+    core_write_end();
+    core_read(&snap);
+    
+    float delta = snap.target_temp - current_temp;
     
     ESP_LOGD(TAG, "Temp update: Current=%.1f°C, Target=%.1f°C, Delta=%.2f°C", 
-             current_temp, s_target_temp, delta);
+             current_temp, snap.target_temp, delta);
     
-    // Thermostat logika z histerezom
-    bool should_heat = false;
+    int64_t now_us = esp_timer_get_time();
     
-    if (delta > TEMP_HYSTERESIS_LOW) {
-        // Precej hladneje → greje
-        should_heat = true;
-    } else if (delta < -TEMP_HYSTERESIS_HIGH) {
-        // Precej toplejše → ne greje
-        should_heat = false;
-    } else {
-        // V "gray zone" → ohrani trenutni state
-        should_heat = (s_state == FURNACE_HEATING);
+    portENTER_CRITICAL(&s_relay_mux);
+    furnace_relay_tracker_t relay = s_relay;
+    bool pending = s_cmd_pending;
+    portEXIT_CRITICAL(&s_relay_mux);
+    
+    bool heating = relay.known ? relay.on : (snap.state == FURNACE_HEATING);
+    
+    if (furnace_model_update(&s_model, current_temp, heating, snap.power_w, now_us)) {
+        ESP_LOGI(TAG, "Thermal model: +%.2f°C/h per kW (on %.2f kW), -%.2f°C/h, windows %lu/%lu",
+                 s_model.heat_rate, s_model.power_on_kw, s_model.loss_rate,
+                 (unsigned long)s_model.heat_windows, (unsigned long)s_model.cool_windows);
+    }
+    
+    // Thermostat logika (histereza ali PID) z optimal start targetom
+    float target = effective_target(snap.target_temp, current_temp, now_us);
+    bool should_heat = furnace_control_update(&s_control, current_temp, target, heating, now_us);
+    
+    if (s_control.config.mode == FURNACE_CONTROL_PID) {
+        ESP_LOGD(TAG, "PID duty: %.0f%% (I=%.2f)", s_control.duty * 100.0f, s_control.integral);
+    }
+    
+    if (pending) {
+        // Prejšnji cikel še ni zaključen (počasen Shelly) - ne kopiči ukazov
+        ESP_LOGD(TAG, "Shelly command still in flight, skipping cycle");
+        return ESP_OK;
     }
     
-    // Pošlji ukaz na Shelly
-    esp_err_t ret = shelly_manager_set_relay(s_relay_channel, should_heat);
+    shelly_cmd_t cmd = {
+        .channel = s_relay_channel,
+        .on = should_heat,
+    };
+    
+    furnace_action_t action = furnace_logic_next_action(&relay, should_heat,
+                                                        shelly_manager_notify_connected(), now_us);
+    
+    // Pending nastavlja le evaluate (pod s_eval_lock), briše ga rezultat ukaza
+    portENTER_CRITICAL(&s_relay_mux);
+    switch (action) {
+        case FURNACE_ACTION_WRITE:
+            // Sprememba, napaka ali periodični resync → relay ukaz + status
+            cmd.type = SHELLY_CMD_SET_AND_STATUS;
+            s_cmd_stats.issued++;
+            s_cmd_pending = true;
+            break;
+        case FURNACE_ACTION_POLL:
+            // Relay je že v pravem stanju - samo preberi power in preveri relay
+            cmd.type = SHELLY_CMD_GET_STATUS;
+            s_cmd_stats.suppressed++;
+            s_cmd_stats.status_polls++;
+            s_cmd_pending = true;
+            break;
+        case FURNACE_ACTION_NONE:
+        default:
+            // Push obvestila so aktivna ali status je še svež
+            s_cmd_stats.suppressed++;
+            break;
+    }
+    portEXIT_CRITICAL(&s_relay_mux);
+    
+    if (action == FURNACE_ACTION_NONE) {
+        return ESP_OK;
+    }
+    
+    esp_err_t ret = shelly_manager_post(&cmd);
     
     if (ret != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to control Shelly relay");
+        ESP_LOGE(TAG, "Failed to queue Shelly command");
+        portENTER_CRITICAL(&s_relay_mux);
+        s_cmd_pending = false;
+        portEXIT_CRITICAL(&s_relay_mux);
         update_state(FURNACE_ERROR, 0.0f);
         return ret;
     }
     
-    // Preberi status za power monitoring
-    shelly_status_t status;
-    ret = shelly_manager_get_status(&status);
+    return ESP_OK;
+}
+
+esp_err_t furnace_controller_update_temperature(float current_temp)
+{
+    if (s_eval_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
     
-    float power = 0.0f;
-    if (ret == ESP_OK && status.online) {
-        power = (s_relay_channel == 0) ? status.power_0 : status.power_1;
-        
-        furnace_state_t new_state = should_heat ? FURNACE_HEATING : FURNACE_OFF;
-        update_state(new_state, power);
-        
-        ESP_LOGI(TAG, "Furnace %s, Power: %.1fW, Temp: %.1f/%.1f°C", 
-                 should_heat ? "HEATING" : "OFF", power, current_temp, s_target_temp);
+    xSemaphoreTake(s_eval_lock, portMAX_DELAY);
+    s_have_temp = true;
+    esp_err_t ret = evaluate(current_temp);
+    xSemaphoreGive(s_eval_lock);
+    
+    return ret;
+}
+
+esp_err_t furnace_controller_reevaluate(void)
+{
+    if (s_eval_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    xSemaphoreTake(s_eval_lock, portMAX_DELAY);
+    esp_err_t ret = ESP_ERR_INVALID_STATE;
+    if (s_have_temp) {
+        furnace_snapshot_t snap;
+        core_read(&snap);
+        ret = evaluate(snap.current_temp);
+    }
+    xSemaphoreGive(s_eval_lock);
+    
+    return ret;
+}
+
+void furnace_controller_set_control(const furnace_control_config_t *config)
+{
+    if (s_eval_lock) {
+        xSemaphoreTake(s_eval_lock, portMAX_DELAY);
+    }
+    
+    furnace_control_init(&s_control, config);
+    s_control_ready = true;
+    
+    if (s_eval_lock) {
+        xSemaphoreGive(s_eval_lock);
+    }
+    
+    if (s_control.config.mode == FURNACE_CONTROL_PID) {
+        ESP_LOGI(TAG, "Control: PID Kp=%.2f/°C Ti=%.0fs Td=%.0fs, cycle %lus (min on/off %lu/%lus)",
+                 s_control.config.kp, s_control.config.ti_s, s_control.config.td_s,
+                 (unsigned long)s_control.config.cycle_s, (unsigned long)s_control.config.min_on_s,
+                 (unsigned long)s_control.config.min_off_s);
     } else {
-        update_state(FURNACE_ERROR, 0.0f);
+        ESP_LOGI(TAG, "Control: hysteresis -%.1f/+%.1f°C",
+                 s_control.config.hysteresis.below, s_control.config.hysteresis.above);
+    }
+}
+
+void furnace_controller_set_upcoming_target(float target_temp, uint32_t in_s)
+{
+    if (s_eval_lock) {
+        xSemaphoreTake(s_eval_lock, portMAX_DELAY);
     }
     
-    return ESP_OK;
+    s_upcoming_target = target_temp;
+    s_upcoming_at_us = (in_s > 0) ? esp_timer_get_time() + (int64_t)in_s * 1000000 : 0;
+    s_preheating = false;
+    
+    if (s_eval_lock) {
+        xSemaphoreGive(s_eval_lock);
+    }
+}
+
+bool furnace_controller_get_model(furnace_model_t *model)
+{
+    if (model == NULL || s_eval_lock == NULL) {
+        return false;
+    }
+    
+    xSemaphoreTake(s_eval_lock, portMAX_DELAY);
+    *model = s_model;
+    bool ready = furnace_model_ready(&s_model);
+    xSemaphoreGive(s_eval_lock);
+    
+    return ready;
+}
+
+float furnace_controller_get_duty(void)
+{
+    return s_control.duty;
 }
 
 furnace_state_t furnace_controller_get_state(void)
 {
-    return s_state;
+    furnace_snapshot_t snap;
+    core_read(&snap);
+    return snap.state;
+}
+
+void furnace_controller_get_snapshot(furnace_snapshot_t *snapshot)
+{
+    if (snapshot) {
+        core_read(snapshot);
+    }
 }
 
 void furnace_controller_register_callback(furnace_state_callback_t callback)
 {
+    portENTER_CRITICAL(&s_core_mux);
     s_callback = callback;
+    portEXIT_CRITICAL(&s_core_mux);
 }
 
 esp_err_t furnace_controller_manual_override(bool on)
@@ -146,9 +561,42 @@ esp_err_t furnace_controller_manual_override(bool on)
     ESP_LOGI(TAG, "Manual override: %s", on ? "ON" : "OFF");
     
     esp_err_t ret = shelly_manager_set_relay(s_relay_channel, on);
+    int64_t now_us = esp_timer_get_time();
+    
+    portENTER_CRITICAL(&s_relay_mux);
+    if (ret == ESP_OK) {
+        s_relay.on = on;
+        s_relay.known = true;
+        s_relay.last_write_us = now_us;
+        s_cmd_stats.issued++;
+    } else {
+        s_relay.known = false;
+    }
+    portEXIT_CRITICAL(&s_relay_mux);
+    
     if (ret == ESP_OK) {
         update_state(on ? FURNACE_HEATING : FURNACE_OFF, 0.0f);
     }
     
     return ret;
-}
\ No newline at end of file
+}
+
+void furnace_controller_set_intervals(uint32_t relay_refresh_ms, uint32_t status_interval_ms)
+{
+    portENTER_CRITICAL(&s_relay_mux);
+    s_relay.refresh_ms = relay_refresh_ms;
+    s_relay.status_interval_ms = status_interval_ms;
+    portEXIT_CRITICAL(&s_relay_mux);
+    
+    ESP_LOGI(TAG, "Relay refresh: %lu ms, status poll: %lu ms",
+             (unsigned long)relay_refresh_ms, (unsigned long)status_interval_ms);
+}
+
+void furnace_controller_get_cmd_stats(furnace_cmd_stats_t *stats)
+{
+    if (stats) {
+        portENTER_CRITICAL(&s_relay_mux);
+        *stats = s_cmd_stats;
+        portEXIT_CRITICAL(&s_relay_mux);
+    }
+}
@@ -0,0 +1,166 @@
+/**
+ * @file furnace_logic.c
+ * @brief Čista kontrolna logika termostata
+ */
+#include "furnace_logic.h"
+
+bool furnace_logic_should_heat(float current, float target, bool heating,
+                               const furnace_hysteresis_t *hyst)
+{
+    float delta = target - current;
+    
+    if (delta > hyst->below) {
+        // Precej hladneje → greje
+        return true;
+    }
+    if (delta < -hyst->above) {
+        // Precej toplejše → ne greje
+        return false;
+    }
+    
+    // V "gray zone" → ohrani trenutni state
+    return heating;
+}
+
+furnace_action_t furnace_logic_next_action(const furnace_relay_tracker_t *relay, bool should_heat,
+                                           bool push_active, int64_t now_us)
+{
+    bool refresh_due = (now_us - relay->last_write_us) >= (int64_t)relay->refresh_ms * 1000;
+    
+    if (!relay->known || should_heat != relay->on || refresh_due) {
+        // Sprememba, napaka ali periodični resync
+        return FURNACE_ACTION_WRITE;
+    }
+    
+    if (push_active ||
+        (now_us - relay->last_status_us) < (int64_t)relay->status_interval_ms * 1000) {
+        // Push obvestila so aktivna ali status je še svež
+        return FURNACE_ACTION_NONE;
+    }
+    
+    return FURNACE_ACTION_POLL;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Kontrolna strategija (histereza / PID + time-proportioning)
+// ═══════════════════════════════════════════════════════════
+
+#define PID_SLOPE_TAU_S     120.0f  // Glajenje naklona za D člen (šum senzorja)
+
+static float clampf(float value, float lo, float hi)
+{
+    if (value < lo) return lo;
+    if (value > hi) return hi;
+    return value;
+}
+
+void furnace_control_init(furnace_control_t *ctl, const furnace_control_config_t *config)
+{
+    const furnace_control_config_t defaults = FURNACE_CONTROL_DEFAULT_CONFIG();
+    
+    *ctl = (furnace_control_t){ .config = config ? *config : defaults };
+    if (ctl->config.cycle_s == 0) {
+        ctl->config.cycle_s = defaults.cycle_s;
+    }
+    furnace_control_reset(ctl);
+}
+
+void furnace_control_reset(furnace_control_t *ctl)
+{
+    ctl->primed = false;
+    ctl->integral = 0.0f;
+    ctl->slope = 0.0f;
+    ctl->duty = 0.0f;
+}
+
+/**
+ * @brief PID z anti-windup → duty 0..1
+ */
+static float pid_duty(furnace_control_t *ctl, float current, float target, int64_t now_us)
+{
+    const furnace_control_config_t *c = &ctl->config;
+    float error = target - current;
+    
+    if (!ctl->primed) {
+        ctl->primed = true;
+        ctl->last_temp = current;
+        ctl->last_us = now_us;
+        ctl->slope = 0.0f;
+        ctl->cycle_start_us = now_us;
+    }
+    
+    float dt = (now_us - ctl->last_us) / 1e6f;
+    dt = clampf(dt, 0.0f, (float)c->cycle_s);   // Po dolgem izpadu ne skoči
+    
+    if (dt > 0.0f) {
+        float alpha = dt / (dt + PID_SLOPE_TAU_S);
+        ctl->slope += alpha * ((current - ctl->last_temp) / dt - ctl->slope);
+    }
+    ctl->last_temp = current;
+    ctl->last_us = now_us;
+    
+    float p = c->kp * error;
+    float d = -c->kp * c->td_s * ctl->slope;   // Naraščanje → manj moči že pred targetom
+    float unsat = p + ctl->integral + d;
+    
+    if (c->ti_s > 0.0f && dt > 0.0f) {
+        // Conditional integration: ne integriraj v smer, ki je že v nasičenju
+        bool saturated_high = unsat >= 1.0f && error > 0.0f;
+        bool saturated_low = unsat <= 0.0f && error < 0.0f;
+        if (!saturated_high && !saturated_low) {
+            ctl->integral += c->kp * error * dt / c->ti_s;
+            ctl->integral = clampf(ctl->integral, 0.0f, 1.0f);
+        }
+    }
+    
+    return clampf(p + ctl->integral + d, 0.0f, 1.0f);
+}
+
+/**
+ * @brief Duty → relay v ciklu dolžine cycle_s z min on/off časi
+ */
+static bool time_proportion(furnace_control_t *ctl, float duty, int64_t now_us)
+{
+    const furnace_control_config_t *c = &ctl->config;
+    int64_t cycle_us = (int64_t)c->cycle_s * 1000000;
+    
+    if (now_us - ctl->cycle_start_us >= cycle_us || now_us < ctl->cycle_start_us) {
+        ctl->cycle_start_us = now_us;
+    }
+    
+    float on_s = duty * c->cycle_s;
+    if (on_s < c->min_on_s) {
+        on_s = 0.0f;                        // Prekratek pulz - ne preklapljaj
+    } else if (c->cycle_s - on_s < c->min_off_s) {
+        on_s = (float)c->cycle_s;           // Prekratka pavza - greje cel cikel
+    }
+    
+    bool want = (now_us - ctl->cycle_start_us) < (int64_t)(on_s * 1e6f);
+    
+    if (want != ctl->output) {
+        uint32_t min_s = ctl->output ? c->min_on_s : c->min_off_s;
+        if (now_us - ctl->output_since_us < (int64_t)min_s * 1000000) {
+            return ctl->output;             // Relay še ni bil dovolj dolgo v tem stanju
+        }
+        ctl->output = want;
+        ctl->output_since_us = now_us;
+    }
+    
+    return ctl->output;
+}
+
+bool furnace_control_update(furnace_control_t *ctl, float current, float target, bool heating,
+                            int64_t now_us)
+{
+    switch (ctl->config.mode) {
+        case FURNACE_CONTROL_PID:
+            ctl->duty = pid_duty(ctl, current, target, now_us);
+            return time_proportion(ctl, ctl->duty, now_us);
+        
+        case FURNACE_CONTROL_HYSTERESIS:
+        default:
+            ctl->output = furnace_logic_should_heat(current, target, heating, &ctl->config.hysteresis);
+            ctl->duty = ctl->output ? 1.0f : 0.0f;
+            return ctl->output;
+    }
+}
@@ -0,0 +1,135 @@
+/**
+ * @file furnace_model.c
+ * @brief Samoučeči toplotni model prostora
+ */
+#include "furnace_model.h"
+
+#define RLS_LAMBDA          0.98f   // Pozabljanje (~50 oken ≈ 8 h spomina)
+#define RLS_COV_INIT        10.0f
+#define HEAT_WINDOW_MIN_ON  0.5f    // Okno šteje kot ogrevalno (delež časa vklopa)
+#define POWER_EMA_ALPHA     0.2f
+#define PREHEAT_MARGIN      1.1f    // +10 % rezerve
+#define MIN_NET_RATE        0.05f   // °C/h - počasneje pomeni "ne doseže"
+
+void furnace_model_init(furnace_model_t *model)
+{
+    *model = (furnace_model_t){
+        .heat_rate = 1.0f,
+        .loss_rate = 0.3f,
+        .cov = { { RLS_COV_INIT, 0.0f }, { 0.0f, RLS_COV_INIT } },
+        .power_on_kw = 1.0f,
+    };
+}
+
+static void window_start(furnace_model_t *m, float temp, int64_t now_us)
+{
+    m->window_open = true;
+    m->window_start_us = now_us;
+    m->window_start_temp = temp;
+    m->last_us = now_us;
+    m->u_integral = 0.0;
+    m->on_s = 0.0;
+}
+
+/**
+ * @brief En RLS korak za y = heat_rate * u - loss_rate
+ */
+static void rls_update(furnace_model_t *m, float u, float slope)
+{
+    const float x[2] = { u, -1.0f };
+    float px[2] = {
+        m->cov[0][0] * x[0] + m->cov[0][1] * x[1],
+        m->cov[1][0] * x[0] + m->cov[1][1] * x[1],
+    };
+    float denom = RLS_LAMBDA + x[0] * px[0] + x[1] * px[1];
+    float k[2] = { px[0] / denom, px[1] / denom };
+    float err = slope - (m->heat_rate * x[0] + m->loss_rate * x[1]);
+    
+    m->heat_rate += k[0] * err;
+    m->loss_rate += k[1] * err;
+    
+    for (int i = 0; i < 2; i++) {
+        for (int j = 0; j < 2; j++) {
+            m->cov[i][j] = (m->cov[i][j] - k[i] * px[j]) / RLS_LAMBDA;
+        }
+    }
+    
+    // Fizikalne meje - peč vedno greje, prostor se vedno hladi
+    if (m->heat_rate < 0.01f) m->heat_rate = 0.01f;
+    if (m->loss_rate < 0.0f) m->loss_rate = 0.0f;
+}
+
+bool furnace_model_update(furnace_model_t *model, float temp, bool heating, float power_w,
+                          int64_t now_us)
+{
+    float u = 0.0f;
+    if (heating) {
+        u = (power_w >= FURNACE_MODEL_MIN_POWER_W) ? power_w / 1000.0f : 1.0f;
+    }
+    
+    if (!model->window_open || now_us < model->last_us ||
+        now_us - model->last_us > (int64_t)FURNACE_MODEL_WINDOW_S * 1000000 / 4) {
+        // Prvi vzorec ali luknja v podatkih - začni novo okno
+        window_start(model, temp, now_us);
+        model->last_u = u;
+        return false;
+    }
+    
+    double dt_s = (now_us - model->last_us) / 1e6;
+    model->u_integral += model->last_u * dt_s;
+    if (model->last_u > 0.0f) {
+        model->on_s += dt_s;
+    }
+    model->last_us = now_us;
+    model->last_u = u;
+    
+    int64_t elapsed_us = now_us - model->window_start_us;
+    if (elapsed_us < (int64_t)FURNACE_MODEL_WINDOW_S * 1000000) {
+        return false;
+    }
+    
+    float hours = elapsed_us / 3.6e9f;
+    double window_s = elapsed_us / 1e6;
+    float u_avg = (float)(model->u_integral / window_s);
+    float slope = (temp - model->window_start_temp) / hours;
+    
+    rls_update(model, u_avg, slope);
+    
+    if (model->on_s > 0.0) {
+        float on_kw = (float)(model->u_integral / model->on_s);
+        model->power_on_kw += POWER_EMA_ALPHA * (on_kw - model->power_on_kw);
+    }
+    if (model->on_s >= HEAT_WINDOW_MIN_ON * window_s) {
+        model->heat_windows++;
+    } else if (model->on_s == 0.0) {
+        model->cool_windows++;
+    }
+    
+    window_start(model, temp, now_us);
+    return true;
+}
+
+bool furnace_model_ready(const furnace_model_t *model)
+{
+    return model->heat_windows >= FURNACE_MODEL_MIN_WINDOWS &&
+           model->cool_windows >= FURNACE_MODEL_MIN_WINDOWS;
+}
+
+uint32_t furnace_model_preheat_s(const furnace_model_t *model, float current, float target)
+{
+    float delta = target - current;
+    if (delta <= 0.0f) {
+        return 0;
+    }
+    
+    float net_rate = model->heat_rate * model->power_on_kw - model->loss_rate;
+    if (net_rate < MIN_NET_RATE) {
+        return FURNACE_MODEL_MAX_LEAD_S;
+    }
+    
+    float seconds = delta / net_rate * 3600.0f * PREHEAT_MARGIN;
+    if (seconds >= FURNACE_MODEL_MAX_LEAD_S) {
+        return FURNACE_MODEL_MAX_LEAD_S;
+    }
+    return (uint32_t)seconds;
+}
@@ -6,7 +6,10 @@
 #define FURNACE_CONTROLLER_H
 
 #include "esp_err.h"
+#include "furnace_logic.h"
+#include "furnace_model.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @brief Furnace status
@@ -18,8 +21,37 @@ typedef enum {
     FURNACE_ERROR      // Napaka (Shelly offline, sensor fail...)
 } furnace_state_t;
 
+/**
+ * @brief Statistika relay ukazov (write suppression)
+ */
+typedef struct {
+    uint32_t issued;        // Poslani relay ukazi (sprememba, napaka, refresh)
+    uint32_t suppressed;    // Preskočeni odvečni relay ukazi
+    uint32_t status_polls;  // Samostojna branja statusa (power monitoring)
+    uint32_t resyncs;       // Relay preklopljen mimo kontrolerja
+} furnace_cmd_stats_t;
+
+/**
+ * @brief Konsistenten posnetek stanja kontrolerja
+ *
+ * Vsa polja pripadajo istemu trenutku; version se poveča ob vsakem zapisu,
+ * zato bralec z enakim version ve, da se ni nič spremenilo.
+ */
+typedef struct {
+    uint32_t version;
+    furnace_state_t state;
+    float target_temp;      // °C
+    float current_temp;     // °C, NAN dokler ni prve meritve
+    float power_w;          // Zadnja poročana poraba
+    int64_t updated_us;     // esp_timer čas zadnjega zapisa
+} furnace_snapshot_t;
+
 /**
  * @brief Furnace controller callback
+ *
+ * Kliče se izven zaklepanja (Shelly I/O ali WebSocket task), z zadnjim
+ * znanim stanjem - callback lahko kliče nazaj v kontroler.
+ *
  * @param state Nov state peči
  * @param power_w Trenutna poraba (W) - 0 če ni podatka
  */
@@ -47,17 +79,33 @@ float furnace_controller_get_target(void);
 
 /**
  * @brief Posodobi trenutno temperaturo (kliče sensor task)
+ *
+ * Ne blokira: relay ukaz se pošlje v Shelly I/O vrsto, rezultat pa
+ * pride nazaj prek furnace_state_callback_t.
+ *
  * @param current_temp Trenutna temperatura v °C
- * @return ESP_OK če uspešno
+ * @return ESP_OK če je ukaz sprejet v vrsto
  */
 esp_err_t furnace_controller_update_temperature(float current_temp);
 
+/**
+ * @brief Takoj ponovno oceni zanko z zadnjo temperaturo (npr. po spremembi targeta)
+ * @return ESP_OK, ESP_ERR_INVALID_STATE če še ni nobene meritve
+ */
+esp_err_t furnace_controller_reevaluate(void);
+
 /**
  * @brief Dobi trenutni state peči
  * @return Furnace state
  */
 furnace_state_t furnace_controller_get_state(void);
 
+/**
+ * @brief Dobi konsistenten posnetek stanja (ne blokira kontrolne zanke)
+ * @param snapshot Output struktura
+ */
+void furnace_controller_get_snapshot(furnace_snapshot_t *snapshot);
+
 /**
  * @brief Registriraj callback za state spremembe
  * @param callback Callback funkcija
@@ -71,4 +119,56 @@ void furnace_controller_register_callback(furnace_state_callback_t callback);
  */
 esp_err_t furnace_controller_manual_override(bool on);
 
+/**
+ * @brief Nastavi intervale za relay resync in branje statusa
+ *
+ * Relay ukaz se pošlje le ob spremembi, po napaki ali ko poteče
+ * relay_refresh_ms. Vmes se status (power) bere vsakih status_interval_ms.
+ *
+ * @param relay_refresh_ms Periodični resync releja v ms
+ * @param status_interval_ms Interval branja statusa v ms
+ */
+void furnace_controller_set_intervals(uint32_t relay_refresh_ms, uint32_t status_interval_ms);
+
+/**
+ * @brief Izberi kontrolno strategijo (histereza ali PID + time-proportioning)
+ *
+ * Ponastavi stanje strategije (I člen, cikel). Brez klica velja
+ * FURNACE_CONTROL_DEFAULT_CONFIG (histereza).
+ *
+ * @param config Nastavitve (NULL = privzete)
+ */
+void furnace_controller_set_control(const furnace_control_config_t *config);
+
+/**
+ * @brief Napovej prihodnji target (optimal start)
+ *
+ * Ko se toplotni model nauči hitrosti ogrevanja, kontroler začne greti na
+ * target_temp ravno toliko prej, da ga doseže ob roku. Sam target ob roku
+ * nastavi klicatelj (furnace_controller_set_target).
+ *
+ * @param target_temp Prihodnji target v °C
+ * @param in_s Čez koliko sekund velja (0 = prekliči)
+ */
+void furnace_controller_set_upcoming_target(float target_temp, uint32_t in_s);
+
+/**
+ * @brief Dobi kopijo toplotnega modela (diagnostika)
+ * @param model Output struktura
+ * @return True če je model že uporaben za napoved
+ */
+bool furnace_controller_get_model(furnace_model_t *model);
+
+/**
+ * @brief Dobi zadnji izračunan duty (0..1; pri histerezi 0 ali 1)
+ * @return Duty
+ */
+float furnace_controller_get_duty(void);
+
+/**
+ * @brief Dobi statistiko relay ukazov (poslani vs. preskočeni)
+ * @param stats Output struktura
+ */
+void furnace_controller_get_cmd_stats(furnace_cmd_stats_t *stats);
+
 #endif // FURNACE_CONTROLLER_H
\ No newline at end of file
@@ -0,0 +1,145 @@
+/**
+ * @file furnace_logic.h
+ * @brief Čista kontrolna logika termostata (brez ESP-IDF odvisnosti)
+ *
+ * Odločitve kontrolne zanke (histereza, kdaj poslati relay ukaz, kdaj
+ * brati status) so ločene od FreeRTOS/HTTP kode, zato jih je mogoče
+ * prevesti in poganjati tudi na hostu (npr. replay posnetih temperatur).
+ * Čas se vedno poda kot argument - modul nima lastne ure.
+ */
+#ifndef FURNACE_LOGIC_H
+#define FURNACE_LOGIC_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Histereza okoli target temperature
+ */
+typedef struct {
+    float below;            // °C pod target → vklopi
+    float above;            // °C nad target → izklopi
+} furnace_hysteresis_t;
+
+/**
+ * @brief Strategija kontrolne zanke
+ */
+typedef enum {
+    FURNACE_CONTROL_HYSTERESIS,     // Bang-bang s histerezo (privzeto)
+    FURNACE_CONTROL_PID,            // PID → duty → time-proportioning cikli releja
+} furnace_control_mode_t;
+
+/**
+ * @brief Nastavitve kontrolne strategije
+ */
+typedef struct {
+    furnace_control_mode_t mode;
+    furnace_hysteresis_t hysteresis;    // FURNACE_CONTROL_HYSTERESIS
+    float kp;               // Duty (0..1) na °C napake
+    float ti_s;             // Integralni čas (s), 0 = brez I člena
+    float td_s;             // Derivativni čas (s), na meritvi - napove overshoot
+    uint32_t cycle_s;       // Perioda time-proportioning cikla
+    uint32_t min_on_s;      // Najkrajši vklop releja
+    uint32_t min_off_s;     // Najkrajši izklop releja
+} furnace_control_config_t;
+
+/**
+ * @brief Privzeto: histereza 0.5 °C pod / 0.3 °C nad target; PID nastavljen
+ *        za radiatorje (15 min cikel, vsaj 3 min vklop/izklop)
+ */
+#define FURNACE_CONTROL_DEFAULT_CONFIG() {          \
+    .mode = FURNACE_CONTROL_HYSTERESIS,             \
+    .hysteresis = { .below = 0.5f, .above = 0.3f }, \
+    .kp = 0.5f,                                     \
+    .ti_s = 3600.0f,                                \
+    .td_s = 600.0f,                                 \
+    .cycle_s = 900,                                 \
+    .min_on_s = 180,                                \
+    .min_off_s = 180,                               \
+}
+
+/**
+ * @brief Stanje kontrolne strategije (brez heap alokacije)
+ */
+typedef struct {
+    furnace_control_config_t config;
+    bool primed;                // PID ima prvo meritev
+    float integral;             // I člen (duty 0..1)
+    float slope;                // Glajen naklon temperature (°C/s)
+    float last_temp;
+    int64_t last_us;
+    float duty;                 // Zadnji izračunan duty (0..1)
+    int64_t cycle_start_us;     // Začetek tekočega time-proportioning cikla
+    bool output;                // Zadnja odločitev (želeno stanje releja)
+    int64_t output_since_us;    // Od kdaj velja output (min on/off)
+} furnace_control_t;
+
+/**
+ * @brief Sledenje potrjenemu stanju releja (write suppression)
+ */
+typedef struct {
+    bool known;                 // Stanje releja je potrjeno s strani Shelly
+    bool on;                    // Zadnje potrjeno stanje releja
+    int64_t last_write_us;      // Čas zadnjega potrjenega relay ukaza
+    int64_t last_status_us;     // Čas zadnjega branja statusa
+    uint32_t refresh_ms;        // Periodični resync tudi brez spremembe
+    uint32_t status_interval_ms;// Branje power/statusa brez relay ukaza
+} furnace_relay_tracker_t;
+
+/**
+ * @brief Kaj naj kontrolna zanka naredi v tem ciklu
+ */
+typedef enum {
+    FURNACE_ACTION_NONE,        // Nič - relay je pravilen, status svež
+    FURNACE_ACTION_POLL,        // Samo preberi status (power)
+    FURNACE_ACTION_WRITE,       // Pošlji relay ukaz (+ status)
+} furnace_action_t;
+
+/**
+ * @brief Bang-bang odločitev s histerezo
+ * @param current Trenutna temperatura (°C)
+ * @param target Target temperatura (°C)
+ * @param heating Ali trenutno greje (za "gray zone")
+ * @param hyst Histereza
+ * @return True če naj greje
+ */
+bool furnace_logic_should_heat(float current, float target, bool heating,
+                               const furnace_hysteresis_t *hyst);
+
+/**
+ * @brief Inicializira kontrolno strategijo
+ * @param ctl Stanje
+ * @param config Nastavitve (NULL = FURNACE_CONTROL_DEFAULT_CONFIG)
+ */
+void furnace_control_init(furnace_control_t *ctl, const furnace_control_config_t *config);
+
+/**
+ * @brief Pozabi zgodovino (I člen, naklon, cikel) - npr. po izpadu senzorja
+ * @param ctl Stanje
+ */
+void furnace_control_reset(furnace_control_t *ctl);
+
+/**
+ * @brief En korak izbrane strategije
+ * @param ctl Stanje
+ * @param current Trenutna temperatura (°C)
+ * @param target Target temperatura (°C)
+ * @param heating Ali trenutno greje (potrjeno stanje releja)
+ * @param now_us Trenutni čas (µs)
+ * @return True če naj greje
+ */
+bool furnace_control_update(furnace_control_t *ctl, float current, float target, bool heating,
+                            int64_t now_us);
+
+/**
+ * @brief Odloči, ali je relay ukaz potreben ali ga lahko preskočimo
+ * @param relay Stanje sledenja releja
+ * @param should_heat Želeno stanje
+ * @param push_active Push obvestila so aktivna (polling ni potreben)
+ * @param now_us Trenutni čas (µs)
+ * @return Akcija za ta cikel
+ */
+furnace_action_t furnace_logic_next_action(const furnace_relay_tracker_t *relay, bool should_heat,
+                                           bool push_active, int64_t now_us);
+
+#endif // FURNACE_LOGIC_H
@@ -0,0 +1,80 @@
+/**
+ * @file furnace_model.h
+ * @brief Samoučeči toplotni model prostora (brez ESP-IDF odvisnosti)
+ *
+ * Model prvega reda:  dT/dt = heat_rate * u - loss_rate   [°C/h]
+ * kjer je u povprečna moč peči v oknu (kW). Parametra se sproti ocenjujeta
+ * z rekurzivnimi najmanjšimi kvadrati (RLS) s pozabljanjem - vsako okno je
+ * en korak, pomnilnik je konstanten (2x2 kovarianca).
+ *
+ * Če Shelly ne meri moči (relay le preklaplja kontakt kotla), se vklopljen
+ * relay šteje kot 1 kW - heat_rate je takrat °C/h pri vklopljeni peči.
+ */
+#ifndef FURNACE_MODEL_H
+#define FURNACE_MODEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define FURNACE_MODEL_WINDOW_S      600     // Dolžina okna za oceno naklona
+#define FURNACE_MODEL_MIN_POWER_W   5.0f    // Pod tem Shelly moči ne meri
+#define FURNACE_MODEL_MIN_WINDOWS   3       // Ogrevalna + hladilna okna pred uporabo
+#define FURNACE_MODEL_MAX_LEAD_S    (4 * 3600)  // Najzgodnejši pred-vklop
+
+/**
+ * @brief Stanje modela
+ */
+typedef struct {
+    // Ocenjeni parametri
+    float heat_rate;            // °C/h na kW
+    float loss_rate;            // °C/h pri izklopljeni peči
+    float cov[2][2];            // RLS kovarianca
+    float power_on_kw;          // Povprečna moč ob vklopu (EMA)
+    uint32_t heat_windows;      // Okna s pretežno vklopljeno pečjo
+    uint32_t cool_windows;      // Okna z izklopljeno pečjo
+    // Tekoče okno
+    bool window_open;
+    int64_t window_start_us;
+    float window_start_temp;
+    int64_t last_us;
+    float last_u;               // Moč (kW) od zadnjega vzorca
+    double u_integral;          // kW·s v oknu
+    double on_s;                // Čas vklopa v oknu (s)
+} furnace_model_t;
+
+/**
+ * @brief Inicializira model s konzervativnimi začetnimi parametri
+ * @param model Stanje
+ */
+void furnace_model_init(furnace_model_t *model);
+
+/**
+ * @brief Dodaj vzorec (kliči ob vsaki meritvi)
+ * @param model Stanje
+ * @param temp Temperatura (°C)
+ * @param heating Ali peč greje
+ * @param power_w Izmerjena moč (W), 0 če ni podatka
+ * @param now_us Trenutni čas (µs)
+ * @return True če je bilo okno zaključeno in model posodobljen
+ */
+bool furnace_model_update(furnace_model_t *model, float temp, bool heating, float power_w,
+                          int64_t now_us);
+
+/**
+ * @brief Ali ima model dovolj podatkov za napoved
+ * @param model Stanje
+ * @return True po FURNACE_MODEL_MIN_WINDOWS ogrevalnih in hladilnih oknih
+ */
+bool furnace_model_ready(const furnace_model_t *model);
+
+/**
+ * @brief Koliko prej je treba vklopiti, da bo ob roku dosežen target
+ * @param model Stanje
+ * @param current Trenutna temperatura (°C)
+ * @param target Prihodnji target (°C)
+ * @return Sekunde (0 če je target že dosežen, FURNACE_MODEL_MAX_LEAD_S če
+ *         ga peč po modelu ne doseže)
+ */
+uint32_t furnace_model_preheat_s(const furnace_model_t *model, float current, float target);
+
+#endif // FURNACE_MODEL_H
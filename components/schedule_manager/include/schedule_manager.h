@@ -0,0 +1,89 @@
+/**
+ * @file schedule_manager.h
+ * @brief Schedule Manager - tedenski urnik, počitnice in override s SNTP uro
+ *
+ * Ob vsaki spremembi urnika se kliče callback, naslednja sprememba pa se
+ * nastavi kot one-shot esp_timer - med prehodi manager ne dela ničesar.
+ */
+#ifndef SCHEDULE_MANAGER_H
+#define SCHEDULE_MANAGER_H
+
+#include "esp_err.h"
+#include "schedule_table.h"
+#include <stdbool.h>
+
+/**
+ * @brief Callback ob spremembi urnika (esp_timer ali SNTP task)
+ * @param status Trenutni target in naslednja sprememba
+ * @param changed True če se je target spremenil (sicer le nova napoved)
+ */
+typedef void (*schedule_callback_t)(const schedule_status_t *status, bool changed);
+
+/**
+ * @brief Inicializira manager in prevede urnik
+ * @param periods Tedenska pravila
+ * @param count Število pravil
+ * @param timezone POSIX TZ niz (npr. "CET-1CEST,M3.5.0,M10.5.0/3")
+ * @return ESP_OK, ESP_ERR_INVALID_ARG ob neveljavnem pravilu
+ */
+esp_err_t schedule_manager_init(const schedule_period_t *periods, size_t count, const char *timezone);
+
+/**
+ * @brief Zažene SNTP (po esp_netif_init, npr. takoj po wifi_manager_init)
+ *
+ * Do prve sinhronizacije urnik ne velja - ostane začetni target.
+ *
+ * @param server NTP strežnik
+ * @return ESP_OK če uspešno
+ */
+esp_err_t schedule_manager_start_sntp(const char *server);
+
+/**
+ * @brief Ali je ura sinhronizirana
+ * @return True po prvi SNTP sinhronizaciji
+ */
+bool schedule_manager_time_valid(void);
+
+/**
+ * @brief Registriraj callback za spremembe urnika
+ * @param callback Funkcija ali NULL
+ */
+void schedule_manager_register_callback(schedule_callback_t callback);
+
+/**
+ * @brief Ponovno prevede tedenski urnik
+ * @param periods Tedenska pravila
+ * @param count Število pravil
+ * @return ESP_OK, ESP_ERR_INVALID_ARG ob neveljavnem pravilu
+ */
+esp_err_t schedule_manager_set_periods(const schedule_period_t *periods, size_t count);
+
+/**
+ * @brief Dodaj počitnice / odsotnost
+ * @param start Začetek (epoch)
+ * @param end Konec (epoch)
+ * @param target Target v °C
+ * @return ESP_OK, ESP_ERR_INVALID_ARG če se prekriva ali je tabela polna
+ */
+esp_err_t schedule_manager_add_holiday(time_t start, time_t end, float target);
+
+/**
+ * @brief Ročni override (npr. +/- gumba)
+ * @param target Target v °C
+ * @param until Konec (0 = do naslednje spremembe urnika)
+ */
+void schedule_manager_set_override(float target, time_t until);
+
+/**
+ * @brief Prekliči ročni override
+ */
+void schedule_manager_clear_override(void);
+
+/**
+ * @brief Trenutno stanje urnika
+ * @param status Output struktura
+ * @return False če ura ni sinhronizirana ali je urnik prazen
+ */
+bool schedule_manager_get_status(schedule_status_t *status);
+
+#endif // SCHEDULE_MANAGER_H
@@ -0,0 +1,142 @@
+/**
+ * @file schedule_table.h
+ * @brief Prevedena tedenska tabela prehodov (brez ESP-IDF odvisnosti)
+ *
+ * Pravila (dnevi + ura začetka + target) se prevedejo v urejeno tabelo
+ * prehodov po minuti v tednu. Trenutni target in naslednja sprememba se
+ * poiščeta z bisekcijo - O(log n), brez preverjanja ob vsakem tiku.
+ * Nad tedenskim urnikom sta še dve plasti: počitnice (absolutni časovni
+ * intervali) in ročni override, ki ima prednost pred vsem.
+ */
+#ifndef SCHEDULE_TABLE_H
+#define SCHEDULE_TABLE_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <time.h>
+
+#define SCHEDULE_MAX_PERIODS        32
+#define SCHEDULE_MAX_TRANSITIONS    (SCHEDULE_MAX_PERIODS * 7)
+#define SCHEDULE_MAX_HOLIDAYS       8
+#define SCHEDULE_MINUTES_PER_WEEK   (7 * 24 * 60)
+
+/** Maske dni - bit = tm_wday (0 = nedelja) */
+#define SCHEDULE_DAY(wday)          (1U << (wday))
+#define SCHEDULE_WEEKDAYS           0x3E    // Pon-pet
+#define SCHEDULE_WEEKEND            0x41    // Sob, ned
+#define SCHEDULE_EVERY_DAY          0x7F
+
+/**
+ * @brief Pravilo: od hour:minute na izbrane dni velja target
+ */
+typedef struct {
+    uint8_t days;           // SCHEDULE_DAY() maska
+    uint8_t hour;
+    uint8_t minute;
+    float target;           // °C
+} schedule_period_t;
+
+/**
+ * @brief Počitnice / odsotnost: [start, end) velja target
+ */
+typedef struct {
+    time_t start;
+    time_t end;
+    float target;
+} schedule_holiday_t;
+
+/**
+ * @brief Vir trenutnega targeta
+ */
+typedef enum {
+    SCHEDULE_SOURCE_NONE,       // Prazen urnik
+    SCHEDULE_SOURCE_WEEKLY,
+    SCHEDULE_SOURCE_HOLIDAY,
+    SCHEDULE_SOURCE_OVERRIDE,
+} schedule_source_t;
+
+/**
+ * @brief En prehod v prevedeni tabeli
+ */
+typedef struct {
+    uint16_t minute_of_week;    // wday * 1440 + hour * 60 + minute
+    float target;
+} schedule_transition_t;
+
+/**
+ * @brief Prevedena tabela (brez heap alokacije)
+ */
+typedef struct {
+    schedule_transition_t transitions[SCHEDULE_MAX_TRANSITIONS];   // Urejeno po minute_of_week
+    uint16_t count;
+    schedule_holiday_t holidays[SCHEDULE_MAX_HOLIDAYS];             // Urejeno po start, brez prekrivanja
+    uint8_t holiday_count;
+    bool override_active;
+    time_t override_until;      // 0 = do preklica
+    float override_target;
+} schedule_table_t;
+
+/**
+ * @brief Rezultat iskanja
+ */
+typedef struct {
+    schedule_source_t source;
+    float target;               // Trenutni target
+    time_t next_change;         // Naslednji možni prehod (0 = ni ga)
+    float next_target;          // Target po next_change
+} schedule_status_t;
+
+/**
+ * @brief Prevede tedenska pravila v tabelo prehodov
+ *
+ * Počitnice in override ostanejo nespremenjeni. Če več pravil pade na isto
+ * minuto, velja kasnejše v seznamu.
+ *
+ * @param table Tabela
+ * @param periods Pravila
+ * @param count Število pravil (max SCHEDULE_MAX_PERIODS)
+ * @return False ob neveljavnem pravilu (tabela ostane nespremenjena)
+ */
+bool schedule_table_compile(schedule_table_t *table, const schedule_period_t *periods, size_t count);
+
+/**
+ * @brief Doda počitnice (urejeno vstavljanje)
+ * @param table Tabela
+ * @param holiday Interval in target
+ * @return False če je interval prazen, se prekriva z obstoječim ali je tabela polna
+ */
+bool schedule_table_add_holiday(schedule_table_t *table, const schedule_holiday_t *holiday);
+
+/**
+ * @brief Odstrani pretekle počitnice
+ * @param table Tabela
+ * @param now Trenutni čas
+ */
+void schedule_table_prune_holidays(schedule_table_t *table, time_t now);
+
+/**
+ * @brief Nastavi ročni override
+ * @param table Tabela
+ * @param target Target v °C
+ * @param until Konec (0 = do naslednje spremembe urnika)
+ * @param now Trenutni čas
+ */
+void schedule_table_set_override(schedule_table_t *table, float target, time_t until, time_t now);
+
+/**
+ * @brief Prekliče ročni override
+ * @param table Tabela
+ */
+void schedule_table_clear_override(schedule_table_t *table);
+
+/**
+ * @brief Trenutni target in naslednja sprememba
+ * @param table Tabela
+ * @param now Trenutni čas (lokalni čas iz TZ)
+ * @param status Output struktura
+ * @return False če ni nobenega veljavnega targeta (prazen urnik)
+ */
+bool schedule_table_lookup(const schedule_table_t *table, time_t now, schedule_status_t *status);
+
+#endif // SCHEDULE_TABLE_H
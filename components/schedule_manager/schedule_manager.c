@@ -0,0 +1,247 @@
+/**
+ * @file schedule_manager.c
+ * @brief Schedule Manager implementacija
+ */
+#include "schedule_manager.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_netif_sntp.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/semphr.h"
+#include <stdlib.h>
+#include <sys/time.h>
+
+static const char *TAG = "schedule_mgr";
+
+#define TIME_VALID_YEAR         2024    // Pred tem letom ura ni sinhronizirana
+#define TIMER_GUARD_US          500000  // Zbudi se malo po prehodu, ne tik pred njim
+#define KICK_DELAY_US           1000    // Ponovni izračun v esp_timer tasku
+
+static schedule_table_t s_table = {0};          // Pod s_lock
+static SemaphoreHandle_t s_lock = NULL;
+static esp_timer_handle_t s_timer = NULL;
+static schedule_callback_t s_callback = NULL;
+static bool s_applied_valid = false;
+static float s_applied_target = 0.0f;
+
+/**
+ * @brief Izračunaj trenutni target, obvesti callback in nastavi timer za naslednji prehod
+ */
+static void reschedule(void)
+{
+    if (!schedule_manager_time_valid()) {
+        return;
+    }
+    
+    time_t now = time(NULL);
+    schedule_status_t status;
+    bool changed = false;
+    
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    schedule_table_prune_holidays(&s_table, now);
+    bool valid = schedule_table_lookup(&s_table, now, &status);
+    if (valid) {
+        changed = !s_applied_valid || status.target != s_applied_target;
+        s_applied_target = status.target;
+        s_applied_valid = true;
+    }
+    schedule_callback_t callback = s_callback;
+    xSemaphoreGive(s_lock);
+    
+    esp_timer_stop(s_timer);
+    
+    // Tudi brez veljavnega targeta (prazen tedenski urnik) so lahko pred
+    // nami počitnice - timer mora zbuditi njihov začetek
+    if (status.next_change > now) {
+        esp_timer_start_once(s_timer, (uint64_t)(status.next_change - now) * 1000000 + TIMER_GUARD_US);
+    }
+    
+    if (!valid) {
+        ESP_LOGD(TAG, "Schedule empty");
+        return;
+    }
+    
+    if (status.next_change > now) {
+        struct tm tm_next;
+        localtime_r(&status.next_change, &tm_next);
+        ESP_LOGI(TAG, "Target %.1f°C (source %d), next %.1f°C at %02d:%02d (day %d)",
+                 status.target, status.source, status.next_target,
+                 tm_next.tm_hour, tm_next.tm_min, tm_next.tm_wday);
+    } else {
+        ESP_LOGI(TAG, "Target %.1f°C (source %d), no further changes", status.target, status.source);
+    }
+    
+    if (callback) {
+        callback(&status, changed);
+    }
+}
+
+static void schedule_timer_cb(void *arg)
+{
+    reschedule();
+}
+
+/**
+ * @brief Ponovni izračun v esp_timer tasku (ne v klicatelju / lwIP tasku)
+ */
+static void kick(void)
+{
+    esp_timer_stop(s_timer);
+    esp_timer_start_once(s_timer, KICK_DELAY_US);
+}
+
+static void sntp_sync_cb(struct timeval *tv)
+{
+    ESP_LOGI(TAG, "Time synchronized");
+    kick();
+}
+
+esp_err_t schedule_manager_init(const schedule_period_t *periods, size_t count, const char *timezone)
+{
+    if (s_lock == NULL) {
+        s_lock = xSemaphoreCreateMutex();
+        if (s_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+        
+        const esp_timer_create_args_t timer_args = {
+            .callback = schedule_timer_cb,
+            .name = "schedule",
+        };
+        esp_err_t ret = esp_timer_create(&timer_args, &s_timer);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create schedule timer");
+            return ret;
+        }
+    }
+    
+    if (timezone) {
+        setenv("TZ", timezone, 1);
+        tzset();
+    }
+    
+    esp_err_t ret = schedule_manager_set_periods(periods, count);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    
+    ESP_LOGI(TAG, "Schedule: %u rules → %u transitions, TZ %s",
+             (unsigned)count, s_table.count, timezone ? timezone : "(unchanged)");
+    return ESP_OK;
+}
+
+esp_err_t schedule_manager_start_sntp(const char *server)
+{
+    esp_sntp_config_t config = ESP_NETIF_SNTP_DEFAULT_CONFIG(server);
+    config.sync_cb = sntp_sync_cb;
+    
+    esp_err_t ret = esp_netif_sntp_init(&config);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "SNTP init failed: %s", esp_err_to_name(ret));
+        return ret;
+    }
+    
+    ESP_LOGI(TAG, "SNTP started (%s)", server);
+    return ESP_OK;
+}
+
+bool schedule_manager_time_valid(void)
+{
+    time_t now = time(NULL);
+    struct tm tm_now;
+    localtime_r(&now, &tm_now);
+    
+    return tm_now.tm_year + 1900 >= TIME_VALID_YEAR;
+}
+
+void schedule_manager_register_callback(schedule_callback_t callback)
+{
+    s_callback = callback;
+}
+
+esp_err_t schedule_manager_set_periods(const schedule_period_t *periods, size_t count)
+{
+    if (s_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool ok = schedule_table_compile(&s_table, periods, count);
+    xSemaphoreGive(s_lock);
+    
+    if (!ok) {
+        ESP_LOGE(TAG, "Invalid schedule rules");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    kick();
+    return ESP_OK;
+}
+
+esp_err_t schedule_manager_add_holiday(time_t start, time_t end, float target)
+{
+    if (s_lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    schedule_holiday_t holiday = {
+        .start = start,
+        .end = end,
+        .target = target,
+    };
+    
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool ok = schedule_table_add_holiday(&s_table, &holiday);
+    xSemaphoreGive(s_lock);
+    
+    if (!ok) {
+        ESP_LOGW(TAG, "Holiday rejected (overlap, empty or table full)");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    kick();
+    return ESP_OK;
+}
+
+void schedule_manager_set_override(float target, time_t until)
+{
+    if (s_lock == NULL || !schedule_manager_time_valid()) {
+        return;
+    }
+    
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    schedule_table_set_override(&s_table, target, until, time(NULL));
+    // Target je že nastavljen - callback dobi le novo napoved
+    s_applied_target = target;
+    s_applied_valid = true;
+    xSemaphoreGive(s_lock);
+    
+    ESP_LOGI(TAG, "Override %.1f°C", target);
+    kick();
+}
+
+void schedule_manager_clear_override(void)
+{
+    if (s_lock == NULL) {
+        return;
+    }
+    
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    schedule_table_clear_override(&s_table);
+    xSemaphoreGive(s_lock);
+    
+    kick();
+}
+
+bool schedule_manager_get_status(schedule_status_t *status)
+{
+    if (s_lock == NULL || status == NULL || !schedule_manager_time_valid()) {
+        return false;
+    }
+    
+    xSemaphoreTake(s_lock, portMAX_DELAY);
+    bool valid = schedule_table_lookup(&s_table, time(NULL), status);
+    xSemaphoreGive(s_lock);
+    
+    return valid;
+}
@@ -0,0 +1,222 @@
+/**
+ * @file schedule_table.c
+ * @brief Prevedena tedenska tabela prehodov
+ */
+#include "schedule_table.h"
+#include <string.h>
+
+/**
+ * @brief Prvi prehod z minute_of_week > mow (bisekcija)
+ */
+static uint16_t upper_bound(const schedule_table_t *t, uint16_t mow)
+{
+    uint16_t lo = 0, hi = t->count;
+    
+    while (lo < hi) {
+        uint16_t mid = lo + (hi - lo) / 2;
+        if (t->transitions[mid].minute_of_week <= mow) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+/**
+ * @brief Zadnje počitnice s start <= now, -1 če jih ni
+ */
+static int holiday_index(const schedule_table_t *t, time_t now)
+{
+    int lo = 0, hi = t->holiday_count;
+    
+    while (lo < hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (t->holidays[mid].start <= now) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo - 1;
+}
+
+bool schedule_table_compile(schedule_table_t *table, const schedule_period_t *periods, size_t count)
+{
+    if (count > SCHEDULE_MAX_PERIODS || (count > 0 && periods == NULL)) {
+        return false;
+    }
+    for (size_t i = 0; i < count; i++) {
+        if (periods[i].hour > 23 || periods[i].minute > 59 || (periods[i].days & ~SCHEDULE_EVERY_DAY)) {
+            return false;
+        }
+    }
+    
+    table->count = 0;
+    
+    for (size_t i = 0; i < count; i++) {
+        for (uint8_t wday = 0; wday < 7; wday++) {
+            if (!(periods[i].days & SCHEDULE_DAY(wday))) {
+                continue;
+            }
+            
+            uint16_t mow = wday * 1440 + periods[i].hour * 60 + periods[i].minute;
+            uint16_t pos = upper_bound(table, mow);
+            
+            if (pos > 0 && table->transitions[pos - 1].minute_of_week == mow) {
+                // Ista minuta - kasnejše pravilo zmaga
+                table->transitions[pos - 1].target = periods[i].target;
+                continue;
+            }
+            
+            memmove(&table->transitions[pos + 1], &table->transitions[pos],
+                    (table->count - pos) * sizeof(table->transitions[0]));
+            table->transitions[pos] = (schedule_transition_t){
+                .minute_of_week = mow,
+                .target = periods[i].target,
+            };
+            table->count++;
+        }
+    }
+    
+    return true;
+}
+
+bool schedule_table_add_holiday(schedule_table_t *table, const schedule_holiday_t *holiday)
+{
+    if (holiday->end <= holiday->start || table->holiday_count >= SCHEDULE_MAX_HOLIDAYS) {
+        return false;
+    }
+    
+    int prev = holiday_index(table, holiday->start);
+    int next = prev + 1;
+    
+    if ((prev >= 0 && table->holidays[prev].end > holiday->start) ||
+        (next < table->holiday_count && table->holidays[next].start < holiday->end)) {
+        return false;
+    }
+    
+    memmove(&table->holidays[next + 1], &table->holidays[next],
+            (table->holiday_count - next) * sizeof(table->holidays[0]));
+    table->holidays[next] = *holiday;
+    table->holiday_count++;
+    return true;
+}
+
+void schedule_table_prune_holidays(schedule_table_t *table, time_t now)
+{
+    uint8_t expired = 0;
+    
+    while (expired < table->holiday_count && table->holidays[expired].end <= now) {
+        expired++;
+    }
+    if (expired > 0) {
+        memmove(&table->holidays[0], &table->holidays[expired],
+                (table->holiday_count - expired) * sizeof(table->holidays[0]));
+        table->holiday_count -= expired;
+    }
+}
+
+/**
+ * @brief Tedenski target ob času now in čas naslednjega prehoda
+ */
+static bool weekly_at(const schedule_table_t *t, time_t now, float *target, time_t *next_change)
+{
+    if (t->count == 0) {
+        return false;
+    }
+    
+    struct tm tm;
+    localtime_r(&now, &tm);
+    uint16_t mow = tm.tm_wday * 1440 + tm.tm_hour * 60 + tm.tm_min;
+    
+    uint16_t i = upper_bound(t, mow);
+    uint16_t cur = (i == 0) ? t->count - 1 : i - 1;     // Pred prvim → zadnji iz prejšnjega tedna
+    uint16_t next = (i == t->count) ? 0 : i;
+    
+    int delta = (t->transitions[next].minute_of_week - mow + SCHEDULE_MINUTES_PER_WEEK) % SCHEDULE_MINUTES_PER_WEEK;
+    if (delta == 0) {
+        delta = SCHEDULE_MINUTES_PER_WEEK;
+    }
+    
+    // mktime normalizira polja in upošteva prehod na poletni čas
+    tm.tm_min += delta;
+    tm.tm_sec = 0;
+    tm.tm_isdst = -1;
+    
+    *target = t->transitions[cur].target;
+    *next_change = mktime(&tm);
+    return true;
+}
+
+static bool resolve(const schedule_table_t *t, time_t now, bool use_override, schedule_status_t *status)
+{
+    *status = (schedule_status_t){ .source = SCHEDULE_SOURCE_NONE };
+    
+    if (use_override && t->override_active && (t->override_until == 0 || now < t->override_until)) {
+        status->source = SCHEDULE_SOURCE_OVERRIDE;
+        status->target = t->override_target;
+        status->next_change = t->override_until;
+        return true;
+    }
+    
+    int h = holiday_index(t, now);
+    if (h >= 0 && now < t->holidays[h].end) {
+        status->source = SCHEDULE_SOURCE_HOLIDAY;
+        status->target = t->holidays[h].target;
+        status->next_change = t->holidays[h].end;
+        return true;
+    }
+    
+    time_t weekly_next;
+    if (!weekly_at(t, now, &status->target, &weekly_next)) {
+        weekly_next = 0;
+    } else {
+        status->source = SCHEDULE_SOURCE_WEEKLY;
+    }
+    
+    // Naslednja sprememba je prej prehod ali začetek počitnic
+    status->next_change = weekly_next;
+    if (h + 1 < t->holiday_count) {
+        time_t holiday_start = t->holidays[h + 1].start;
+        if (weekly_next == 0 || holiday_start < weekly_next) {
+            status->next_change = holiday_start;
+        }
+    }
+    
+    return status->source != SCHEDULE_SOURCE_NONE;
+}
+
+void schedule_table_set_override(schedule_table_t *table, float target, time_t until, time_t now)
+{
+    if (until == 0) {
+        schedule_status_t status;
+        resolve(table, now, false, &status);
+        until = status.next_change;     // Prazen urnik → do preklica
+    }
+    
+    table->override_active = true;
+    table->override_target = target;
+    table->override_until = until;
+}
+
+void schedule_table_clear_override(schedule_table_t *table)
+{
+    table->override_active = false;
+}
+
+bool schedule_table_lookup(const schedule_table_t *table, time_t now, schedule_status_t *status)
+{
+    bool valid = resolve(table, now, true, status);
+    
+    if (status->next_change != 0) {
+        schedule_status_t next;
+        if (resolve(table, status->next_change, true, &next)) {
+            status->next_target = next.target;
+        } else {
+            status->next_target = status->target;
+        }
+    }
+    
+    return valid;
+}
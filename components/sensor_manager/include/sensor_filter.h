@@ -0,0 +1,86 @@
+#ifndef SENSOR_FILTER_H
+#define SENSOR_FILTER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define SENSOR_FILTER_MEDIAN_MAX    7   // Max median window (odd)
+
+/**
+ * @brief Smoothing stage after the median spike rejector
+ */
+typedef enum {
+    SENSOR_SMOOTHER_NONE,       // Median only
+    SENSOR_SMOOTHER_EMA,        // Exponential moving average
+    SENSOR_SMOOTHER_KALMAN,     // 1-D Kalman filter (constant temperature model)
+} sensor_smoother_t;
+
+/**
+ * @brief Filter pipeline configuration
+ */
+typedef struct {
+    uint8_t median_len;         // Median-of-N window (1 = disabled, odd, max 7)
+    sensor_smoother_t smoother; // Second stage
+    float ema_alpha;            // EMA weight of the new sample (0..1]
+    float kalman_q;             // Kalman process noise per sample (°C²)
+    float kalman_r;             // Kalman measurement noise (°C²)
+    bool fixed_point;           // Integer arithmetic (milli-°C, Q16 gains)
+} sensor_filter_config_t;
+
+/**
+ * @brief Default pipeline: median-of-5 spike rejection + EMA (alpha 0.3)
+ */
+#define SENSOR_FILTER_DEFAULT_CONFIG() {    \
+    .median_len = 5,                        \
+    .smoother = SENSOR_SMOOTHER_EMA,        \
+    .ema_alpha = 0.3f,                      \
+    .kalman_q = 0.0005f,                    \
+    .kalman_r = 0.01f,                      \
+    .fixed_point = false,                   \
+}
+
+/**
+ * @brief Filter state (no heap allocation)
+ */
+typedef struct {
+    sensor_filter_config_t config;
+    int32_t median_buf[SENSOR_FILTER_MEDIAN_MAX];   // milli-°C
+    uint8_t median_head;
+    uint8_t median_count;
+    bool primed;                // Smoother has an initial estimate
+    // Floating point state
+    float x;                    // Estimate (°C)
+    float p;                    // Kalman estimate variance (°C²)
+    // Fixed point state
+    int32_t x_fx;               // Estimate (milli-°C)
+    int64_t p_fx;               // Kalman variance (milli-°C)²
+    int64_t q_fx;
+    int64_t r_fx;
+    int32_t alpha_q16;
+} sensor_filter_t;
+
+/**
+ * @brief Initialize filter with a configuration
+ * 
+ * @param filter Filter state
+ * @param config Configuration (NULL = SENSOR_FILTER_DEFAULT_CONFIG)
+ */
+void sensor_filter_init(sensor_filter_t *filter, const sensor_filter_config_t *config);
+
+/**
+ * @brief Reset filter history (e.g. after a long sensor outage)
+ * 
+ * @param filter Filter state
+ */
+void sensor_filter_reset(sensor_filter_t *filter);
+
+/**
+ * @brief Feed one raw sample through median + smoother
+ * 
+ * @param filter Filter state
+ * @param value Raw temperature in °C
+ * @return Filtered temperature in °C
+ */
+float sensor_filter_update(sensor_filter_t *filter, float value);
+
+#endif // SENSOR_FILTER_H
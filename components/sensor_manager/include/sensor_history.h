@@ -0,0 +1,137 @@
+#ifndef SENSOR_HISTORY_H
+#define SENSOR_HISTORY_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Sampling interval the buffers are sized for
+ * 
+ * At shorter intervals every window keeps its sample capacity and so
+ * covers a shorter time span (e.g. 1 s → the 1 h window spans 30 min).
+ */
+#define SENSOR_HISTORY_INTERVAL_MS  2000
+
+/**
+ * @brief Ring buffer capacity (1 h of samples)
+ */
+#define SENSOR_HISTORY_LEN          (3600000 / SENSOR_HISTORY_INTERVAL_MS)
+
+/**
+ * @brief Per-window sample capacity (= min/max deque length)
+ */
+#define SENSOR_WINDOW_1MIN_CAP      (60000 / SENSOR_HISTORY_INTERVAL_MS)
+#define SENSOR_WINDOW_10MIN_CAP     (600000 / SENSOR_HISTORY_INTERVAL_MS)
+#define SENSOR_WINDOW_1H_CAP        SENSOR_HISTORY_LEN
+
+/**
+ * @brief Min + max deque entries for all windows (4260 × 2 B at 2 s)
+ */
+#define SENSOR_HISTORY_DEQUE_LEN    \
+    (2 * (SENSOR_WINDOW_1MIN_CAP + SENSOR_WINDOW_10MIN_CAP + SENSOR_WINDOW_1H_CAP))
+
+/**
+ * @brief Rolling statistics windows
+ */
+typedef enum {
+    SENSOR_WINDOW_1MIN,
+    SENSOR_WINDOW_10MIN,
+    SENSOR_WINDOW_1H,
+    SENSOR_WINDOW_COUNT
+} sensor_window_t;
+
+/**
+ * @brief One stored sample (fixed-point to keep the ring compact)
+ */
+typedef struct {
+    uint32_t time_ms;       // Sample time (ms since boot)
+    int16_t temp_centi;     // Temperature in 0.01 °C
+    uint16_t hum_centi;     // Relative humidity in 0.01 %
+} sensor_sample_t;
+
+/**
+ * @brief Rolling statistics over one window
+ */
+typedef struct {
+    uint16_t count;         // Samples currently in the window
+    float mean;             // Mean temperature (°C)
+    float min;              // Min temperature (°C)
+    float max;              // Max temperature (°C)
+    float variance;         // Temperature variance (°C²)
+    float trend_per_hour;   // Least-squares slope (°C/h)
+    float humidity_mean;    // Mean relative humidity (%)
+} sensor_window_stats_t;
+
+/**
+ * @brief Incremental state of one window
+ * 
+ * Sums are kept in integer fixed point, so adding and removing samples
+ * never accumulates rounding drift. Min/max use monotonic deques of
+ * ring indices, which gives amortized O(1) updates.
+ */
+typedef struct {
+    uint16_t size;          // Window length in samples
+    uint16_t count;
+    int64_t sum;            // Σx   (0.01 °C)
+    int64_t sum_sq;         // Σx²
+    int64_t sum_jx;         // Σj·x, j = 0..count-1 (oldest = 0)
+    int64_t sum_hum;        // Σh   (0.01 %)
+    uint16_t *min_q;        // Ring indices with increasing values
+    uint16_t *max_q;        // Ring indices with decreasing values
+    uint16_t min_head, min_len;
+    uint16_t max_head, max_len;
+} sensor_window_state_t;
+
+/**
+ * @brief Sample history (ring buffer + rolling windows), no heap allocation
+ */
+typedef struct {
+    sensor_sample_t ring[SENSOR_HISTORY_LEN];
+    uint16_t head;          // Next write position
+    uint16_t count;         // Valid samples in the ring
+    sensor_window_state_t windows[SENSOR_WINDOW_COUNT];
+    uint16_t deque_pool[SENSOR_HISTORY_DEQUE_LEN];
+} sensor_history_t;
+
+/**
+ * @brief Initialize history and size the windows for the sample interval
+ * 
+ * @param history History instance
+ * @param interval_ms Nominal sampling interval in ms
+ */
+void sensor_history_init(sensor_history_t *history, uint32_t interval_ms);
+
+/**
+ * @brief Add a sample, updating all windows in O(1) amortized time
+ * 
+ * @param history History instance
+ * @param time_ms Sample time (ms since boot)
+ * @param temperature Temperature in °C
+ * @param humidity Relative humidity in %
+ */
+void sensor_history_push(sensor_history_t *history, uint32_t time_ms,
+                         float temperature, float humidity);
+
+/**
+ * @brief Read rolling statistics of a window in O(1)
+ * 
+ * @param history History instance
+ * @param window Window
+ * @param stats Output structure
+ * @return true if the window contains at least one sample
+ */
+bool sensor_history_get_stats(const sensor_history_t *history, sensor_window_t window,
+                              sensor_window_stats_t *stats);
+
+/**
+ * @brief Read a stored sample
+ * 
+ * @param history History instance
+ * @param age Sample age (0 = newest)
+ * @param sample Output sample
+ * @return true if a sample of that age exists
+ */
+bool sensor_history_get_sample(const sensor_history_t *history, uint16_t age,
+                               sensor_sample_t *sample);
+
+#endif // SENSOR_HISTORY_H
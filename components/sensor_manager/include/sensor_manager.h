@@ -3,17 +3,41 @@
 #define SENSOR_MANAGER_H
 
 #include "esp_err.h"
+#include "sensor_history.h"
+#include "sensor_filter.h"
 #include <stdbool.h>
+#include <stdint.h>
 
 /**
  * @brief AHT21 sensor data structure
  */
 typedef struct {
-    float temperature;  // Temperature in Celsius
+    float temperature;  // Temperature in Celsius (raw)
+    float temperature_filtered; // Temperature after the filter pipeline (Celsius)
     float humidity;     // Relative humidity in %
     bool valid;         // Data validity flag
 } sensor_data_t;
 
+/**
+ * @brief I2C bus / sensor health counters
+ */
+typedef struct {
+    uint32_t samples_ok;        // Successful measurement cycles
+    uint32_t crc_errors;        // CRC-8 mismatches
+    uint32_t busy_errors;       // Data read while busy bit was set
+    uint32_t timeouts;          // Conversion did not finish in time
+    uint32_t i2c_errors;        // I2C transfer errors
+    uint32_t retries;           // Fast retries within a cycle
+    uint32_t soft_resets;       // Escalations to AHT21 soft reset
+    uint32_t bus_reinits;       // Escalations to full I2C bus re-init
+    uint32_t failed_cycles;     // Cycles that failed after all recovery steps
+} sensor_health_stats_t;
+
+/**
+ * @brief Callback for new samples (called from the sampling task)
+ */
+typedef void (*sensor_data_callback_t)(const sensor_data_t *data);
+
 /**
  * @brief Initialize sensor manager and AHT21 sensor
  * 
@@ -31,13 +55,108 @@ esp_err_t sensor_manager_init(void);
 /**
  * @brief Read temperature and humidity from AHT21
  * 
- * Triggers measurement and reads data from AHT21 sensor
+ * Runs one sampler cycle in the calling task and blocks until it ends.
+ * Data is CRC-checked; failures are retried within the same call and
+ * escalated to a soft reset and then a full I2C bus re-init.
  * 
  * @param data Pointer to sensor_data_t structure to store results
  * @return ESP_OK on success, error code otherwise
  */
 esp_err_t sensor_manager_read(sensor_data_t *data);
 
+/**
+ * @brief Get I2C bus / sensor health counters
+ * 
+ * @param stats Pointer to output structure
+ */
+void sensor_manager_get_health_stats(sensor_health_stats_t *stats);
+
+/**
+ * @brief Start an AHT21 conversion without waiting for it
+ * 
+ * The result is picked up later with sensor_manager_collect().
+ * 
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t sensor_manager_trigger(void);
+
+/**
+ * @brief Collect the result of a triggered conversion
+ * 
+ * Polls the status byte busy bit instead of sleeping a fixed 80 ms.
+ * Returns ESP_ERR_INVALID_CRC if the CRC byte does not match.
+ * 
+ * @param data Pointer to sensor_data_t structure to store results
+ * @param timeout_ms Max time to wait for the conversion (0 = check once)
+ * @return ESP_OK on success, ESP_ERR_NOT_FINISHED if still converting,
+ *         error code otherwise
+ */
+esp_err_t sensor_manager_collect(sensor_data_t *data, uint32_t timeout_ms);
+
+/**
+ * @brief Start background sampling task
+ * 
+ * Each period the task runs a small sampler state machine: trigger,
+ * then non-blocking busy-bit polls (collect with timeout 0) with the
+ * task sleeping between steps, then read + CRC. Failed attempts escalate
+ * to retries, a soft reset and a bus re-init within the same cycle.
+ * The sample is published via sensor_manager_wait() and the registered
+ * callback, so consumers never block on I2C.
+ * 
+ * @param interval_ms Sampling period in ms
+ * @return ESP_OK on success, error code otherwise
+ */
+esp_err_t sensor_manager_start(uint32_t interval_ms);
+
+/**
+ * @brief Wait for the next published sample
+ * 
+ * @param data Pointer to sensor_data_t structure to store results
+ * @param timeout_ms Max wait time in ms
+ * @return ESP_OK with a valid sample, ESP_ERR_TIMEOUT if none arrived,
+ *         ESP_ERR_INVALID_RESPONSE if the sample is invalid
+ */
+esp_err_t sensor_manager_wait(sensor_data_t *data, uint32_t timeout_ms);
+
+/**
+ * @brief Configure the filter pipeline applied by the sampling task
+ * 
+ * Samples published by the sampling task carry the filtered value in
+ * temperature_filtered. Without a call the default pipeline is used
+ * (median-of-5 + EMA). Resets the filter history.
+ * 
+ * @param config Filter configuration (NULL = default)
+ */
+void sensor_manager_set_filter(const sensor_filter_config_t *config);
+
+/**
+ * @brief Get rolling statistics over a window of recent samples
+ * 
+ * Constant-time read of incrementally maintained mean/min/max/variance/trend.
+ * Safe to call from any task (not from an ISR - the history is mutex guarded).
+ * 
+ * @param window Window (1 min, 10 min, 1 h)
+ * @param stats Pointer to output structure
+ * @return true if the window contains at least one sample
+ */
+bool sensor_manager_get_window_stats(sensor_window_t window, sensor_window_stats_t *stats);
+
+/**
+ * @brief Get a timestamped sample from the history ring buffer
+ * 
+ * @param age Sample age (0 = newest)
+ * @param sample Pointer to output sample
+ * @return true if a sample of that age exists
+ */
+bool sensor_manager_get_history_sample(uint16_t age, sensor_sample_t *sample);
+
+/**
+ * @brief Register callback for new samples
+ * 
+ * @param callback Callback function (NULL to unregister)
+ */
+void sensor_manager_register_callback(sensor_data_callback_t callback);
+
 /**
  * @brief Deinitialize sensor manager
  * 
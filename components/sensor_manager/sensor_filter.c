@@ -0,0 +1,144 @@
+#include "sensor_filter.h"
+#include <string.h>
+
+static int32_t to_milli(float value)
+{
+    float m = value * 1000.0f;
+    return (int32_t)(m < 0 ? m - 0.5f : m + 0.5f);
+}
+
+/*
+Median-of-N: zadnjih N vzorcev, posamezen skok (spike) nikoli ne pride skozi
+*/
+static int32_t median_update(sensor_filter_t *f, int32_t x)
+{
+    uint8_t len = f->config.median_len;
+
+    f->median_buf[f->median_head] = x;
+    f->median_head = (uint8_t)((f->median_head + 1) % len);
+    if (f->median_count < len) {
+        f->median_count++;
+    }
+
+    // Insertion sort kopije (N <= 7)
+    int32_t sorted[SENSOR_FILTER_MEDIAN_MAX];
+    uint8_t n = f->median_count;
+    for (uint8_t i = 0; i < n; i++) {
+        int32_t v = f->median_buf[i];
+        int8_t j = (int8_t)i - 1;
+        while (j >= 0 && sorted[j] > v) {
+            sorted[j + 1] = sorted[j];
+            j--;
+        }
+        sorted[j + 1] = v;
+    }
+
+    return sorted[n / 2];
+}
+
+static float smooth_float(sensor_filter_t *f, float z)
+{
+    const sensor_filter_config_t *c = &f->config;
+
+    if (!f->primed) {
+        f->x = z;
+        f->p = c->kalman_r;
+        f->primed = true;
+        return z;
+    }
+
+    switch (c->smoother) {
+        case SENSOR_SMOOTHER_EMA:
+            f->x += c->ema_alpha * (z - f->x);
+            break;
+
+        case SENSOR_SMOOTHER_KALMAN: {
+            float p = f->p + c->kalman_q;
+            float k = p / (p + c->kalman_r);
+            f->x += k * (z - f->x);
+            f->p = (1.0f - k) * p;
+            break;
+        }
+
+        default:
+            f->x = z;
+            break;
+    }
+
+    return f->x;
+}
+
+static int32_t smooth_fixed(sensor_filter_t *f, int32_t z)
+{
+    if (!f->primed) {
+        f->x_fx = z;
+        f->p_fx = f->r_fx;
+        f->primed = true;
+        return z;
+    }
+
+    switch (f->config.smoother) {
+        case SENSOR_SMOOTHER_EMA: {
+            int64_t step = (int64_t)f->alpha_q16 * (z - f->x_fx);
+            f->x_fx += (int32_t)((step + (step >= 0 ? 32768 : -32768)) / 65536);
+            break;
+        }
+
+        case SENSOR_SMOOTHER_KALMAN: {
+            int64_t p = f->p_fx + f->q_fx;
+            int64_t k_q16 = (p * 65536) / (p + f->r_fx);
+            int64_t step = k_q16 * (z - f->x_fx);
+            f->x_fx += (int32_t)((step + (step >= 0 ? 32768 : -32768)) / 65536);
+            f->p_fx = ((65536 - k_q16) * p) / 65536;
+            break;
+        }
+
+        default:
+            f->x_fx = z;
+            break;
+    }
+
+    return f->x_fx;
+}
+
+void sensor_filter_init(sensor_filter_t *filter, const sensor_filter_config_t *config)
+{
+    sensor_filter_config_t defaults = SENSOR_FILTER_DEFAULT_CONFIG();
+
+    memset(filter, 0, sizeof(*filter));
+    filter->config = config ? *config : defaults;
+
+    sensor_filter_config_t *c = &filter->config;
+    if (c->median_len < 1) c->median_len = 1;
+    if (c->median_len > SENSOR_FILTER_MEDIAN_MAX) c->median_len = SENSOR_FILTER_MEDIAN_MAX;
+    if ((c->median_len % 2) == 0) c->median_len--;
+    if (c->ema_alpha <= 0.0f || c->ema_alpha > 1.0f) c->ema_alpha = defaults.ema_alpha;
+    if (c->kalman_r <= 0.0f) c->kalman_r = defaults.kalman_r;
+    if (c->kalman_q < 0.0f) c->kalman_q = defaults.kalman_q;
+
+    // Fiksna vejica: temperatura v milli-°C, variance v (milli-°C)², ojačanja v Q16
+    filter->alpha_q16 = (int32_t)(c->ema_alpha * 65536.0f + 0.5f);
+    filter->q_fx = (int64_t)(c->kalman_q * 1e6f + 0.5f);
+    filter->r_fx = (int64_t)(c->kalman_r * 1e6f + 0.5f);
+    if (filter->r_fx < 1) filter->r_fx = 1;
+}
+
+void sensor_filter_reset(sensor_filter_t *filter)
+{
+    sensor_filter_init(filter, &filter->config);
+}
+
+float sensor_filter_update(sensor_filter_t *filter, float value)
+{
+    int32_t z = to_milli(value);
+
+    if (filter->config.median_len > 1) {
+        z = median_update(filter, z);
+    }
+
+    if (filter->config.fixed_point) {
+        return smooth_fixed(filter, z) / 1000.0f;
+    }
+
+    return smooth_float(filter, z / 1000.0f);
+}
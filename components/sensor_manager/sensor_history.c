@@ -0,0 +1,205 @@
+#include "sensor_history.h"
+#include <string.h>
+
+static const uint32_t s_window_ms[SENSOR_WINDOW_COUNT] = {
+    [SENSOR_WINDOW_1MIN]  = 60 * 1000,
+    [SENSOR_WINDOW_10MIN] = 10 * 60 * 1000,
+    [SENSOR_WINDOW_1H]    = 60 * 60 * 1000,
+};
+
+static const uint16_t s_window_cap[SENSOR_WINDOW_COUNT] = {
+    [SENSOR_WINDOW_1MIN]  = SENSOR_WINDOW_1MIN_CAP,
+    [SENSOR_WINDOW_10MIN] = SENSOR_WINDOW_10MIN_CAP,
+    [SENSOR_WINDOW_1H]    = SENSOR_WINDOW_1H_CAP,
+};
+
+/*
+Starost vzorca na položaju pos v ringu (0 = najnovejši)
+*/
+static uint16_t ring_age(const sensor_history_t *h, uint16_t pos)
+{
+    uint16_t newest = (h->head + SENSOR_HISTORY_LEN - 1) % SENSOR_HISTORY_LEN;
+    return (uint16_t)((newest + SENSOR_HISTORY_LEN - pos) % SENSOR_HISTORY_LEN);
+}
+
+static uint16_t ring_pos(const sensor_history_t *h, uint16_t age)
+{
+    return (uint16_t)((h->head + 2 * SENSOR_HISTORY_LEN - 1 - age) % SENSOR_HISTORY_LEN);
+}
+
+static int16_t temp_at(const sensor_history_t *h, uint16_t pos)
+{
+    return h->ring[pos].temp_centi;
+}
+
+/*
+Monotona deque: odstrani z repa vse, kar ne more več biti min (ali max), dodaj nov indeks
+*/
+static void deque_push(const sensor_history_t *h, uint16_t *q, uint16_t cap,
+                       uint16_t qhead, uint16_t *qlen, uint16_t pos, bool is_min)
+{
+    int16_t x = temp_at(h, pos);
+
+    while (*qlen > 0) {
+        uint16_t tail = q[(qhead + *qlen - 1) % cap];
+        int16_t t = temp_at(h, tail);
+        if ((is_min && t >= x) || (!is_min && t <= x)) {
+            (*qlen)--;
+        } else {
+            break;
+        }
+    }
+
+    q[(qhead + *qlen) % cap] = pos;
+    (*qlen)++;
+}
+
+/*
+Odstrani z glave indekse, ki so padli iz okna
+*/
+static void deque_expire(const sensor_history_t *h, const uint16_t *q, uint16_t cap,
+                         uint16_t *qhead, uint16_t *qlen, uint16_t window)
+{
+    while (*qlen > 0 && ring_age(h, q[*qhead]) >= window) {
+        *qhead = (uint16_t)((*qhead + 1) % cap);
+        (*qlen)--;
+    }
+}
+
+void sensor_history_init(sensor_history_t *history, uint32_t interval_ms)
+{
+    memset(history, 0, sizeof(*history));
+
+    if (interval_ms == 0) {
+        interval_ms = 1;
+    }
+
+    uint16_t *pool = history->deque_pool;
+    for (int w = 0; w < SENSOR_WINDOW_COUNT; w++) {
+        sensor_window_state_t *win = &history->windows[w];
+        uint32_t size = s_window_ms[w] / interval_ms;
+
+        if (size < 1) size = 1;
+        if (size > s_window_cap[w]) size = s_window_cap[w];    // Deque mora imeti prostor za celo okno
+
+        win->size = (uint16_t)size;
+        win->min_q = pool;
+        pool += size;
+        win->max_q = pool;
+        pool += size;
+    }
+}
+
+void sensor_history_push(sensor_history_t *history, uint32_t time_ms,
+                         float temperature, float humidity)
+{
+    // Najstarejši vzorec v vsakem oknu je treba odšteti, preden ga ring prepiše
+    int16_t old_temp[SENSOR_WINDOW_COUNT];
+    uint16_t old_hum[SENSOR_WINDOW_COUNT];
+    for (int w = 0; w < SENSOR_WINDOW_COUNT; w++) {
+        sensor_window_state_t *win = &history->windows[w];
+        if (win->count == win->size) {
+            uint16_t pos = ring_pos(history, win->size - 1);
+            old_temp[w] = history->ring[pos].temp_centi;
+            old_hum[w] = history->ring[pos].hum_centi;
+        }
+
+        // Indeksi, ki bodo po dodajanju izven okna - pred pisanjem, ker ring lahko prepiše isti položaj
+        deque_expire(history, win->min_q, win->size, &win->min_head, &win->min_len, win->size - 1);
+        deque_expire(history, win->max_q, win->size, &win->max_head, &win->max_len, win->size - 1);
+    }
+
+    uint16_t pos = history->head;
+    sensor_sample_t *s = &history->ring[pos];
+    float t = temperature * 100.0f;
+    float hm = humidity * 100.0f;
+    s->time_ms = time_ms;
+    s->temp_centi = (int16_t)(t < 0 ? t - 0.5f : t + 0.5f);
+    s->hum_centi = (uint16_t)(hm < 0 ? 0 : hm + 0.5f);
+
+    history->head = (uint16_t)((history->head + 1) % SENSOR_HISTORY_LEN);
+    if (history->count < SENSOR_HISTORY_LEN) {
+        history->count++;
+    }
+
+    int64_t x = s->temp_centi;
+
+    for (int w = 0; w < SENSOR_WINDOW_COUNT; w++) {
+        sensor_window_state_t *win = &history->windows[w];
+
+        if (win->count == win->size) {
+            // Najstarejši (j = 0) izpade, ostali se premaknejo za eno mesto navzdol
+            int64_t xo = old_temp[w];
+            win->sum -= xo;
+            win->sum_sq -= xo * xo;
+            win->sum_jx -= win->sum;
+            win->sum_hum -= old_hum[w];
+            win->count--;
+        }
+
+        win->sum_jx += (int64_t)win->count * x;
+        win->sum += x;
+        win->sum_sq += x * x;
+        win->sum_hum += s->hum_centi;
+        win->count++;
+
+        deque_push(history, win->min_q, win->size, win->min_head, &win->min_len, pos, true);
+        deque_push(history, win->max_q, win->size, win->max_head, &win->max_len, pos, false);
+    }
+}
+
+bool sensor_history_get_stats(const sensor_history_t *history, sensor_window_t window,
+                              sensor_window_stats_t *stats)
+{
+    if (window >= SENSOR_WINDOW_COUNT || stats == NULL) {
+        return false;
+    }
+
+    const sensor_window_state_t *win = &history->windows[window];
+    memset(stats, 0, sizeof(*stats));
+
+    if (win->count == 0) {
+        return false;
+    }
+
+    double n = win->count;
+    double mean = (double)win->sum / n;
+
+    stats->count = win->count;
+    stats->mean = (float)(mean / 100.0);
+    stats->variance = (float)(((double)win->sum_sq / n - mean * mean) / 10000.0);
+    if (stats->variance < 0.0f) {
+        stats->variance = 0.0f;
+    }
+    stats->min = temp_at(history, win->min_q[win->min_head]) / 100.0f;
+    stats->max = temp_at(history, win->max_q[win->max_head]) / 100.0f;
+    stats->humidity_mean = (float)((double)win->sum_hum / n / 100.0);
+
+    if (win->count >= 2) {
+        // Naklon premice (least squares) po indeksu vzorca, pretvorjen v °C/h
+        double sxx = n * (n * n - 1.0) / 12.0;
+        double sxy = (double)win->sum_jx - (n - 1.0) / 2.0 * (double)win->sum;
+        double slope_per_sample = sxy / sxx / 100.0;
+
+        const sensor_sample_t *newest = &history->ring[ring_pos(history, 0)];
+        const sensor_sample_t *oldest = &history->ring[ring_pos(history, win->count - 1)];
+        double span_ms = (double)(uint32_t)(newest->time_ms - oldest->time_ms);
+        if (span_ms > 0) {
+            double interval_ms = span_ms / (n - 1.0);
+            stats->trend_per_hour = (float)(slope_per_sample * 3600000.0 / interval_ms);
+        }
+    }
+
+    return true;
+}
+
+bool sensor_history_get_sample(const sensor_history_t *history, uint16_t age,
+                               sensor_sample_t *sample)
+{
+    if (sample == NULL || age >= history->count) {
+        return false;
+    }
+
+    *sample = history->ring[ring_pos(history, age)];
+    return true;
+}
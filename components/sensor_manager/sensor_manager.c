@@ -4,6 +4,9 @@
 #include "esp_log.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+#include "esp_timer.h"
 #include <string.h>
 
 static const char *TAG = "sensor_manager";
@@ -19,13 +22,47 @@ static const char *TAG = "sensor_manager";
 #define AHT21_CMD_INIT              0xBE // data sheet AHT21
 #define AHT21_CMD_TRIGGER           0xAC // data sheet AHT21
 #define AHT21_CMD_SOFT_RESET        0xBA //data sheet AH21 , posebni ukaz I2C, ki resetira napravo, brez ponovnega vklopa in izklopa
-#define AHT21_MEASUREMENT_DELAY_MS  80      // Time to wait for measurement
+#define AHT21_MEASUREMENT_DELAY_MS  80      // Tipičen čas konverzije (data sheet)
+#define AHT21_FIRST_POLL_MS         40      // Prvo preverjanje busy bita po triggerju
+#define AHT21_POLL_INTERVAL_MS      5       // Nato polling busy bita
+#define AHT21_CONVERSION_TIMEOUT_MS 200     // Največji čas konverzije
+#define AHT21_STATUS_BUSY           0x80
+
+// Okrevanje po napakah (retry → soft reset → re-init busa)
+#define SENSOR_FAST_RETRIES         2       // Takojšnji ponovni poskusi v istem ciklu
+#define AHT21_CRC_POLY              0x31    // CRC-8: x^8 + x^5 + x^4 + 1, init 0xFF (data sheet)
+#define AHT21_CRC_INIT              0xFF
+
+// Sampling task
+#define SENSOR_TASK_STACK           3072
+#define SENSOR_TASK_PRIORITY        6
 
 // I2C Master Handle
 static i2c_master_bus_handle_t i2c_bus_handle = NULL;
 static i2c_master_dev_handle_t aht21_dev_handle = NULL;
 static bool initialized = false;
 
+// Pipelined merjenje
+static bool s_triggered = false;                // Konverzija teče
+static int64_t s_trigger_time_us = 0;           // Čas zadnjega triggerja
+static QueueHandle_t s_sample_queue = NULL;     // Zadnji vzorec (dolžina 1, overwrite)
+static TaskHandle_t s_sample_task = NULL;
+static uint32_t s_sample_interval_ms = 2000;
+static sensor_data_callback_t s_data_callback = NULL;
+
+// Zgodovina vzorcev (ring buffer + drseče statistike)
+static sensor_history_t s_history;
+static SemaphoreHandle_t s_history_lock = NULL;  // Mutex: push lahko izloči več deque vnosov
+
+// Filter (median + EMA/Kalman) pred termostatom
+static sensor_filter_t s_filter;
+static bool s_filter_ready = false;
+static portMUX_TYPE s_filter_mux = portMUX_INITIALIZER_UNLOCKED;
+
+// Zdravje vodila
+static SemaphoreHandle_t s_i2c_lock = NULL;     // En cikel merjenja naenkrat
+static sensor_health_stats_t s_health = {0};
+
 /*
 Inicializacija  I2C master bus
  */
@@ -111,10 +148,10 @@ static esp_err_t aht21_init(void) //napravimo še funkcijo za pošiljanje inicia
 }
 
 /*
-Sprožimo(trigger) merjenje (measurement) in branje data iz AHT21 tako , da mu pošljemo
-vrednosti iz data sheet  0xAC, 0x33, 0x00
+Sprožimo(trigger) merjenje tako, da senzorju pošljemo vrednosti iz data sheet 0xAC, 0x33, 0x00.
+Funkcija ne čaka na konverzijo - rezultat se pobere kasneje z aht21_collect_raw().
 */
-static esp_err_t aht21_read_raw(uint8_t *data, size_t len)
+static esp_err_t aht21_trigger(void)
 {
     // Trigger measurement: 0xAC, 0x33, 0x00  
     uint8_t trigger_cmd[3] = {AHT21_CMD_TRIGGER, 0x33, 0x00};
@@ -124,29 +161,108 @@ static esp_err_t aht21_read_raw(uint8_t *data, size_t len)
         return ret;
     }
 
-    // Počakamo , da se merjenje zaključi
-    vTaskDelay(pdMS_TO_TICKS(AHT21_MEASUREMENT_DELAY_MS));
+    s_triggered = true;
+    s_trigger_time_us = esp_timer_get_time();
+    return ESP_OK;
+}
+
+/*
+Preberemo statusni byte in preverimo busy bit (bit 7). Ko senzor ni več
+zaseden, preberemo vseh 7 bytov. Namesto fiksnih 80 ms pollamo busy bit.
+timeout_ms = 0 pomeni samo eno preverjanje (ESP_ERR_NOT_FINISHED če še meri).
+*/
+static esp_err_t aht21_collect_raw(uint8_t *data, size_t len, uint32_t timeout_ms)
+{
+    if (!s_triggered) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    int64_t deadline_us = esp_timer_get_time() + (int64_t)timeout_ms * 1000;
+
+    // Prvo preverjanje nima smisla pred minimalnim časom konverzije
+    int64_t first_poll_us = s_trigger_time_us + AHT21_FIRST_POLL_MS * 1000;
+    int64_t now = esp_timer_get_time();
+    if (now < first_poll_us) {
+        if (timeout_ms == 0) {
+            return ESP_ERR_NOT_FINISHED;
+        }
+        vTaskDelay(pdMS_TO_TICKS((first_poll_us - now) / 1000 + 1));
+    }
+
+    while (1) {
+        uint8_t status = 0;
+        esp_err_t ret = i2c_master_receive(aht21_dev_handle, &status, 1, I2C_MASTER_TIMEOUT_MS);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Napaka pri branju statusa: %s", esp_err_to_name(ret));
+            s_triggered = false;
+            return ret;
+        }
+
+        if (!(status & AHT21_STATUS_BUSY)) {
+            break;
+        }
+
+        now = esp_timer_get_time();
+        if (now - s_trigger_time_us > AHT21_CONVERSION_TIMEOUT_MS * 1000) {
+            ESP_LOGW(TAG, "Konverzija ni koncana v %d ms", AHT21_CONVERSION_TIMEOUT_MS);
+            s_triggered = false;
+            return ESP_ERR_TIMEOUT;
+        }
+        if (now >= deadline_us) {
+            return ESP_ERR_NOT_FINISHED;
+        }
+
+        vTaskDelay(pdMS_TO_TICKS(AHT21_POLL_INTERVAL_MS));
+    }
 
     // Read 7 bytes of data
-    ret = i2c_master_receive(aht21_dev_handle, data, len, I2C_MASTER_TIMEOUT_MS);
+    s_triggered = false;
+    esp_err_t ret = i2c_master_receive(aht21_dev_handle, data, len, I2C_MASTER_TIMEOUT_MS);
     if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Napaka pri branju measurement data: %s", esp_err_to_name(ret));
         return ret;
     }
 
+    ESP_LOGV(TAG, "Konverzija koncana v %lld ms",
+             (long long)((esp_timer_get_time() - s_trigger_time_us) / 1000));
     return ESP_OK;
 }
 
+/*
+CRC-8 nad statusom in 5 podatkovnimi byti (raw_data[0..5]), primerja se z raw_data[6]
+*/
+static uint8_t aht21_crc8(const uint8_t *data, size_t len)
+{
+    uint8_t crc = AHT21_CRC_INIT;
+
+    for (size_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (int bit = 0; bit < 8; bit++) {
+            crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ AHT21_CRC_POLY) : (uint8_t)(crc << 1);
+        }
+    }
+
+    return crc;
+}
+
 /*
 Konvertiranje raw(surovih) data v temperaturo in vlago
 */
-static void aht21_convert_data(uint8_t *raw_data, sensor_data_t *data)
+static esp_err_t aht21_convert_data(uint8_t *raw_data, sensor_data_t *data)
 {
     // Preveri ali je senzor zaseden (bit 7 od statusnega byte)
     if (raw_data[0] & 0x80) {
         ESP_LOGW(TAG, "Senzor je  zaseden, meritve so nezanesljive ");
         data->valid = false;
-        return;
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    // Preveri CRC - motnje na I2C lahko pokvarijo posamezne byte
+    uint8_t crc = aht21_crc8(raw_data, 6);
+    if (crc != raw_data[6]) {
+        ESP_LOGW(TAG, "CRC napaka: 0x%02X != 0x%02X", crc, raw_data[6]);
+        data->valid = false;
+        return ESP_ERR_INVALID_CRC;
     }
 
     // Extract vlage (20 bits: bits 12-31 od data)
@@ -162,10 +278,40 @@ static void aht21_convert_data(uint8_t *raw_data, sensor_data_t *data)
     // Konvertiraj aktualne vrednosti
     data->humidity = ((float)humidity_raw / 1048576.0f) * 100.0f;
     data->temperature = ((float)temperature_raw / 1048576.0f) * 200.0f - 51.30f;//tovarniško je 200.0f-50.0f 
+    data->temperature_filtered = data->temperature;
     data->valid = true;
 
     ESP_LOGD(TAG, "Temperatura: %.2f°C, Vlaga: %.2f%%", 
              data->temperature, data->humidity);
+    return ESP_OK;
+}
+
+/*
+Popolna ponovna inicializacija: odstrani napravo, pobriši bus in vse ustvari znova
+*/
+static esp_err_t aht21_bus_reinit(void)
+{
+    if (aht21_dev_handle != NULL) {
+        i2c_master_bus_rm_device(aht21_dev_handle);
+        aht21_dev_handle = NULL;
+    }
+    if (i2c_bus_handle != NULL) {
+        i2c_del_master_bus(i2c_bus_handle);
+        i2c_bus_handle = NULL;
+    }
+    s_triggered = false;
+
+    esp_err_t ret = init_i2c_bus();
+    if (ret == ESP_OK) {
+        ret = add_aht21_device();
+    }
+    if (ret == ESP_OK) {
+        ret = aht21_soft_reset();
+    }
+    if (ret == ESP_OK) {
+        ret = aht21_init();
+    }
+    return ret;
 }
 
 // -----------------------------------------Objavi API Implementacijo--------------------------------------------------------
@@ -181,6 +327,13 @@ esp_err_t sensor_manager_init(void)
 
     ESP_LOGI(TAG, "Inicializiram sensor manager za AHT21...");
 
+    if (s_i2c_lock == NULL) {
+        s_i2c_lock = xSemaphoreCreateMutex();
+        if (s_i2c_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
     // Inicializacija I2C bus
     esp_err_t ret = init_i2c_bus();
     if (ret != ESP_OK) {
@@ -220,7 +373,17 @@ esp_err_t sensor_manager_init(void)
     return ESP_OK;
 }
 // BRANJE IN MERJENJE 
-esp_err_t sensor_manager_read(sensor_data_t *data)
+esp_err_t sensor_manager_trigger(void)
+{
+    if (!initialized) {
+        ESP_LOGE(TAG, "Sensor manager ni inicializiran");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    return aht21_trigger();
+}
+
+esp_err_t sensor_manager_collect(sensor_data_t *data, uint32_t timeout_ms)
 {
     if (!initialized) {
         ESP_LOGE(TAG, "Sensor manager ni inicializiran");
@@ -238,22 +401,337 @@ esp_err_t sensor_manager_read(sensor_data_t *data)
 
     // Read raw data (7 bytes)
     uint8_t raw_data[7];
-    esp_err_t ret = aht21_read_raw(raw_data, sizeof(raw_data));
+    esp_err_t ret = aht21_collect_raw(raw_data, sizeof(raw_data), timeout_ms);
     if (ret != ESP_OK) {
         return ret;
     }
 
-    // Konvertiraj raw data v temperaturo in vlago
-    aht21_convert_data(raw_data, data);
-
-    if (!data->valid) {
+    // Konvertiraj raw data v temperaturo in vlago (preveri busy bit in CRC)
+    ret = aht21_convert_data(raw_data, data);
+    if (ret != ESP_OK) {
         ESP_LOGW(TAG, "Sensor data not valid");
-        return ESP_ERR_INVALID_RESPONSE;
+        return ret;
+    }
+
+    return ESP_OK;
+}
+
+/*
+Sampler: meritev z okrevanjem kot stroj stanj. Vsak korak naredi eno kratko
+I2C operacijo in vrne, koliko ticks naj klicatelj spi do naslednjega -
+med konverzijo se busy bit polla brez blokiranja (collect s timeout 0).
+Eskalacija ob napakah: hitri ponovni poskusi → soft reset → re-init busa.
+*/
+typedef enum {
+    SAMPLER_TRIGGER,        // Pošlji trigger (tudi ob ponovnem poskusu)
+    SAMPLER_CONVERTING,     // Konverzija teče, preverjaj busy bit
+    SAMPLER_DONE,           // Vzorec ali končna napaka je v result
+} sampler_state_t;
+
+typedef enum {
+    SAMPLER_STAGE_RETRY,    // Hitri ponovni poskusi
+    SAMPLER_STAGE_RESET,    // Po soft resetu senzorja
+    SAMPLER_STAGE_REINIT,   // Po ponovni inicializaciji I2C busa
+} sampler_stage_t;
+
+typedef struct {
+    sampler_state_t state;
+    sampler_stage_t stage;
+    uint8_t retries;        // Porabljeni hitri poskusi
+    esp_err_t result;
+} sampler_t;
+
+static TickType_t ms_to_ticks_min1(uint32_t ms)
+{
+    TickType_t ticks = pdMS_TO_TICKS(ms);
+    return ticks > 0 ? ticks : 1;   // Pri 100 Hz tiku bi 5 ms postalo 0 (busy loop)
+}
+
+static void sampler_begin(sampler_t *s)
+{
+    *s = (sampler_t){ .state = SAMPLER_TRIGGER, .result = ESP_FAIL };
+}
+
+static void count_error(esp_err_t ret)
+{
+    switch (ret) {
+        case ESP_ERR_INVALID_CRC:
+            s_health.crc_errors++;
+            break;
+        case ESP_ERR_INVALID_RESPONSE:
+            s_health.busy_errors++;
+            break;
+        case ESP_ERR_TIMEOUT:
+            s_health.timeouts++;
+            break;
+        default:
+            s_health.i2c_errors++;
+            break;
+    }
+}
+
+/*
+Neuspel poskus: naslednja stopnja okrevanja ali konec cikla.
+Tako ena motnja na vodilu ne pomeni izgubljenega vzorca.
+*/
+static void sampler_fail(sampler_t *s, esp_err_t ret)
+{
+    count_error(ret);
+    s->result = ret;
+    s->state = SAMPLER_TRIGGER;
+
+    if (s->stage == SAMPLER_STAGE_RETRY && s->retries < SENSOR_FAST_RETRIES) {
+        s->retries++;
+        s_health.retries++;
+        return;
+    }
+
+    if (s->stage == SAMPLER_STAGE_RETRY) {
+        ESP_LOGW(TAG, "Meritev ni uspela (%s), soft reset...", esp_err_to_name(ret));
+        s_health.soft_resets++;
+        s_triggered = false;
+        s->stage = SAMPLER_STAGE_RESET;
+        if (aht21_soft_reset() == ESP_OK && aht21_init() == ESP_OK) {
+            return;
+        }
+    }
+
+    if (s->stage == SAMPLER_STAGE_RESET) {
+        ESP_LOGW(TAG, "Soft reset ni pomagal, ponovna inicializacija I2C busa...");
+        s_health.bus_reinits++;
+        s->stage = SAMPLER_STAGE_REINIT;
+        if (aht21_bus_reinit() == ESP_OK) {
+            return;
+        }
+    }
+
+    s->state = SAMPLER_DONE;
+}
+
+/*
+En korak stroja stanj (kliči pod s_i2c_lock)
+*/
+static TickType_t sampler_step(sampler_t *s, sensor_data_t *data)
+{
+    esp_err_t ret;
+
+    switch (s->state) {
+        case SAMPLER_TRIGGER:
+            ret = aht21_trigger();
+            if (ret != ESP_OK) {
+                sampler_fail(s, ret);
+                return 0;
+            }
+            s->state = SAMPLER_CONVERTING;
+            return ms_to_ticks_min1(AHT21_FIRST_POLL_MS);
+
+        case SAMPLER_CONVERTING:
+            ret = sensor_manager_collect(data, 0);
+            if (ret == ESP_ERR_NOT_FINISHED) {
+                return ms_to_ticks_min1(AHT21_POLL_INTERVAL_MS);
+            }
+            if (ret != ESP_OK) {
+                sampler_fail(s, ret);
+                return 0;
+            }
+            s->result = ESP_OK;
+            s->state = SAMPLER_DONE;
+            return 0;
+
+        default:
+            return 0;
+    }
+}
+
+/*
+Celoten cikel meritve. Task med koraki spi, zato I2C lock drži le ta
+cikel; porabniki vzorcev v tem času tečejo nemoteno.
+*/
+static esp_err_t measure_with_recovery(sensor_data_t *data)
+{
+    sampler_t sampler;
+    sampler_begin(&sampler);
+
+    xSemaphoreTake(s_i2c_lock, portMAX_DELAY);
+
+    while (sampler.state != SAMPLER_DONE) {
+        TickType_t wait = sampler_step(&sampler, data);
+        if (wait > 0) {
+            vTaskDelay(wait);
+        }
+    }
+
+    if (sampler.result == ESP_OK) {
+        s_health.samples_ok++;
+    } else {
+        ESP_LOGE(TAG, "Senzor ne odgovarja po vseh poskusih okrevanja");
+        s_health.failed_cycles++;
+    }
+
+    xSemaphoreGive(s_i2c_lock);
+    return sampler.result;
+}
+
+esp_err_t sensor_manager_read(sensor_data_t *data)
+{
+    if (!initialized) {
+        ESP_LOGE(TAG, "Sensor manager ni inicializiran");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (data == NULL) {
+        ESP_LOGE(TAG, "Napacen data pointer");
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    return measure_with_recovery(data);
+}
+
+void sensor_manager_get_health_stats(sensor_health_stats_t *stats)
+{
+    if (stats) {
+        *stats = s_health;
+    }
+}
+
+/*
+Sampling task: na vsako periodo požene sampler (trigger → busy poll brez
+čakanja → branje → CRC) in objavi vzorec. Porabniki (UI, furnace) tečejo v
+svojih taskih sočasno s konverzijo in nikoli ne čakajo na I2C.
+*/
+static void sensor_sample_task(void *arg)
+{
+    sensor_data_t data;
+    TickType_t last_wake = xTaskGetTickCount();
+
+    ESP_LOGI(TAG, "Sampling task started (%lu ms)", (unsigned long)s_sample_interval_ms);
+
+    while (1) {
+        // Med konverzijo sampler spi med koraki; napake se rešujejo v istem ciklu
+        esp_err_t ret = measure_with_recovery(&data);
+
+        if (ret != ESP_OK) {
+            memset(&data, 0, sizeof(data));
+            data.valid = false;
+        } else {
+            portENTER_CRITICAL(&s_filter_mux);
+            if (!s_filter_ready) {
+                sensor_filter_init(&s_filter, NULL);
+                s_filter_ready = true;
+            }
+            data.temperature_filtered = sensor_filter_update(&s_filter, data.temperature);
+            portEXIT_CRITICAL(&s_filter_mux);
+
+            uint32_t now_ms = (uint32_t)(esp_timer_get_time() / 1000);
+            xSemaphoreTake(s_history_lock, portMAX_DELAY);
+            sensor_history_push(&s_history, now_ms, data.temperature, data.humidity);
+            xSemaphoreGive(s_history_lock);
+        }
+
+        xQueueOverwrite(s_sample_queue, &data);
+        if (s_data_callback) {
+            s_data_callback(&data);
+        }
+
+        vTaskDelayUntil(&last_wake, pdMS_TO_TICKS(s_sample_interval_ms));
+    }
+}
+
+esp_err_t sensor_manager_start(uint32_t interval_ms)
+{
+    if (!initialized) {
+        ESP_LOGE(TAG, "Sensor manager ni inicializiran");
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (s_sample_task != NULL) {
+        return ESP_OK;
+    }
+
+    if (s_sample_queue == NULL) {
+        s_sample_queue = xQueueCreate(1, sizeof(sensor_data_t));
+        if (s_sample_queue == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    if (s_history_lock == NULL) {
+        s_history_lock = xSemaphoreCreateMutex();
+        if (s_history_lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+
+    s_sample_interval_ms = interval_ms;
+    sensor_history_init(&s_history, interval_ms);
+    if (xTaskCreate(sensor_sample_task, "sensor_sample", SENSOR_TASK_STACK, NULL,
+                    SENSOR_TASK_PRIORITY, &s_sample_task) != pdPASS) {
+        ESP_LOGE(TAG, "Napaka pri kreiranju sampling taska");
+        return ESP_ERR_NO_MEM;
     }
 
     return ESP_OK;
 }
 
+esp_err_t sensor_manager_wait(sensor_data_t *data, uint32_t timeout_ms)
+{
+    if (data == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    if (s_sample_queue == NULL) {
+        // Sampling še ni zagnan (npr. init senzorja ni uspel) - počakaj in javi napako
+        vTaskDelay(pdMS_TO_TICKS(timeout_ms));
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    if (xQueueReceive(s_sample_queue, data, pdMS_TO_TICKS(timeout_ms)) != pdTRUE) {
+        return ESP_ERR_TIMEOUT;
+    }
+
+    return data->valid ? ESP_OK : ESP_ERR_INVALID_RESPONSE;
+}
+
+void sensor_manager_set_filter(const sensor_filter_config_t *config)
+{
+    portENTER_CRITICAL(&s_filter_mux);
+    sensor_filter_init(&s_filter, config);
+    s_filter_ready = true;
+    portEXIT_CRITICAL(&s_filter_mux);
+
+    ESP_LOGI(TAG, "Filter: median-%d, smoother=%d, fixed_point=%d",
+             s_filter.config.median_len, s_filter.config.smoother, s_filter.config.fixed_point);
+}
+
+bool sensor_manager_get_window_stats(sensor_window_t window, sensor_window_stats_t *stats)
+{
+    if (s_history_lock == NULL) {
+        return false;   // Sampling še ni zagnan
+    }
+
+    xSemaphoreTake(s_history_lock, portMAX_DELAY);
+    bool ok = sensor_history_get_stats(&s_history, window, stats);
+    xSemaphoreGive(s_history_lock);
+    return ok;
+}
+
+bool sensor_manager_get_history_sample(uint16_t age, sensor_sample_t *sample)
+{
+    if (s_history_lock == NULL) {
+        return false;
+    }
+
+    xSemaphoreTake(s_history_lock, portMAX_DELAY);
+    bool ok = sensor_history_get_sample(&s_history, age, sample);
+    xSemaphoreGive(s_history_lock);
+    return ok;
+}
+
+void sensor_manager_register_callback(sensor_data_callback_t callback)
+{
+    s_data_callback = callback;
+}
+
 // ODMONTIRANJE 
 
 esp_err_t sensor_manager_deinit(void)  
@@ -0,0 +1,71 @@
+/**
+ * @file setpoint_manager.h
+ * @brief Setpoint Manager - thread-safe target temperatura z debounce
+ *
+ * Hitri popravki (tapi, long-press repeat) takoj spremenijo vrednost za
+ * prikaz, furnace controller pa dobi samo končno vrednost, ko se
+ * nastavljanje umiri (settle_ms brez novih popravkov).
+ */
+#ifndef SETPOINT_MANAGER_H
+#define SETPOINT_MANAGER_H
+
+#include "esp_err.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Callback ob umirjeni (commit) vrednosti
+ * 
+ * Kliče esp_timer task (popravki) ali task, ki je poklical
+ * setpoint_manager_set().
+ * 
+ * @param target Nova target temperatura v °C
+ * @param manual true = vrednost iz setpoint_manager_adjust() (uporabnik),
+ *               false = iz setpoint_manager_set() (npr. urnik)
+ */
+typedef void (*setpoint_callback_t)(float target, bool manual);
+
+/**
+ * @brief Inicializira setpoint manager
+ * @param initial Začetna target temperatura (°C)
+ * @param min Najnižja dovoljena vrednost (°C)
+ * @param max Najvišja dovoljena vrednost (°C)
+ * @param step Korak enega popravka (°C)
+ * @param settle_ms Čas brez popravkov pred commit-om
+ * @return ESP_OK če uspešno
+ */
+esp_err_t setpoint_manager_init(float initial, float min, float max, float step, uint32_t settle_ms);
+
+/**
+ * @brief Popravi target za N korakov (npr. +1 / -1 iz gumba)
+ * 
+ * Ne blokira - vrednost se spremeni takoj, commit pa se odloži.
+ * 
+ * @param steps Število korakov (negativno = navzdol)
+ * @return Nova (še ne commit-ana) vrednost v °C
+ */
+float setpoint_manager_adjust(int steps);
+
+/**
+ * @brief Nastavi target takoj (brez debounce, npr. iz urnika)
+ * 
+ * Prekliče nepotrjene popravke - commit gre s manual = false.
+ * 
+ * @param target Target temperatura v °C
+ * @return ESP_OK, ESP_ERR_INVALID_ARG če je izven meja
+ */
+esp_err_t setpoint_manager_set(float target);
+
+/**
+ * @brief Dobi trenutno vrednost (vključno z nepotrjenimi popravki)
+ * @return Target temperatura v °C
+ */
+float setpoint_manager_get(void);
+
+/**
+ * @brief Registriraj callback za commit-ane vrednosti
+ * @param callback Funkcija ali NULL
+ */
+void setpoint_manager_register_callback(setpoint_callback_t callback);
+
+#endif // SETPOINT_MANAGER_H
@@ -0,0 +1,161 @@
+/**
+ * @file setpoint_manager.c
+ * @brief Setpoint Manager implementacija
+ */
+#include "setpoint_manager.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include <math.h>
+
+static const char *TAG = "setpoint_mgr";
+
+// Vrednosti v 0.1 °C - seštevanje korakov ne nabira float napake
+static int32_t s_value = 200;
+static int32_t s_committed = 200;
+static bool s_manual = false;       // s_value je iz adjust() (še ne commit-an)
+static int32_t s_min = 150;
+static int32_t s_max = 300;
+static int32_t s_step = 5;
+static uint32_t s_settle_ms = 800;
+
+static setpoint_callback_t s_callback = NULL;
+static esp_timer_handle_t s_settle_timer = NULL;
+static portMUX_TYPE s_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static int32_t to_tenths(float value)
+{
+    return (int32_t)lroundf(value * 10.0f);
+}
+
+static int32_t clamp(int32_t value)
+{
+    if (value < s_min) return s_min;
+    if (value > s_max) return s_max;
+    return value;
+}
+
+/**
+ * @brief Commit vrednosti, če se je spremenila od zadnjega commit-a
+ */
+static void commit(void)
+{
+    bool changed;
+    bool manual;
+    int32_t value;
+    
+    // Vrednost in izvor beremo skupaj - set() med settle oknom ni ročen
+    portENTER_CRITICAL(&s_mux);
+    value = s_value;
+    manual = s_manual;
+    changed = (value != s_committed);
+    s_committed = value;
+    s_manual = false;
+    portEXIT_CRITICAL(&s_mux);
+    
+    if (!changed) {
+        return;
+    }
+    
+    ESP_LOGI(TAG, "Target committed: %.1f°C (%s)", value / 10.0f, manual ? "manual" : "set");
+    
+    if (s_callback) {
+        s_callback(value / 10.0f, manual);
+    }
+}
+
+static void settle_timer_cb(void *arg)
+{
+    commit();
+}
+
+esp_err_t setpoint_manager_init(float initial, float min, float max, float step, uint32_t settle_ms)
+{
+    if (min >= max || step <= 0.0f) {
+        ESP_LOGE(TAG, "Invalid setpoint range");
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (s_settle_timer == NULL) {
+        const esp_timer_create_args_t timer_args = {
+            .callback = settle_timer_cb,
+            .name = "setpoint_settle",
+        };
+        esp_err_t ret = esp_timer_create(&timer_args, &s_settle_timer);
+        if (ret != ESP_OK) {
+            ESP_LOGE(TAG, "Failed to create settle timer");
+            return ret;
+        }
+    }
+    
+    portENTER_CRITICAL(&s_mux);
+    s_min = to_tenths(min);
+    s_max = to_tenths(max);
+    s_step = to_tenths(step);
+    s_settle_ms = settle_ms;
+    s_value = clamp(to_tenths(initial));
+    s_committed = s_value;
+    s_manual = false;
+    portEXIT_CRITICAL(&s_mux);
+    
+    ESP_LOGI(TAG, "Setpoint %.1f°C (%.1f-%.1f, step %.1f, settle %lu ms)",
+             s_value / 10.0f, min, max, step, (unsigned long)settle_ms);
+    return ESP_OK;
+}
+
+float setpoint_manager_adjust(int steps)
+{
+    int32_t value;
+    
+    portENTER_CRITICAL(&s_mux);
+    s_value = clamp(s_value + steps * s_step);
+    s_manual = true;
+    value = s_value;
+    portEXIT_CRITICAL(&s_mux);
+    
+    if (s_settle_timer != NULL) {
+        // Vsak nov popravek podaljša čakanje → commit samo končne vrednosti
+        esp_timer_stop(s_settle_timer);
+        esp_timer_start_once(s_settle_timer, (uint64_t)s_settle_ms * 1000);
+    }
+    
+    return value / 10.0f;
+}
+
+esp_err_t setpoint_manager_set(float target)
+{
+    int32_t value = to_tenths(target);
+    
+    if (value < s_min || value > s_max) {
+        ESP_LOGW(TAG, "Target %.1f°C out of range (ignoring)", target);
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (s_settle_timer != NULL) {
+        esp_timer_stop(s_settle_timer);
+    }
+    
+    portENTER_CRITICAL(&s_mux);
+    s_value = value;
+    s_manual = false;
+    portEXIT_CRITICAL(&s_mux);
+    
+    commit();
+    return ESP_OK;
+}
+
+float setpoint_manager_get(void)
+{
+    int32_t value;
+    
+    portENTER_CRITICAL(&s_mux);
+    value = s_value;
+    portEXIT_CRITICAL(&s_mux);
+    
+    return value / 10.0f;
+}
+
+void setpoint_manager_register_callback(setpoint_callback_t callback)
+{
+    s_callback = callback;
+}
@@ -7,6 +7,8 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
 
 /**
  * @brief Shelly status struktura
@@ -20,6 +22,92 @@ typedef struct {
     bool online;            // Je Shelly dosegljiv
 } shelly_status_t;
 
+/**
+ * @brief Statistika keep-alive HTTP seje
+ */
+typedef struct {
+    uint32_t requests;      // Vse poslane HTTP zahteve
+    uint32_t reused;        // Zahteve poslane na že odprti TCP povezavi
+    uint32_t connects;      // Vse nove TCP povezave (vključno s prvo)
+    uint32_t reconnects;    // Nove povezave po padcu/zaprtju prejšnje
+    uint32_t failures;      // Neuspeli poskusi (sledi transparenten reconnect)
+    uint32_t bytes_tx;      // Poslani byti (pot zahteve + telo)
+    uint32_t bytes_rx;      // Prejeti byti telesa odgovorov
+} shelly_session_stats_t;
+
+/**
+ * @brief Shelly API backend
+ */
+typedef enum {
+    SHELLY_API_GEN1,        // /relay/N?turn= in /status (Gen1 kompatibilni)
+    SHELLY_API_RPC,         // Gen2+ RPC: Switch.Set / Switch.GetStatus, batch POST /rpc
+} shelly_api_t;
+
+/**
+ * @brief Push obvestilo o spremembi kanala (NotifyStatus)
+ *
+ * Shelly pošlje le spremenjena polja, zato has_* pove, kaj je veljavno.
+ */
+typedef struct {
+    uint8_t channel;
+    bool has_output;
+    bool output;            // Relay stanje
+    bool has_power;
+    float power;            // Trenutna moč (W)
+} shelly_notify_t;
+
+/**
+ * @brief Callback za push obvestila (kliče se iz WebSocket taska)
+ */
+typedef void (*shelly_notify_callback_t)(const shelly_notify_t *event);
+
+/**
+ * @brief Tip asinhronega ukaza za Shelly I/O task
+ */
+typedef enum {
+    SHELLY_CMD_SET_RELAY,       // Samo relay ukaz
+    SHELLY_CMD_GET_STATUS,      // Samo branje statusa
+    SHELLY_CMD_SET_AND_STATUS,  // Relay ukaz + branje statusa (en kontrolni cikel)
+} shelly_cmd_type_t;
+
+/**
+ * @brief Asinhroni ukaz
+ */
+typedef struct {
+    shelly_cmd_type_t type;
+    uint8_t channel;        // Relay channel (0 ali 1)
+    bool on;                // Želeno stanje (za SET_*)
+} shelly_cmd_t;
+
+/**
+ * @brief Rezultat asinhronega ukaza
+ */
+typedef struct {
+    shelly_cmd_t cmd;           // Izvorni ukaz
+    esp_err_t err;              // ESP_OK če je ukaz uspel
+    shelly_status_t status;     // Veljavno za GET_STATUS / SET_AND_STATUS
+    uint32_t latency_ms;        // Od oddaje v vrsto do zaključka
+} shelly_result_t;
+
+/**
+ * @brief Callback za rezultate asinhronih ukazov (kliče se iz Shelly I/O taska)
+ */
+typedef void (*shelly_result_callback_t)(const shelly_result_t *result);
+
+/**
+ * @brief Metrike ukazne vrste
+ */
+typedef struct {
+    uint32_t posted;            // Sprejeti ukazi
+    uint32_t completed;         // Izvedeni ukazi
+    uint32_t dropped;           // Zavrnjeni ukazi (polna vrsta)
+    uint32_t depth;             // Trenutno število čakajočih ukazov
+    uint32_t max_depth;         // Največja zabeležena globina
+    uint32_t last_latency_ms;   // Latenca zadnjega ukaza
+    uint32_t max_latency_ms;    // Največja latenca
+    uint32_t avg_latency_ms;    // Povprečna latenca
+} shelly_queue_stats_t;
+
 /**
  * @brief Inicializira Shelly manager
  * @param ip_address Shelly IP naslov (npr. "192.168.1.100")
@@ -42,10 +130,111 @@ esp_err_t shelly_manager_set_relay(uint8_t channel, bool on);
  */
 esp_err_t shelly_manager_get_status(shelly_status_t *status);
 
+/**
+ * @brief Preberi status enega kanala
+ *
+ * RPC backend pokliče Switch.GetStatus samo za izbrani kanal,
+ * Gen1 backend prebere celoten /status.
+ *
+ * @param channel Channel (0 ali 1)
+ * @param status Output struktura za status
+ * @return ESP_OK če uspešno
+ */
+esp_err_t shelly_manager_get_channel_status(uint8_t channel, shelly_status_t *status);
+
+/**
+ * @brief Vklopi/izklopi relay in preberi status kanala
+ *
+ * RPC backend oboje pošlje kot en JSON-RPC batch (en round trip).
+ * Če naprava batcha ne podpira (HTTP 400/404 ali RPC error namesto polja),
+ * se za 1 h preklopi na dva posamična klica. Timeout batcha ne izklopi.
+ *
+ * @param channel Channel (0 ali 1)
+ * @param on True za vklop, false za izklop
+ * @param status Output struktura za status
+ * @return ESP_OK če uspešno
+ */
+esp_err_t shelly_manager_set_relay_and_status(uint8_t channel, bool on, shelly_status_t *status);
+
+/**
+ * @brief Izberi API backend (Gen1 HTTP ali Gen2+ RPC)
+ * @param api Backend
+ */
+void shelly_manager_set_api(shelly_api_t api);
+
+/**
+ * @brief Dobi izbrani API backend
+ * @return Backend
+ */
+shelly_api_t shelly_manager_get_api(void);
+
 /**
  * @brief Nastavi IP naslov Shelly naprave
+ *
+ * Ob spremembi zapre HTTP sejo in zagnan WebSocket kanal poveže na novi
+ * naslov. Ne kliči iz callbackov za obvestila.
+ *
  * @param ip_address Nova IP naslov
  */
 void shelly_manager_set_ip(const char *ip_address);
 
+/**
+ * @brief Pošlji ukaz v vrsto Shelly I/O taska (ne blokira)
+ * @param cmd Ukaz
+ * @return ESP_OK če je ukaz sprejet, ESP_ERR_TIMEOUT če je vrsta polna
+ */
+esp_err_t shelly_manager_post(const shelly_cmd_t *cmd);
+
+/**
+ * @brief Registriraj callback za rezultate asinhronih ukazov
+ * @param callback Callback funkcija
+ */
+void shelly_manager_register_result_callback(shelly_result_callback_t callback);
+
+/**
+ * @brief Preberi metrike ukazne vrste (globina, latenca)
+ * @param stats Output struktura
+ */
+void shelly_manager_get_queue_stats(shelly_queue_stats_t *stats);
+
+/**
+ * @brief Dobi IP naslov Shelly naprave
+ * @param ip_str Buffer za IP
+ * @param max_len Velikost bufferja
+ */
+void shelly_manager_get_ip(char *ip_str, size_t max_len);
+
+/**
+ * @brief Odpri trajni WebSocket kanal za NotifyStatus obvestila (samo RPC API)
+ *
+ * Kanal se po prekinitvi sam ponovno poveže. Dokler ni povezan,
+ * shelly_manager_notify_connected() vrača false in klicatelj naj polla.
+ *
+ * @return ESP_OK če je kanal zagnan
+ */
+esp_err_t shelly_manager_notify_start(void);
+
+/**
+ * @brief Zapri WebSocket kanal za obvestila
+ */
+void shelly_manager_notify_stop(void);
+
+/**
+ * @brief Ali je kanal za obvestila trenutno povezan
+ * @return True če obvestila prihajajo (polling ni potreben)
+ */
+bool shelly_manager_notify_connected(void);
+
+/**
+ * @brief Registriraj callback za push obvestila
+ * @param callback Callback funkcija
+ */
+void shelly_manager_register_notify_callback(shelly_notify_callback_t callback);
+
+/**
+ * @brief Preberi statistiko keep-alive seje (reuse vs. reconnect)
+ * @param stats Output struktura
+ */
+void shelly_manager_get_session_stats(shelly_session_stats_t *stats);
+
 #endif // SHELLY_MANAGER_H
\ No newline at end of file
@@ -0,0 +1,345 @@
+/**
+ * @file shelly_json.c
+ * @brief Streaming JSON tokenizer implementation
+ */
+#include "shelly_json.h"
+#include <string.h>
+
+typedef enum {
+    ST_VALUE,           // Pričakujemo vrednost
+    ST_VALUE_OR_END,    // Takoj za '[' - vrednost ali ']'
+    ST_KEY_OR_END,      // Takoj za '{' - ključ ali '}'
+    ST_KEY_START,       // Za ',' v objektu - pričakujemo '"'
+    ST_KEY,             // Znotraj ključa
+    ST_COLON,           // Za ključem - pričakujemo ':'
+    ST_STRING,          // Znotraj string vrednosti
+    ST_LITERAL,         // Število / true / false / null
+    ST_AFTER_VALUE,     // Pričakujemo ',' ali zaključek
+    ST_DONE,            // Korenski element zaključen
+} parser_state_t;
+
+static bool is_space(char c)
+{
+    return c == ' ' || c == '\t' || c == '\r' || c == '\n';
+}
+
+static shelly_json_frame_t *top(shelly_json_t *p)
+{
+    return (p->depth > 0) ? &p->stack[p->depth - 1] : NULL;
+}
+
+static void buf_reset(shelly_json_t *p)
+{
+    p->buf_len = 0;
+    p->buf[0] = '\0';
+}
+
+static void buf_push(shelly_json_t *p, char c)
+{
+    if (p->buf_len < SHELLY_JSON_VALUE_LEN - 1) {
+        p->buf[p->buf_len++] = c;
+        p->buf[p->buf_len] = '\0';
+    }
+}
+
+static void key_push(shelly_json_t *p, char c)
+{
+    shelly_json_frame_t *f = top(p);
+    if (f == NULL || p->skip_depth > 0) {
+        return;
+    }
+    
+    size_t len = strlen(f->key);
+    if (len < SHELLY_JSON_KEY_LEN - 1) {
+        f->key[len] = c;
+        f->key[len + 1] = '\0';
+    } else {
+        f->key_overflow = true;
+    }
+}
+
+static void emit(shelly_json_t *p, shelly_json_type_t type)
+{
+    if (p->skip_depth == 0 && p->callback) {
+        p->callback(p, type, p->buf, p->ctx);
+    }
+}
+
+static void value_done(shelly_json_t *p)
+{
+    p->state = (p->depth == 0 && p->skip_depth == 0) ? ST_DONE : ST_AFTER_VALUE;
+}
+
+static bool open_container(shelly_json_t *p, bool is_array)
+{
+    if (p->skip_depth > 0 || p->depth >= SHELLY_JSON_MAX_DEPTH) {
+        p->skip_depth++;
+    } else {
+        shelly_json_frame_t *f = &p->stack[p->depth++];
+        memset(f, 0, sizeof(*f));
+        f->is_array = is_array;
+    }
+    
+    p->state = is_array ? ST_VALUE_OR_END : ST_KEY_OR_END;
+    return true;
+}
+
+static bool close_container(shelly_json_t *p, bool is_array)
+{
+    if (p->skip_depth > 0) {
+        p->skip_depth--;
+    } else {
+        shelly_json_frame_t *f = top(p);
+        if (f == NULL || f->is_array != is_array) {
+            return false;
+        }
+        p->depth--;
+    }
+    
+    value_done(p);
+    return true;
+}
+
+/**
+ * @brief Zaključi literal (število / true / false / null)
+ */
+static bool finish_literal(shelly_json_t *p)
+{
+    shelly_json_type_t type;
+    
+    if (strcmp(p->buf, "true") == 0) {
+        type = SHELLY_JSON_TRUE;
+    } else if (strcmp(p->buf, "false") == 0) {
+        type = SHELLY_JSON_FALSE;
+    } else if (strcmp(p->buf, "null") == 0) {
+        type = SHELLY_JSON_NULL;
+    } else if (p->buf[0] == '-' || (p->buf[0] >= '0' && p->buf[0] <= '9')) {
+        type = SHELLY_JSON_NUMBER;
+    } else {
+        return false;
+    }
+    
+    emit(p, type);
+    value_done(p);
+    return true;
+}
+
+static bool start_value(shelly_json_t *p, char c)
+{
+    switch (c) {
+        case '{':
+            return open_container(p, false);
+        case '[':
+            return open_container(p, true);
+        case '"':
+            buf_reset(p);
+            p->escape = false;
+            p->state = ST_STRING;
+            return true;
+        default:
+            if (c == '-' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z')) {
+                buf_reset(p);
+                buf_push(p, c);
+                p->state = ST_LITERAL;
+                return true;
+            }
+            return false;
+    }
+}
+
+static bool step(shelly_json_t *p, char c)
+{
+    shelly_json_frame_t *f;
+    
+    switch ((parser_state_t)p->state) {
+        case ST_LITERAL:
+            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') ||
+                c == '.' || c == '-' || c == '+' || c == 'E') {
+                buf_push(p, c);
+                return true;
+            }
+            if (!finish_literal(p)) {
+                return false;
+            }
+            return step(p, c);      // Ločilo obdelaj v novem stanju
+            
+        case ST_STRING:
+            if (p->escape) {
+                p->escape = false;
+                buf_push(p, c);
+            } else if (c == '\\') {
+                p->escape = true;
+            } else if (c == '"') {
+                emit(p, SHELLY_JSON_STRING);
+                value_done(p);
+            } else {
+                buf_push(p, c);
+            }
+            return true;
+            
+        case ST_KEY:
+            if (p->escape) {
+                p->escape = false;
+                key_push(p, c);
+            } else if (c == '\\') {
+                p->escape = true;
+            } else if (c == '"') {
+                p->state = ST_COLON;
+            } else {
+                key_push(p, c);
+            }
+            return true;
+            
+        default:
+            break;
+    }
+    
+    if (is_space(c)) {
+        return true;
+    }
+    
+    switch ((parser_state_t)p->state) {
+        case ST_VALUE:
+            return start_value(p, c);
+            
+        case ST_VALUE_OR_END:
+            if (c == ']') {
+                return close_container(p, true);
+            }
+            return start_value(p, c);
+            
+        case ST_KEY_OR_END:
+            if (c == '}') {
+                return close_container(p, false);
+            }
+            /* fall through */
+        case ST_KEY_START:
+            if (c != '"') {
+                return false;
+            }
+            f = top(p);
+            if (f && p->skip_depth == 0) {
+                f->key[0] = '\0';
+                f->key_overflow = false;
+            }
+            p->escape = false;
+            p->state = ST_KEY;
+            return true;
+            
+        case ST_COLON:
+            if (c != ':') {
+                return false;
+            }
+            p->state = ST_VALUE;
+            return true;
+            
+        case ST_AFTER_VALUE: {
+            bool in_array;
+            if (p->skip_depth > 0) {
+                // Znotraj preskočenega dela ne vemo tipa - sprejmi oba
+                if (c == ',' || c == ':') {
+                    p->state = ST_VALUE;    // Ključ v objektu je string - ST_VALUE ga sprejme
+                    return true;
+                }
+                if (c == '}' || c == ']') {
+                    return close_container(p, c == ']');
+                }
+                return false;
+            }
+            f = top(p);
+            if (f == NULL) {
+                return false;
+            }
+            in_array = f->is_array;
+            if (c == ',') {
+                if (in_array) {
+                    f->index++;
+                    p->state = ST_VALUE;
+                } else {
+                    p->state = ST_KEY_START;
+                }
+                return true;
+            }
+            if (c == ']' || c == '}') {
+                return close_container(p, c == ']');
+            }
+            return false;
+        }
+            
+        case ST_DONE:
+            return false;
+            
+        default:
+            return false;
+    }
+}
+
+void shelly_json_init(shelly_json_t *parser, shelly_json_value_cb_t callback, void *ctx)
+{
+    memset(parser, 0, sizeof(*parser));
+    parser->callback = callback;
+    parser->ctx = ctx;
+    parser->state = ST_VALUE;
+}
+
+bool shelly_json_feed(shelly_json_t *parser, const char *data, size_t len)
+{
+    if (parser->error) {
+        return false;
+    }
+    
+    for (size_t i = 0; i < len; i++) {
+        if (!step(parser, data[i])) {
+            parser->error = true;
+            return false;
+        }
+    }
+    
+    parser->bytes += len;
+    return true;
+}
+
+bool shelly_json_done(const shelly_json_t *parser)
+{
+    return !parser->error && parser->state == ST_DONE;
+}
+
+bool shelly_json_match(const shelly_json_t *parser, const char *pattern, int *index)
+{
+    const char *seg = pattern;
+    bool captured = false;
+    
+    if (parser->skip_depth > 0) {
+        return false;
+    }
+    
+    for (uint8_t level = 0; level < parser->depth; level++) {
+        const shelly_json_frame_t *f = &parser->stack[level];
+        
+        if (*seg == '\0') {
+            return false;
+        }
+        
+        const char *end = strchr(seg, '.');
+        size_t seg_len = end ? (size_t)(end - seg) : strlen(seg);
+        
+        if (f->is_array) {
+            if (seg_len != 2 || seg[0] != '[' || seg[1] != ']') {
+                return false;
+            }
+            if (index && !captured) {
+                *index = f->index;
+                captured = true;
+            }
+        } else {
+            if (f->key_overflow || strlen(f->key) != seg_len ||
+                strncmp(f->key, seg, seg_len) != 0) {
+                return false;
+            }
+        }
+        
+        seg = end ? end + 1 : seg + seg_len;
+    }
+    
+    return *seg == '\0';
+}
@@ -0,0 +1,107 @@
+/**
+ * @file shelly_json.h
+ * @brief Streaming JSON tokenizer za Shelly odgovore (brez alokacij)
+ *
+ * Parser prejema telo odgovora po kosih (kot prihaja iz HTTP/WebSocket
+ * odjemalca) in za vsako skalarno vrednost pokliče callback. Celoten
+ * dokument nikoli ni v pomnilniku - hrani se le sklad ključev/indeksov
+ * do trenutne vrednosti.
+ */
+#ifndef SHELLY_JSON_H
+#define SHELLY_JSON_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHELLY_JSON_MAX_DEPTH   8       // Globlje vrednosti se preskočijo
+#define SHELLY_JSON_KEY_LEN     24      // Daljši ključi se nikoli ne ujemajo
+#define SHELLY_JSON_VALUE_LEN   32      // Daljše vrednosti se odrežejo
+
+/**
+ * @brief Tip skalarne vrednosti
+ */
+typedef enum {
+    SHELLY_JSON_NUMBER,
+    SHELLY_JSON_STRING,
+    SHELLY_JSON_TRUE,
+    SHELLY_JSON_FALSE,
+    SHELLY_JSON_NULL,
+} shelly_json_type_t;
+
+typedef struct shelly_json shelly_json_t;
+
+/**
+ * @brief Callback za vsako skalarno vrednost
+ * @param parser Parser (za shelly_json_match() na trenutni poti)
+ * @param type Tip vrednosti
+ * @param value Vrednost kot niz (zaključen z '\0')
+ * @param ctx Uporabniški kontekst
+ */
+typedef void (*shelly_json_value_cb_t)(const shelly_json_t *parser, shelly_json_type_t type,
+                                       const char *value, void *ctx);
+
+/**
+ * @brief En nivo poti (objekt z zadnjim ključem ali array z indeksom)
+ */
+typedef struct {
+    bool is_array;
+    bool key_overflow;
+    uint16_t index;
+    char key[SHELLY_JSON_KEY_LEN];
+} shelly_json_frame_t;
+
+/**
+ * @brief Stanje parserja (cel parser živi na skladu klicatelja)
+ */
+struct shelly_json {
+    shelly_json_value_cb_t callback;
+    void *ctx;
+    shelly_json_frame_t stack[SHELLY_JSON_MAX_DEPTH];
+    uint8_t depth;              // Število frame-ov na skladu
+    uint16_t skip_depth;        // Gnezdenje nad SHELLY_JSON_MAX_DEPTH
+    uint8_t state;
+    bool escape;
+    bool error;
+    char buf[SHELLY_JSON_VALUE_LEN];
+    uint8_t buf_len;
+    uint32_t bytes;             // Skupaj prebranih bytov
+};
+
+/**
+ * @brief Pripravi parser za nov dokument
+ * @param parser Parser
+ * @param callback Callback za skalarne vrednosti
+ * @param ctx Uporabniški kontekst
+ */
+void shelly_json_init(shelly_json_t *parser, shelly_json_value_cb_t callback, void *ctx);
+
+/**
+ * @brief Podaj naslednji kos dokumenta
+ * @param parser Parser
+ * @param data Podatki
+ * @param len Dolžina podatkov
+ * @return false ob sintaktični napaki (nadaljnji podatki se ignorirajo)
+ */
+bool shelly_json_feed(shelly_json_t *parser, const char *data, size_t len);
+
+/**
+ * @brief Ali je bil korenski JSON element v celoti prebran
+ */
+bool shelly_json_done(const shelly_json_t *parser);
+
+/**
+ * @brief Preveri, ali se trenutna pot ujema z vzorcem
+ *
+ * Vzorec je zaporedje segmentov, ločenih s piko. Segment "[]" se ujema s
+ * poljubnim indeksom arraya, ostali segmenti s ključem objekta. Primer:
+ * "relays.[].ison" ali "switch:0.temperature.tC".
+ *
+ * @param parser Parser (v value callbacku)
+ * @param pattern Vzorec poti
+ * @param index Output za indeks prvega "[]" segmenta (lahko NULL)
+ * @return true če se pot ujema v celoti
+ */
+bool shelly_json_match(const shelly_json_t *parser, const char *pattern, int *index);
+
+#endif // SHELLY_JSON_H
@@ -1,24 +1,316 @@
 /**
  * @file shelly_manager.c
- * @brief Shelly 2PM Gen3 HTTP API implementation (simplified, no JSON parsing)
+ * @brief Shelly 2PM Gen3 HTTP API implementation
  */
 #include "shelly_manager.h"
+#include "shelly_json.h"
+#include "shelly_notify.h"
 #include "esp_http_client.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
 #include <string.h>
 #include <stdio.h>
+#include <stdlib.h>
 
 static const char *TAG = "shelly_mgr";
 
+#define SHELLY_HTTP_TIMEOUT_MS      5000
+#define SHELLY_HTTP_MAX_ATTEMPTS    2       // Prvi poskus + en transparenten reconnect
+
+#define SHELLY_QUEUE_LEN            8       // Največ čakajočih ukazov
+#define SHELLY_TASK_STACK           6144
+#define SHELLY_TASK_PRIORITY        4
+
+#define SHELLY_BATCH_RETRY_MS       3600000 // Po zavrnjenem batchu ga čez 1 h poskusi znova (npr. po OTA)
+
 static char shelly_ip[32] = {0};
 
+// API stanje: piše ga bring-up (set_api) in I/O task (batch fallback) → pod s_session.lock
+static shelly_api_t s_api = SHELLY_API_GEN1;
+static bool s_batch_supported = true;   // Se izklopi, če naprava zavrne JSON-RPC batch
+static int64_t s_batch_retry_us = 0;    // Kdaj batch ponovno poskusimo (ko je izklopljen)
+
+// ═══════════════════════════════════════════════════════════
+// Keep-alive HTTP seja (ena TCP povezava na napravo)
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief Dolgo-živeča HTTP seja do Shelly naprave
+ *
+ * Handle ostane odprt med klici, zato esp_http_client ponovno uporabi
+ * obstoječo TCP povezavo (HTTP/1.1 keep-alive). Če jo naprava medtem zapre,
+ * se seja ob naslednji zahtevi tiho ponovno poveže.
+ */
+typedef struct {
+    esp_http_client_handle_t client;
+    SemaphoreHandle_t lock;
+    bool connected;             // TCP povezava je odprta (ON_CONNECTED / DISCONNECTED)
+    bool connected_now;         // Med trenutno zahtevo je nastala nova povezava
+    shelly_json_t *rx_parser;   // Telo odgovora gre sproti v parser (lahko NULL)
+    shelly_session_stats_t stats;
+} shelly_session_t;
+
+static shelly_session_t s_session = {0};
+
+static esp_err_t session_event_handler(esp_http_client_event_t *evt)
+{
+    shelly_session_t *session = (shelly_session_t *)evt->user_data;
+
+    switch (evt->event_id) {
+        case HTTP_EVENT_ON_CONNECTED:
+            if (session->stats.connects > 0) {
+                session->stats.reconnects++;
+            }
+            session->stats.connects++;
+            session->connected = true;
+            session->connected_now = true;
+            break;
+
+        case HTTP_EVENT_DISCONNECTED:
+            session->connected = false;
+            break;
+
+        case HTTP_EVENT_ON_DATA:
+            session->stats.bytes_rx += evt->data_len;
+            if (session->rx_parser) {
+                shelly_json_feed(session->rx_parser, (const char *)evt->data, evt->data_len);
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return ESP_OK;
+}
+
+/**
+ * @brief Zapre sejo (naslednja zahteva odpre novo povezavo)
+ */
+static void session_close(void)
+{
+    if (s_session.client) {
+        esp_http_client_cleanup(s_session.client);
+        s_session.client = NULL;
+    }
+    s_session.connected = false;
+}
+
+static esp_err_t session_open(const char *url)
+{
+    esp_http_client_config_t config = {
+        .url = url,
+        .timeout_ms = SHELLY_HTTP_TIMEOUT_MS,
+        .event_handler = session_event_handler,
+        .user_data = &s_session,
+        .keep_alive_enable = true,      // TCP keep-alive zazna mrtvo povezavo
+    };
+
+    s_session.client = esp_http_client_init(&config);
+    if (s_session.client == NULL) {
+        ESP_LOGE(TAG, "Failed to create HTTP client");
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+/**
+ * @brief Izvede zahtevo na obstoječi seji
+ * @param path Pot brez hosta (npr. "/status")
+ * @param post_body JSON telo za POST (NULL za GET)
+ * @param parser Parser za telo odgovora (NULL če telo ni potrebno)
+ * @param http_status HTTP status odgovora, 0 če ga ni bilo (lahko NULL)
+ * @return ESP_OK ob HTTP 200, ESP_FAIL ob drugem statusu
+ */
+static esp_err_t session_request(const char *path, const char *post_body, shelly_json_t *parser,
+                                 int *http_status)
+{
+    char url[128];
+    snprintf(url, sizeof(url), "http://%s%s", shelly_ip, path);
+
+    if (s_session.lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+
+    xSemaphoreTake(s_session.lock, portMAX_DELAY);
+
+    int status_code = 0;
+    esp_err_t err = ESP_FAIL;
+    for (int attempt = 0; attempt < SHELLY_HTTP_MAX_ATTEMPTS; attempt++) {
+        if (s_session.client == NULL) {
+            err = session_open(url);
+            if (err != ESP_OK) {
+                break;
+            }
+        } else {
+            esp_http_client_set_url(s_session.client, url);
+        }
+
+        if (post_body) {
+            esp_http_client_set_method(s_session.client, HTTP_METHOD_POST);
+            esp_http_client_set_header(s_session.client, "Content-Type", "application/json");
+            esp_http_client_set_post_field(s_session.client, post_body, strlen(post_body));
+        } else {
+            esp_http_client_set_method(s_session.client, HTTP_METHOD_GET);
+            esp_http_client_set_post_field(s_session.client, NULL, 0);
+        }
+
+        bool was_connected = s_session.connected;
+        s_session.connected_now = false;
+        s_session.rx_parser = parser;
+        if (parser) {
+            // Ob ponovnem poskusu začni dokument znova
+            shelly_json_init(parser, parser->callback, parser->ctx);
+        }
+
+        s_session.stats.requests++;
+        s_session.stats.bytes_tx += strlen(path) + (post_body ? strlen(post_body) : 0);
+        err = esp_http_client_perform(s_session.client);
+
+        if (err == ESP_OK) {
+            if (was_connected && !s_session.connected_now) {
+                s_session.stats.reused++;
+            }
+
+            status_code = esp_http_client_get_status_code(s_session.client);
+            if (status_code != 200) {
+                ESP_LOGW(TAG, "Unexpected status code: %d", status_code);
+                err = ESP_FAIL;
+            }
+            break;
+        }
+
+        // Socket je padel (npr. Shelly je zaprl idle povezavo) → nova povezava
+        ESP_LOGW(TAG, "HTTP request failed (%s), reconnecting...", esp_err_to_name(err));
+        s_session.stats.failures++;
+        session_close();
+    }
+
+    s_session.rx_parser = NULL;
+    xSemaphoreGive(s_session.lock);
+
+    if (http_status) {
+        *http_status = status_code;
+    }
+    return err;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Shelly I/O task z omejeno ukazno vrsto
+// ═══════════════════════════════════════════════════════════
+
+typedef struct {
+    shelly_cmd_t cmd;
+    int64_t enqueued_us;
+} shelly_queued_cmd_t;
+
+static QueueHandle_t s_cmd_queue = NULL;
+static shelly_result_callback_t s_result_callback = NULL;
+static shelly_queue_stats_t s_queue_stats = {0};
+static uint64_t s_latency_sum_ms = 0;
+static portMUX_TYPE s_stats_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static void shelly_io_task(void *arg)
+{
+    shelly_queued_cmd_t item;
+    shelly_result_t result;
+    
+    ESP_LOGI(TAG, "Shelly I/O task started");
+    
+    while (1) {
+        if (xQueueReceive(s_cmd_queue, &item, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+        
+        memset(&result, 0, sizeof(result));
+        result.cmd = item.cmd;
+        
+        switch (item.cmd.type) {
+            case SHELLY_CMD_SET_RELAY:
+                result.err = shelly_manager_set_relay(item.cmd.channel, item.cmd.on);
+                break;
+            case SHELLY_CMD_GET_STATUS:
+                result.err = shelly_manager_get_channel_status(item.cmd.channel, &result.status);
+                break;
+            case SHELLY_CMD_SET_AND_STATUS:
+                result.err = shelly_manager_set_relay_and_status(item.cmd.channel, item.cmd.on,
+                                                                 &result.status);
+                break;
+            default:
+                result.err = ESP_ERR_INVALID_ARG;
+                break;
+        }
+        
+        result.latency_ms = (uint32_t)((esp_timer_get_time() - item.enqueued_us) / 1000);
+        
+        portENTER_CRITICAL(&s_stats_mux);
+        s_queue_stats.completed++;
+        s_queue_stats.last_latency_ms = result.latency_ms;
+        if (result.latency_ms > s_queue_stats.max_latency_ms) {
+            s_queue_stats.max_latency_ms = result.latency_ms;
+        }
+        s_latency_sum_ms += result.latency_ms;
+        s_queue_stats.avg_latency_ms = (uint32_t)(s_latency_sum_ms / s_queue_stats.completed);
+        portEXIT_CRITICAL(&s_stats_mux);
+        
+        ESP_LOGD(TAG, "Command %d done in %lu ms (%s)", item.cmd.type,
+                 (unsigned long)result.latency_ms, esp_err_to_name(result.err));
+        
+        if (s_result_callback) {
+            s_result_callback(&result);
+        }
+    }
+}
+
+static esp_err_t start_io_task(void)
+{
+    if (s_cmd_queue != NULL) {
+        return ESP_OK;
+    }
+    
+    s_cmd_queue = xQueueCreate(SHELLY_QUEUE_LEN, sizeof(shelly_queued_cmd_t));
+    if (s_cmd_queue == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    
+    if (xTaskCreate(shelly_io_task, "shelly_io", SHELLY_TASK_STACK, NULL,
+                    SHELLY_TASK_PRIORITY, NULL) != pdPASS) {
+        vQueueDelete(s_cmd_queue);
+        s_cmd_queue = NULL;
+        return ESP_ERR_NO_MEM;
+    }
+    
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Javni API
+// ═══════════════════════════════════════════════════════════
+
 esp_err_t shelly_manager_init(const char *ip_address)
 {
     if (ip_address == NULL) {
         return ESP_ERR_INVALID_ARG;
     }
     
-    strncpy(shelly_ip, ip_address, sizeof(shelly_ip) - 1);
+    if (s_session.lock == NULL) {
+        s_session.lock = xSemaphoreCreateMutex();
+        if (s_session.lock == NULL) {
+            return ESP_ERR_NO_MEM;
+        }
+    }
+    
+    esp_err_t ret = start_io_task();
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start Shelly I/O task");
+        return ret;
+    }
+    
+    shelly_manager_set_ip(ip_address);
     ESP_LOGI(TAG, "Shelly manager initialized for IP: %s", shelly_ip);
     
     return ESP_OK;
@@ -26,9 +318,44 @@ esp_err_t shelly_manager_init(const char *ip_address)
 
 void shelly_manager_set_ip(const char *ip_address)
 {
-    if (ip_address) {
+    if (ip_address == NULL) {
+        return;
+    }
+    
+    if (s_session.lock) {
+        xSemaphoreTake(s_session.lock, portMAX_DELAY);
+    }
+    
+    bool changed = strncmp(shelly_ip, ip_address, sizeof(shelly_ip) - 1) != 0;
+    if (changed) {
+        // Nova naprava → stara povezava ni več uporabna
+        session_close();
         strncpy(shelly_ip, ip_address, sizeof(shelly_ip) - 1);
     }
+    
+    if (s_session.lock) {
+        xSemaphoreGive(s_session.lock);
+    }
+    
+    if (changed) {
+        // Izven session lock-a: restart WebSocket kanala lahko traja
+        shelly_notify_ip_changed();
+    }
+}
+
+void shelly_manager_get_ip(char *ip_str, size_t max_len)
+{
+    if (ip_str == NULL || max_len == 0) return;
+    
+    // set_ip prepisuje buffer pod lockom → brez njega bi lahko prebrali pol starega IP-ja
+    if (s_session.lock) {
+        xSemaphoreTake(s_session.lock, portMAX_DELAY);
+    }
+    strncpy(ip_str, shelly_ip, max_len - 1);
+    ip_str[max_len - 1] = '\0';
+    if (s_session.lock) {
+        xSemaphoreGive(s_session.lock);
+    }
 }
 
 esp_err_t shelly_manager_set_relay(uint8_t channel, bool on)
@@ -37,63 +364,66 @@ esp_err_t shelly_manager_set_relay(uint8_t channel, bool on)
         return ESP_ERR_INVALID_ARG;
     }
     
-    char url[128];
-    snprintf(url, sizeof(url), 
-             "http://%s/relay/%d?turn=%s", 
-             shelly_ip, channel, on ? "on" : "off");
+    char path[48];
+    if (shelly_manager_get_api() == SHELLY_API_RPC) {
+        snprintf(path, sizeof(path), "/rpc/Switch.Set?id=%d&on=%s", channel, on ? "true" : "false");
+    } else {
+        snprintf(path, sizeof(path), "/relay/%d?turn=%s", channel, on ? "on" : "off");
+    }
     
     ESP_LOGI(TAG, "Setting relay %d to %s", channel, on ? "ON" : "OFF");
-    ESP_LOGI(TAG, "URL: %s", url);
-    
-    esp_http_client_config_t config = {
-        .url = url,
-        .timeout_ms = 5000,
-    };
+    ESP_LOGD(TAG, "Path: %s", path);
     
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    esp_err_t err = esp_http_client_perform(client);
+    esp_err_t err = session_request(path, NULL, NULL, NULL);
     
     if (err == ESP_OK) {
-        int status_code = esp_http_client_get_status_code(client);
-        ESP_LOGI(TAG, "HTTP Status = %d", status_code);
-        
-        if (status_code == 200) {
-            ESP_LOGI(TAG, "Relay command successful");
-        } else {
-            ESP_LOGW(TAG, "Unexpected status code: %d", status_code);
-            err = ESP_FAIL;
-        }
+        ESP_LOGI(TAG, "Relay command successful");
     } else {
         ESP_LOGE(TAG, "HTTP request failed: %s", esp_err_to_name(err));
     }
     
-    esp_http_client_cleanup(client);
     return err;
 }
 
 /**
- * @brief Simple string search helper
+ * @brief Izlušči polja statusa v enem prehodu skozi odgovor
+ *
+ * Podprta sta oba formata:
+ * - Gen1 /status:   {"relays":[{"ison":..}],"meters":[{"power":..}],"tmp":{"tC":..}}
+ * - Gen2+ status:   {"switch:0":{"output":..,"apower":..,"temperature":{"tC":..}}}
  */
-static bool str_contains(const char *haystack, const char *needle)
+static void status_value_cb(const shelly_json_t *parser, shelly_json_type_t type,
+                            const char *value, void *ctx)
 {
-    return strstr(haystack, needle) != NULL;
-}
-
-/**
- * @brief Extract float value after key in JSON-like string
- * Example: "power":123.45  -> returns 123.45
- */
-static float extract_float_value(const char *str, const char *key)
-{
-    char search[64];
-    snprintf(search, sizeof(search), "\"%s\":", key);
+    shelly_status_t *status = (shelly_status_t *)ctx;
+    int idx = -1;
     
-    const char *pos = strstr(str, search);
-    if (pos) {
-        pos += strlen(search);
-        return atof(pos);
+    if (type == SHELLY_JSON_TRUE || type == SHELLY_JSON_FALSE) {
+        bool on = (type == SHELLY_JSON_TRUE);
+        
+        if (shelly_json_match(parser, "relays.[].ison", &idx)) {
+            if (idx == 0) status->output_0 = on;
+            if (idx == 1) status->output_1 = on;
+        } else if (shelly_json_match(parser, "switch:0.output", NULL)) {
+            status->output_0 = on;
+        } else if (shelly_json_match(parser, "switch:1.output", NULL)) {
+            status->output_1 = on;
+        }
+    } else if (type == SHELLY_JSON_NUMBER) {
+        float v = strtof(value, NULL);
+        
+        if (shelly_json_match(parser, "meters.[].power", &idx)) {
+            if (idx == 0) status->power_0 = v;
+            if (idx == 1) status->power_1 = v;
+        } else if (shelly_json_match(parser, "switch:0.apower", NULL)) {
+            status->power_0 = v;
+        } else if (shelly_json_match(parser, "switch:1.apower", NULL)) {
+            status->power_1 = v;
+        } else if (shelly_json_match(parser, "tmp.tC", NULL) ||
+                   shelly_json_match(parser, "switch:0.temperature.tC", NULL)) {
+            status->temperature = v;
+        }
     }
-    return 0.0f;
 }
 
 esp_err_t shelly_manager_get_status(shelly_status_t *status)
@@ -104,87 +434,317 @@ esp_err_t shelly_manager_get_status(shelly_status_t *status)
     
     memset(status, 0, sizeof(shelly_status_t));
     
-    char url[128];
-    snprintf(url, sizeof(url), "http://%s/status", shelly_ip);
+    // Odgovor se parsa sproti po kosih - nikoli ni cel v pomnilniku
+    shelly_json_t parser;
+    shelly_json_init(&parser, status_value_cb, status);
     
-    char response_buffer[1024] = {0};
-    
-    esp_http_client_config_t config = {
-        .url = url,
-        .timeout_ms = 5000,
-    };
-    
-    esp_http_client_handle_t client = esp_http_client_init(&config);
-    esp_err_t err = esp_http_client_open(client, 0);
+    esp_err_t err = session_request((shelly_manager_get_api() == SHELLY_API_RPC) ? "/rpc/Shelly.GetStatus" : "/status",
+                                     NULL, &parser, NULL);
     
     if (err != ESP_OK) {
-        ESP_LOGE(TAG, "Failed to open HTTP connection: %s", esp_err_to_name(err));
-        esp_http_client_cleanup(client);
-        status->online = false;
+        ESP_LOGE(TAG, "Failed to read status: %s", esp_err_to_name(err));
+        memset(status, 0, sizeof(shelly_status_t));
         return err;
     }
     
-    int content_length = esp_http_client_fetch_headers(client);//če rabiš.
-    int data_read = esp_http_client_read_response(client, response_buffer, sizeof(response_buffer) - 1);
+    if (!shelly_json_done(&parser)) {
+        ESP_LOGE(TAG, "Malformed status response (%lu bytes)", (unsigned long)parser.bytes);
+        memset(status, 0, sizeof(shelly_status_t));
+        return ESP_ERR_INVALID_RESPONSE;
+    }
     
-    if (data_read >= 0) {
-        response_buffer[data_read] = '\0';
-        
-        ESP_LOGI(TAG, "Received %d bytes", data_read);
-        ESP_LOGD(TAG, "Response: %s", response_buffer);
-        
-        // Simple string parsing (no JSON library needed)
-        // Shelly Gen3 response format: {"relays":[{"ison":true,...},...],...}
-        
-        // Check relay 0 status
-        // Look for first "ison" in relays array
-        const char *relay0_pos = strstr(response_buffer, "\"relays\":[{");
-        if (relay0_pos) {
-            const char *ison_pos = strstr(relay0_pos, "\"ison\":");
-            if (ison_pos) {
-                status->output_0 = str_contains(ison_pos, "true");
-            }
-            
-            // Look for second relay (after first closing brace)
-            const char *relay1_pos = strstr(ison_pos, "},{");
-            if (relay1_pos) {
-                const char *ison2_pos = strstr(relay1_pos, "\"ison\":");
-                if (ison2_pos) {
-                    status->output_1 = str_contains(ison2_pos, "true");
-                }
+    ESP_LOGD(TAG, "Received %lu bytes", (unsigned long)parser.bytes);
+    
+    status->online = true;
+    
+    ESP_LOGI(TAG, "Status: Relay0=%s, Relay1=%s, Power0=%.1fW, Power1=%.1fW, Temp=%.1f°C",
+             status->output_0 ? "ON" : "OFF",
+             status->output_1 ? "ON" : "OFF",
+             status->power_0,
+             status->power_1,
+             status->temperature);
+    
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Gen2+ RPC (Switch.GetStatus / batch)
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief Kontekst za parsanje Switch.GetStatus odgovora
+ */
+typedef struct {
+    shelly_status_t *status;
+    uint8_t channel;
+    bool has_output;        // Odgovor je vseboval Switch status
+    bool rpc_error;         // Odgovor (ali del batcha) je RPC error objekt
+    bool top_error;         // Error objekt namesto polja (naprava batcha ni sprejela)
+} rpc_status_ctx_t;
+
+/**
+ * @brief Izlušči polja iz Switch.GetStatus (sam ali kot drugi element batcha)
+ *
+ * Sam:    {"id":0,"output":true,"apower":12.3,"temperature":{"tC":41.2},...}
+ * Batch:  [{"id":1,"result":{"was_on":false}},{"id":2,"result":{...kot zgoraj...}}]
+ */
+static void rpc_status_value_cb(const shelly_json_t *parser, shelly_json_type_t type,
+                                const char *value, void *ctx)
+{
+    rpc_status_ctx_t *rpc = (rpc_status_ctx_t *)ctx;
+    
+    if (shelly_json_match(parser, "error.code", NULL)) {
+        rpc->rpc_error = true;
+        rpc->top_error = true;
+        return;
+    }
+    if (shelly_json_match(parser, "[].error.code", NULL)) {
+        rpc->rpc_error = true;
+        return;
+    }
+    
+    if (type == SHELLY_JSON_TRUE || type == SHELLY_JSON_FALSE) {
+        if (shelly_json_match(parser, "output", NULL) ||
+            shelly_json_match(parser, "[].result.output", NULL)) {
+            bool on = (type == SHELLY_JSON_TRUE);
+            if (rpc->channel == 0) {
+                rpc->status->output_0 = on;
+            } else {
+                rpc->status->output_1 = on;
             }
+            rpc->has_output = true;
         }
+    } else if (type == SHELLY_JSON_NUMBER) {
+        float v = strtof(value, NULL);
         
-        // Extract power values
-        const char *meters_pos = strstr(response_buffer, "\"meters\":[{");
-        if (meters_pos) {
-            status->power_0 = extract_float_value(meters_pos, "power");
-            
-            const char *meter1_pos = strstr(meters_pos, "},{");
-            if (meter1_pos) {
-                status->power_1 = extract_float_value(meter1_pos, "power");
+        if (shelly_json_match(parser, "apower", NULL) ||
+            shelly_json_match(parser, "[].result.apower", NULL)) {
+            if (rpc->channel == 0) {
+                rpc->status->power_0 = v;
+            } else {
+                rpc->status->power_1 = v;
             }
+        } else if (shelly_json_match(parser, "temperature.tC", NULL) ||
+                   shelly_json_match(parser, "[].result.temperature.tC", NULL)) {
+            rpc->status->temperature = v;
         }
+    }
+}
+
+/**
+ * @brief Izvede RPC zahtevo in preveri Switch status v odgovoru
+ *
+ * @param batch_rejected Če ni NULL: true, ko je naprava zavrnila sam batch
+ *                       (HTTP 400/404 ali en error objekt namesto polja).
+ *                       Timeout, prekinjena povezava ali napaka enega klica
+ *                       v batchu niso zavrnitev.
+ */
+static esp_err_t rpc_status_request(const char *path, const char *post_body,
+                                    uint8_t channel, shelly_status_t *status,
+                                    bool *batch_rejected)
+{
+    rpc_status_ctx_t rpc = {
+        .status = status,
+        .channel = channel,
+    };
+    
+    shelly_json_t parser;
+    shelly_json_init(&parser, rpc_status_value_cb, &rpc);
+    
+    int http_status = 0;
+    esp_err_t err = session_request(path, post_body, &parser, &http_status);
+    if (err == ESP_OK && (!shelly_json_done(&parser) || rpc.rpc_error || !rpc.has_output)) {
+        err = ESP_ERR_INVALID_RESPONSE;
+    }
+    
+    if (batch_rejected) {
+        *batch_rejected = (http_status == 400 || http_status == 404) ||
+                          (http_status == 200 && shelly_json_done(&parser) && rpc.top_error);
+    }
+    
+    if (err != ESP_OK) {
+        memset(status, 0, sizeof(shelly_status_t));
+        return err;
+    }
+    
+    status->online = true;
+    return ESP_OK;
+}
+
+esp_err_t shelly_manager_get_channel_status(uint8_t channel, shelly_status_t *status)
+{
+    if (status == NULL || channel > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (shelly_manager_get_api() != SHELLY_API_RPC) {
+        return shelly_manager_get_status(status);
+    }
+    
+    memset(status, 0, sizeof(shelly_status_t));
+    
+    char path[48];
+    snprintf(path, sizeof(path), "/rpc/Switch.GetStatus?id=%d", channel);
+    
+    esp_err_t err = rpc_status_request(path, NULL, channel, status, NULL);
+    if (err != ESP_OK) {
+        ESP_LOGE(TAG, "Switch.GetStatus failed: %s", esp_err_to_name(err));
+        return err;
+    }
+    
+    ESP_LOGD(TAG, "Switch %d: %s, %.1fW", channel,
+             (channel == 0 ? status->output_0 : status->output_1) ? "ON" : "OFF",
+             channel == 0 ? status->power_0 : status->power_1);
+    return ESP_OK;
+}
+
+esp_err_t shelly_manager_set_relay_and_status(uint8_t channel, bool on, shelly_status_t *status)
+{
+    if (status == NULL || channel > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    memset(status, 0, sizeof(shelly_status_t));
+    
+    if (s_session.lock == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    // Odločitev pod lockom; session_request ga vzame sam, zato ga ne držimo čez klic
+    xSemaphoreTake(s_session.lock, portMAX_DELAY);
+    bool use_batch = false;
+    if (s_api == SHELLY_API_RPC) {
+        if (!s_batch_supported && esp_timer_get_time() >= s_batch_retry_us) {
+            s_batch_supported = true;
+            ESP_LOGI(TAG, "Retrying JSON-RPC batch");
+        }
+        use_batch = s_batch_supported;
+    }
+    xSemaphoreGive(s_session.lock);
+    
+    if (use_batch) {
+        // En round trip: Switch.Set + Switch.GetStatus v enem JSON-RPC batchu
+        char body[192];
+        snprintf(body, sizeof(body),
+                 "[{\"id\":1,\"method\":\"Switch.Set\",\"params\":{\"id\":%d,\"on\":%s}},"
+                 "{\"id\":2,\"method\":\"Switch.GetStatus\",\"params\":{\"id\":%d}}]",
+                 channel, on ? "true" : "false", channel);
         
-        // Extract temperature
-        status->temperature = extract_float_value(response_buffer, "tC");
+        ESP_LOGI(TAG, "Setting relay %d to %s (batch)", channel, on ? "ON" : "OFF");
         
-        status->online = true;
+        bool rejected = false;
+        esp_err_t err = rpc_status_request("/rpc", body, channel, status, &rejected);
+        if (!rejected) {
+            // Uspeh ali prehodna napaka (timeout, WiFi) - batch ostane vklopljen
+            return err;
+        }
         
-        ESP_LOGI(TAG, "Status: Relay0=%s, Relay1=%s, Power0=%.1fW, Power1=%.1fW, Temp=%.1f°C",
-                 status->output_0 ? "ON" : "OFF",
-                 status->output_1 ? "ON" : "OFF",
-                 status->power_0,
-                 status->power_1,
-                 status->temperature);
-    } else {
-        ESP_LOGE(TAG, "Failed to read response");
-        status->online = false;
-        err = ESP_FAIL;
+        // Naprava batcha ne podpira → posamični klici, čez čas poskusi znova
+        ESP_LOGW(TAG, "JSON-RPC batch rejected, falling back to single calls");
+        xSemaphoreTake(s_session.lock, portMAX_DELAY);
+        s_batch_supported = false;
+        s_batch_retry_us = esp_timer_get_time() + (int64_t)SHELLY_BATCH_RETRY_MS * 1000;
+        xSemaphoreGive(s_session.lock);
     }
     
-    esp_http_client_close(client);
-    esp_http_client_cleanup(client);
+    esp_err_t err = shelly_manager_set_relay(channel, on);
+    if (err != ESP_OK) {
+        return err;
+    }
     
-    return err;
-}
\ No newline at end of file
+    return shelly_manager_get_channel_status(channel, status);
+}
+
+void shelly_manager_set_api(shelly_api_t api)
+{
+    if (s_session.lock) {
+        xSemaphoreTake(s_session.lock, portMAX_DELAY);
+    }
+    s_api = api;
+    s_batch_supported = true;
+    if (s_session.lock) {
+        xSemaphoreGive(s_session.lock);
+    }
+    ESP_LOGI(TAG, "Shelly API: %s", api == SHELLY_API_RPC ? "Gen2+ RPC" : "Gen1 HTTP");
+}
+
+shelly_api_t shelly_manager_get_api(void)
+{
+    if (s_session.lock == NULL) {
+        return s_api;
+    }
+    
+    xSemaphoreTake(s_session.lock, portMAX_DELAY);
+    shelly_api_t api = s_api;
+    xSemaphoreGive(s_session.lock);
+    return api;
+}
+
+void shelly_manager_get_session_stats(shelly_session_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    
+    if (s_session.lock) {
+        xSemaphoreTake(s_session.lock, portMAX_DELAY);
+    }
+    *stats = s_session.stats;
+    if (s_session.lock) {
+        xSemaphoreGive(s_session.lock);
+    }
+}
+
+esp_err_t shelly_manager_post(const shelly_cmd_t *cmd)
+{
+    if (cmd == NULL || cmd->channel > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    
+    if (s_cmd_queue == NULL) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    
+    shelly_queued_cmd_t item = {
+        .cmd = *cmd,
+        .enqueued_us = esp_timer_get_time(),
+    };
+    
+    // Nikoli ne čakamo - klicatelj (sensor task) mora takoj nadaljevati
+    if (xQueueSend(s_cmd_queue, &item, 0) != pdTRUE) {
+        portENTER_CRITICAL(&s_stats_mux);
+        s_queue_stats.dropped++;
+        portEXIT_CRITICAL(&s_stats_mux);
+        ESP_LOGW(TAG, "Command queue full, dropping command %d", cmd->type);
+        return ESP_ERR_TIMEOUT;
+    }
+    
+    uint32_t depth = (uint32_t)uxQueueMessagesWaiting(s_cmd_queue);
+    
+    portENTER_CRITICAL(&s_stats_mux);
+    s_queue_stats.posted++;
+    if (depth > s_queue_stats.max_depth) {
+        s_queue_stats.max_depth = depth;
+    }
+    portEXIT_CRITICAL(&s_stats_mux);
+    
+    return ESP_OK;
+}
+
+void shelly_manager_register_result_callback(shelly_result_callback_t callback)
+{
+    s_result_callback = callback;
+}
+
+void shelly_manager_get_queue_stats(shelly_queue_stats_t *stats)
+{
+    if (stats == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_stats_mux);
+    *stats = s_queue_stats;
+    portEXIT_CRITICAL(&s_stats_mux);
+    
+    stats->depth = s_cmd_queue ? (uint32_t)uxQueueMessagesWaiting(s_cmd_queue) : 0;
+}
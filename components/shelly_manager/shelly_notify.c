@@ -0,0 +1,262 @@
+/**
+ * @file shelly_notify.c
+ * @brief Gen2+ WebSocket RPC kanal za NotifyStatus obvestila
+ *
+ * Shelly Gen2+ na ws://<ip>/rpc pošilja NotifyStatus vsakič, ko se spremeni
+ * stanje releja ali poraba. Obvestila začne pošiljati, ko na povezavi
+ * prejme vsaj eno zahtevo z "src" poljem - zato ob povezavi pošljemo
+ * Shelly.GetStatus, ki hkrati služi kot začetna sinhronizacija.
+ */
+#include "shelly_manager.h"
+#include "shelly_notify.h"
+#include "shelly_json.h"
+#include "esp_websocket_client.h"
+#include "esp_log.h"
+#include <string.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+static const char *TAG = "shelly_notify";
+
+#define NOTIFY_RECONNECT_MS     5000
+#define NOTIFY_NETWORK_TIMEOUT  5000
+#define NOTIFY_TASK_STACK       4096
+#define NOTIFY_SRC              "tbox3"
+
+#define WS_OP_CONTINUATION      0x00
+#define WS_OP_TEXT              0x01
+
+/**
+ * @brief Zbrana polja enega sporočila (po kanalih)
+ */
+typedef struct {
+    shelly_notify_t events[2];
+} notify_msg_ctx_t;
+
+static esp_websocket_client_handle_t s_ws = NULL;
+static shelly_notify_callback_t s_notify_callback = NULL;
+static volatile bool s_connected = false;
+static shelly_json_t s_parser;             // Sporočilo lahko pride v več fragmentih
+static bool s_msg_open = false;            // Tekstovno sporočilo se je začelo, FIN še ni prišel
+static notify_msg_ctx_t s_msg;
+static uint32_t s_msg_id = 0;
+
+/**
+ * @brief Iz poti "params.switch:N.<field>" ali "result.switch:N.<field>" dobi kanal
+ */
+static int match_switch_field(const shelly_json_t *parser, const char *field)
+{
+    static const char *const prefixes[] = { "params", "result" };
+    char pattern[48];
+    
+    for (size_t p = 0; p < sizeof(prefixes) / sizeof(prefixes[0]); p++) {
+        for (int ch = 0; ch < 2; ch++) {
+            snprintf(pattern, sizeof(pattern), "%s.switch:%d.%s", prefixes[p], ch, field);
+            if (shelly_json_match(parser, pattern, NULL)) {
+                return ch;
+            }
+        }
+    }
+    return -1;
+}
+
+static void notify_value_cb(const shelly_json_t *parser, shelly_json_type_t type,
+                            const char *value, void *ctx)
+{
+    notify_msg_ctx_t *msg = (notify_msg_ctx_t *)ctx;
+    int ch;
+    
+    if (type == SHELLY_JSON_TRUE || type == SHELLY_JSON_FALSE) {
+        ch = match_switch_field(parser, "output");
+        if (ch >= 0) {
+            msg->events[ch].has_output = true;
+            msg->events[ch].output = (type == SHELLY_JSON_TRUE);
+        }
+    } else if (type == SHELLY_JSON_NUMBER) {
+        ch = match_switch_field(parser, "apower");
+        if (ch >= 0) {
+            msg->events[ch].has_power = true;
+            msg->events[ch].power = strtof(value, NULL);
+        }
+    }
+}
+
+static void dispatch_message(void)
+{
+    if (!shelly_json_done(&s_parser)) {
+        ESP_LOGW(TAG, "Malformed notification (%lu bytes)", (unsigned long)s_parser.bytes);
+        return;
+    }
+    
+    for (uint8_t ch = 0; ch < 2; ch++) {
+        shelly_notify_t *ev = &s_msg.events[ch];
+        if (!ev->has_output && !ev->has_power) {
+            continue;
+        }
+        
+        ev->channel = ch;
+        ESP_LOGD(TAG, "Switch %d: output=%s, power=%.1fW", ch,
+                 ev->has_output ? (ev->output ? "ON" : "OFF") : "-",
+                 ev->has_power ? ev->power : 0.0f);
+        
+        if (s_notify_callback) {
+            s_notify_callback(ev);
+        }
+    }
+}
+
+static void ws_event_handler(void *arg, esp_event_base_t base, int32_t event_id, void *event_data)
+{
+    esp_websocket_event_data_t *data = (esp_websocket_event_data_t *)event_data;
+    
+    switch (event_id) {
+        case WEBSOCKET_EVENT_CONNECTED: {
+            ESP_LOGI(TAG, "Notification channel connected");
+            s_connected = true;
+            
+            // Zahteva s "src" vklopi obvestila in vrne začetno stanje
+            char req[96];
+            int len = snprintf(req, sizeof(req),
+                               "{\"id\":%lu,\"src\":\"" NOTIFY_SRC "\",\"method\":\"Shelly.GetStatus\"}",
+                               (unsigned long)++s_msg_id);
+            esp_websocket_client_send_text(s_ws, req, len, pdMS_TO_TICKS(NOTIFY_NETWORK_TIMEOUT));
+            break;
+        }
+            
+        case WEBSOCKET_EVENT_DISCONNECTED:
+        case WEBSOCKET_EVENT_CLOSED:
+            if (s_connected) {
+                ESP_LOGW(TAG, "Notification channel lost, falling back to polling");
+            }
+            s_connected = false;
+            s_msg_open = false;
+            break;
+            
+        case WEBSOCKET_EVENT_DATA:
+            // Okvir pride v kosih (payload_offset), sporočilo pa je lahko
+            // razdeljeno na več okvirjev: TEXT, CONTINUATION..., zadnji s FIN
+            if (data->op_code == WS_OP_TEXT && data->payload_offset == 0) {
+                memset(&s_msg, 0, sizeof(s_msg));
+                shelly_json_init(&s_parser, notify_value_cb, &s_msg);
+                s_msg_open = true;
+            } else if (data->op_code == WS_OP_CONTINUATION) {
+                if (!s_msg_open) {
+                    break;      // Nadaljevanje brez začetka (npr. po reconnectu)
+                }
+            } else if (data->op_code != WS_OP_TEXT) {
+                break;          // Binary, ping, pong, close
+            }
+            
+            shelly_json_feed(&s_parser, data->data_ptr, data->data_len);
+            if (data->fin && data->payload_offset + data->data_len >= data->payload_len) {
+                s_msg_open = false;
+                dispatch_message();
+            }
+            break;
+            
+        case WEBSOCKET_EVENT_ERROR:
+            ESP_LOGW(TAG, "Notification channel error");
+            break;
+            
+        default:
+            break;
+    }
+}
+
+static void build_uri(char *uri, size_t len)
+{
+    char ip[32];
+    shelly_manager_get_ip(ip, sizeof(ip));
+    snprintf(uri, len, "ws://%s/rpc", ip);
+}
+
+esp_err_t shelly_manager_notify_start(void)
+{
+    if (s_ws != NULL) {
+        return ESP_OK;
+    }
+    
+    if (shelly_manager_get_api() != SHELLY_API_RPC) {
+        ESP_LOGW(TAG, "Notifications require the Gen2+ RPC API");
+        return ESP_ERR_NOT_SUPPORTED;
+    }
+    
+    char uri[64];
+    build_uri(uri, sizeof(uri));
+    
+    esp_websocket_client_config_t config = {
+        .uri = uri,
+        .reconnect_timeout_ms = NOTIFY_RECONNECT_MS,
+        .network_timeout_ms = NOTIFY_NETWORK_TIMEOUT,
+        .task_stack = NOTIFY_TASK_STACK,
+    };
+    
+    s_ws = esp_websocket_client_init(&config);
+    if (s_ws == NULL) {
+        ESP_LOGE(TAG, "Failed to create WebSocket client");
+        return ESP_ERR_NO_MEM;
+    }
+    
+    esp_websocket_register_events(s_ws, WEBSOCKET_EVENT_ANY, ws_event_handler, NULL);
+    
+    esp_err_t ret = esp_websocket_client_start(s_ws);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to start WebSocket client: %s", esp_err_to_name(ret));
+        esp_websocket_client_destroy(s_ws);
+        s_ws = NULL;
+        return ret;
+    }
+    
+    ESP_LOGI(TAG, "Notification channel started: %s", uri);
+    return ESP_OK;
+}
+
+void shelly_manager_notify_stop(void)
+{
+    if (s_ws == NULL) {
+        return;
+    }
+    
+    esp_websocket_client_stop(s_ws);
+    esp_websocket_client_destroy(s_ws);
+    s_ws = NULL;
+    s_connected = false;
+}
+
+void shelly_notify_ip_changed(void)
+{
+    if (s_ws == NULL) {
+        return;
+    }
+    
+    char uri[64];
+    build_uri(uri, sizeof(uri));
+    
+    // Stara povezava bi se sicer v nedogled povezovala na prejšnji naslov
+    esp_websocket_client_stop(s_ws);
+    s_connected = false;
+    s_msg_open = false;
+    
+    esp_err_t ret = esp_websocket_client_set_uri(s_ws, uri);
+    if (ret == ESP_OK) {
+        ret = esp_websocket_client_start(s_ws);
+    }
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Failed to restart WebSocket client: %s", esp_err_to_name(ret));
+        esp_websocket_client_destroy(s_ws);
+        s_ws = NULL;
+        return;
+    }
+    
+    ESP_LOGI(TAG, "Notification channel restarted: %s", uri);
+}
+
+bool shelly_manager_notify_connected(void)
+{
+    return s_connected;
+}
+
+void shelly_manager_register_notify_callback(shelly_notify_callback_t callback)
+{
+    s_notify_callback = callback;
+}
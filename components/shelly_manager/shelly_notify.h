@@ -0,0 +1,15 @@
+/**
+ * @file shelly_notify.h
+ * @brief Interni vmesnik med shelly_manager.c in WebSocket kanalom
+ */
+#ifndef SHELLY_NOTIFY_H
+#define SHELLY_NOTIFY_H
+
+/**
+ * @brief IP naprave se je spremenil - zagnan kanal se poveže na novi naslov
+ *
+ * Če kanal ni zagnan, ne naredi nič. Ne kliči iz WebSocket taska.
+ */
+void shelly_notify_ip_changed(void);
+
+#endif // SHELLY_NOTIFY_H
@@ -0,0 +1,195 @@
+# Generira subset fonte za UI (lv_font_conv)
+#
+# Klic (iz ui_manager/CMakeLists.txt):
+#   cmake -DLV_FONT_CONV=<pot> -DFONT_DIR=<lvgl>/scripts/built_in_font
+#         -DOUT_DIR=<build> -DDIGITS_IN_RAM=<ON|OFF>
+#         -DTEXT_SOURCES=<a.c|b.c> -DTEXT_CALLERS=<main.c|thermostat_loop.c> -P gen_fonts.cmake
+#
+# Vsak font vsebuje samo znake, ki jih UI dejansko izpiše, in FontAwesome
+# ikone namesto emoji (ki jih Montserrat nima).
+
+cmake_policy(SET CMP0007 NEW)   # Prazne vrstice ostanejo v seznamu
+
+set(TEXT_FONT "${FONT_DIR}/Montserrat-Medium.ttf")
+set(ICON_FONT "${FONT_DIR}/FontAwesome5-Solid+Brands+Regular.woff")
+
+# ════════════════════════════════════════════
+# TEXT_RANGE iz string literalov v izvorni kodi
+# ════════════════════════════════════════════
+#
+# TEXT_SOURCES: UI datoteke - upoštevajo se vsi literali razen logov.
+# TEXT_CALLERS: klicatelji UI API-ja - samo vrstice s klicem ui_manager_*()
+#               ali prireditvijo "<ime>_text = " (npr. status_text = "HEATING").
+# \x.. escape-i so ikone (ICON_RANGE), numerične printf pretvorbe dodajo
+# števke, predznak in piko. Odvečni znaki samo povečajo font, manjkajoči
+# pa bi se izrisali kot prazno - zato je filter raje širši.
+
+function(collect_literals out_var file line_filter)
+    file(READ ${file} content)
+    # ; in [ ] bi pokvarili CMake seznam vrstic
+    string(REPLACE ";" "<SC>" content "${content}")
+    string(REPLACE "[" "<LB>" content "${content}")
+    string(REPLACE "]" "<RB>" content "${content}")
+    string(REPLACE "\n" ";" lines "${content}")
+
+    set(file_literals "")
+    foreach(line IN LISTS lines)
+        if(line MATCHES "ESP_LOG|#include|^[ \t]*(/\\*|\\*)|TAG = ")
+            continue()
+        endif()
+        # // komentar za kodo (// znotraj literala ostane)
+        string(REGEX REPLACE "^(([^\"/]|\"([^\"\\\\]|\\\\.)*\"|/[^/\"])*)//.*$" "\\1" line "${line}")
+        if(line_filter AND NOT line MATCHES "${line_filter}")
+            continue()
+        endif()
+        string(REGEX MATCHALL "\"([^\"\\\\]|\\\\.)*\"" found "${line}")
+        list(APPEND file_literals ${found})
+    endforeach()
+    set(${out_var} ${${out_var}} ${file_literals} PARENT_SCOPE)
+endfunction()
+
+function(utf8_codepoints out_var text)
+    string(HEX "${text}" hex)
+    string(LENGTH "${hex}" n)
+    set(cps "")
+    set(i 0)
+    while(i LESS n)
+        string(SUBSTRING "${hex}" ${i} 2 b)
+        math(EXPR c "0x${b}")
+        if(c LESS 128)
+            set(len 1)
+            set(cp ${c})
+        elseif(c GREATER_EQUAL 240)
+            set(len 4)
+            math(EXPR cp "${c} & 0x07")
+        elseif(c GREATER_EQUAL 224)
+            set(len 3)
+            math(EXPR cp "${c} & 0x0F")
+        else()
+            set(len 2)
+            math(EXPR cp "${c} & 0x1F")
+        endif()
+        foreach(k RANGE 1 ${len})
+            if(k EQUAL len)
+                break()
+            endif()
+            math(EXPR pos "${i} + 2 * ${k}")
+            string(SUBSTRING "${hex}" ${pos} 2 b)
+            math(EXPR cp "(${cp} << 6) | (0x${b} & 0x3F)")
+        endforeach()
+        list(APPEND cps ${cp})
+        math(EXPR i "${i} + 2 * ${len}")
+    endwhile()
+    set(${out_var} ${cps} PARENT_SCOPE)
+endfunction()
+
+function(text_range_from_sources out_var)
+    set(literals "")
+    string(REPLACE "|" ";" sources "${TEXT_SOURCES}")
+    string(REPLACE "|" ";" callers "${TEXT_CALLERS}")
+    foreach(src IN LISTS sources)
+        collect_literals(literals ${src} "")
+    endforeach()
+    foreach(src IN LISTS callers)
+        collect_literals(literals ${src} "ui_manager_[a-z_]+\\(|_text = ")
+    endforeach()
+
+    set(cps 32)     # Presledek vedno (ločilo ikona/tekst)
+    set(numeric OFF)
+    foreach(lit IN LISTS literals)
+        string(REGEX REPLACE "^\"(.*)\"$" "\\1" text "${lit}")
+        string(REPLACE "<SC>" ";" text "${text}")
+        string(REPLACE "<LB>" "[" text "${text}")
+        string(REPLACE "<RB>" "]" text "${text}")
+        string(REGEX REPLACE "\\\\x[0-9A-Fa-f][0-9A-Fa-f]" "" text "${text}")
+        string(REGEX REPLACE "\\\\[nrt]" "" text "${text}")
+        string(REGEX REPLACE "\\\\(.)" "\\1" text "${text}")
+        string(REPLACE "%%" "<PCT>" text "${text}")
+        if(text MATCHES "%[-+ 0#]*[0-9]*(\\.[0-9]+)?(hh|h|ll|l|z)?[diuxXfFeEgG]")
+            set(numeric ON)
+        endif()
+        string(REGEX REPLACE "%[-+ 0#]*[0-9]*(\\.[0-9]+)?(hh|h|ll|l|z)?[diuxXfFeEgGcsp]" "" text "${text}")
+        string(REPLACE "<PCT>" "%" text "${text}")
+        if(NOT text STREQUAL "")
+            utf8_codepoints(lit_cps "${text}")
+            list(APPEND cps ${lit_cps})
+        endif()
+    endforeach()
+    if(numeric)
+        list(APPEND cps 45 46 48 49 50 51 52 53 54 55 56 57)
+    endif()
+
+    list(REMOVE_DUPLICATES cps)
+    list(SORT cps COMPARE NATURAL)
+
+    # Zaporedne znake združi v intervale (0x30-0x39)
+    set(ranges "")
+    set(start "")
+    set(prev "")
+    foreach(cp IN LISTS cps ITEMS -1)
+        if(NOT start STREQUAL "")
+            math(EXPR next "${prev} + 1")
+            if(cp EQUAL next)
+                set(prev ${cp})
+                continue()
+            endif()
+            math(EXPR a "${start}" OUTPUT_FORMAT HEXADECIMAL)
+            math(EXPR b "${prev}" OUTPUT_FORMAT HEXADECIMAL)
+            if(start EQUAL prev)
+                list(APPEND ranges ${a})
+            else()
+                list(APPEND ranges "${a}-${b}")
+            endif()
+        endif()
+        set(start ${cp})
+        set(prev ${cp})
+    endforeach()
+    list(LENGTH cps count)
+    string(REPLACE ";" "," ranges "${ranges}")
+    message(STATUS "UI text glyphs: ${count} (${ranges})")
+    set(${out_var} "${ranges}" PARENT_SCOPE)
+endfunction()
+
+text_range_from_sources(TEXT_RANGE)
+if(TEXT_RANGE STREQUAL "")
+    message(FATAL_ERROR "No UI strings found in TEXT_SOURCES='${TEXT_SOURCES}'")
+endif()
+# wifi, fire, tint, snowflake, warning, bolt, bullseye, xmark
+set(ICON_RANGE "0xF1EB,0xF06D,0xF043,0xF2DC,0xF071,0xF0E7,0xF140,0xF00D")
+# Velika temperatura: števke, predznak, pika, °C in "SENSOR"/"ERROR"
+set(DIGIT_RANGE "0x20,0x2D,0x2E,0x30-0x39,0xB0,0x43,0x45,0x4E,0x4F,0x52,0x53")
+
+function(gen_font name size text_range with_icons)
+    set(args --bpp 4 --size ${size} --no-compress --format lvgl
+             --lv-include lvgl.h --lv-font-name ${name}
+             --font ${TEXT_FONT} --range ${text_range})
+    if(with_icons)
+        list(APPEND args --font ${ICON_FONT} --range ${ICON_RANGE})
+    endif()
+
+    execute_process(COMMAND ${LV_FONT_CONV} ${args} -o ${OUT_DIR}/${name}.c
+                    RESULT_VARIABLE ret)
+    if(NOT ret EQUAL 0)
+        message(FATAL_ERROR "lv_font_conv failed for ${name}")
+    endif()
+endfunction()
+
+gen_font(ui_font_12 12 ${TEXT_RANGE} ON)
+gen_font(ui_font_14 14 ${TEXT_RANGE} ON)
+gen_font(ui_font_16 16 ${TEXT_RANGE} ON)
+gen_font(ui_font_20 20 ${TEXT_RANGE} ON)
+gen_font(ui_font_32 32 "0x2B,0x2D" OFF)
+gen_font(ui_font_48 48 ${DIGIT_RANGE} OFF)
+
+if(DIGITS_IN_RAM)
+    # Bitmape velikih števk v internal RAM - izris vsake 2 s ne bere flash-a
+    set(bitmap_decl "LV_ATTRIBUTE_LARGE_CONST const uint8_t glyph_bitmap")
+    file(READ ${OUT_DIR}/ui_font_48.c src)
+    string(FIND "${src}" "${bitmap_decl}" pos)
+    if(pos EQUAL -1)
+        # Nova verzija lv_font_conv - brez tega bi bitmap tiho ostal v flash-u
+        message(FATAL_ERROR "ui_font_48.c: '${bitmap_decl}' not found, cannot move bitmap to RAM")
+    endif()
+    string(REPLACE "${bitmap_decl}" "DRAM_ATTR const uint8_t glyph_bitmap" src "${src}")
+    file(WRITE ${OUT_DIR}/ui_font_48.c "#include \"esp_attr.h\"\n${src}")
+endif()
@@ -9,8 +9,30 @@
 #include <stdint.h>
 #include <stdbool.h>
 
+/**
+ * @brief Statistika posodobitev UI (dirty-checking)
+ */
+typedef struct {
+    uint32_t requested;     // Vsi klici ui_manager_update_* / set_*
+    uint32_t skipped;       // Klici brez spremembe (brez redraw)
+    uint32_t applied;       // Dejanski lv_label_set_text / set_style klici
+    uint32_t flushes;       // Flush cikli z vsaj eno spremembo
+    uint32_t last_flush_us; // CPU čas zadnjega flush cikla
+    uint32_t max_flush_us;  // Najdaljši flush cikel
+} ui_update_stats_t;
+
+/**
+ * @brief Callback ob pritisku +/- gumba (kliče LVGL task)
+ * @param steps +1 ali -1
+ */
+typedef void (*ui_target_callback_t)(int steps);
+
 /**
  * @brief Inicializira UI manager (kreira screen elemente)
+ *
+ * Update funkcije ne jemljejo display locka - vrednosti se zapišejo v
+ * view-model, LVGL timer pa spremenjene widgete posodobi v enem prehodu.
+ *
  * @return ESP_OK če uspešno
  */
 esp_err_t ui_manager_init(void);
@@ -51,9 +73,9 @@ void ui_manager_set_target_temperature(float target_temp);
  * @brief Posodobi WiFi status
  * @param connected Ali je WiFi povezan
  * @param ip_address IP naslov (NULL če ni povezan)
- * @param rssi Signal strength v dBm
+ * @param bars Moč signala 0-4 (histereza je v wifi_manager)
  */
-void ui_manager_update_wifi_status(bool connected, const char *ip_address, int8_t rssi);
+void ui_manager_update_wifi_status(bool connected, const char *ip_address, uint8_t bars);
 
 /**
  * @brief Posodobi Shelly power monitoring
@@ -62,4 +84,26 @@ void ui_manager_update_wifi_status(bool connected, const char *ip_address, int8_
  */
 void ui_manager_update_power(float power_w, bool online);
 
+/**
+ * @brief Nastavi periodo prenosa sprememb na display
+ * @param period_ms Perioda v ms (privzeto 100 ms)
+ */
+void ui_manager_set_flush_period(uint32_t period_ms);
+
+/**
+ * @brief Vrne statistiko posodobitev UI
+ * @param stats Output struktura
+ */
+void ui_manager_get_update_stats(ui_update_stats_t *stats);
+
+/**
+ * @brief Registriraj callback za +/- gumba
+ * 
+ * Klic se zgodi ob pritisku in ob vsakem long-press ponovitvi. Če
+ * callback nastavi novo target vrednost, je ta prikazana v istem frame-u.
+ * 
+ * @param callback Funkcija ali NULL
+ */
+void ui_manager_register_target_callback(ui_target_callback_t callback);
+
 #endif // UI_MANAGER_H
\ No newline at end of file
@@ -3,15 +3,23 @@
  * @brief UI Manager implementation
  */
 #include "ui_manager.h"
+#include "ui_trend.h"
 #include "display_manager.h"
+#include "config.h"
 #include "bsp/esp-bsp.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_heap_caps.h"
+#include "freertos/FreeRTOS.h"
 #include <stdio.h>
 #include <string.h>
 
 
 static const char *TAG = "ui_mgr";
 
+#define UI_TEXT_LEN                 48
+#define UI_DEFAULT_FLUSH_PERIOD_MS  100
+
 // File-scope spremenljivke - UI elementi
 static lv_obj_t *temp_label = NULL;
 static lv_obj_t *hum_label = NULL;
@@ -20,31 +28,551 @@ static lv_obj_t *furnace_status_label = NULL;
 static lv_obj_t *wifi_status_label = NULL;
 static lv_obj_t *power_label = NULL;
 
+#define UI_WIFI_BARS    4
+static lv_obj_t *s_wifi_bars[UI_WIFI_BARS];
+
 //==============NOVO=================
 
 static lv_obj_t *btn_minus = NULL;
 static lv_obj_t *btn_plus = NULL;
 
-//Dodaj button callback funkcije:
+// Trend graf (drugi screen, swipe levo/desno)
+static lv_obj_t *s_main_screen = NULL;
+static lv_obj_t *s_chart_screen = NULL;
+static lv_obj_t *s_chart = NULL;
+static lv_chart_series_t *s_ser_temp_min = NULL;
+static lv_chart_series_t *s_ser_temp_avg = NULL;
+static lv_chart_series_t *s_ser_temp_max = NULL;
+static lv_chart_series_t *s_ser_target = NULL;
+static lv_chart_series_t *s_ser_power = NULL;
+static int32_t s_power_axis_max = 100;              // W, raste po potrebi
+
+static ui_trend_t s_trend;
+static portMUX_TYPE s_trend_mux = portMUX_INITIALIZER_UNLOCKED;
+
+static ui_target_callback_t s_target_callback = NULL;
+
+//====================================================================
+// Deljeni stili: ustvarijo se enkrat ob init, widgeti jih samo zamenjujejo.
+// Lokalne lv_obj_set_style_* lastnosti bi vsakič alocirale style list.
+
+typedef enum {
+    UI_STYLE_NEUTRAL = 0,
+    UI_STYLE_NORMAL,
+    UI_STYLE_ERROR,
+    UI_STYLE_HUMIDITY,
+    UI_STYLE_TARGET,
+    UI_STYLE_POWER,
+    UI_STYLE_HEATING,
+    UI_STYLE_OFF,
+    UI_STYLE_WARNING,
+    UI_STYLE_WIFI_OK,
+    UI_STYLE_WIFI_DOWN,
+    UI_STYLE_CUSTOM,            // Barva, ki je ni v tabeli (samo furnace status)
+    UI_STYLE_COUNT
+} ui_text_style_t;
+
+static const uint32_t s_style_colors[UI_STYLE_CUSTOM] = {
+    [UI_STYLE_NEUTRAL]   = COLOR_TEXT,
+    [UI_STYLE_NORMAL]    = COLOR_TEMP_NORMAL,
+    [UI_STYLE_ERROR]     = COLOR_TEMP_ERROR,
+    [UI_STYLE_HUMIDITY]  = COLOR_HUMIDITY,
+    [UI_STYLE_TARGET]    = COLOR_TARGET_TEMP,
+    [UI_STYLE_POWER]     = COLOR_POWER,
+    [UI_STYLE_HEATING]   = COLOR_FURNACE_HEATING,
+    [UI_STYLE_OFF]       = COLOR_FURNACE_OFF,
+    [UI_STYLE_WARNING]   = COLOR_FURNACE_ERROR,
+    [UI_STYLE_WIFI_OK]   = COLOR_WIFI_CONNECTED,
+    [UI_STYLE_WIFI_DOWN] = COLOR_WIFI_DISCONNECTED,
+};
+
+typedef enum {
+    UI_FONT_12 = 0,
+    UI_FONT_14,
+    UI_FONT_16,
+    UI_FONT_20,
+    UI_FONT_32,
+    UI_FONT_48,
+    UI_FONT_COUNT
+} ui_font_style_t;
 
+#if CONFIG_THERMOSTAT_SUBSET_FONTS
+// Subset fonti (fonts/gen_fonts.cmake) - samo uporabljeni znaki + FontAwesome ikone
+LV_FONT_DECLARE(ui_font_12);
+LV_FONT_DECLARE(ui_font_14);
+LV_FONT_DECLARE(ui_font_16);
+LV_FONT_DECLARE(ui_font_20);
+LV_FONT_DECLARE(ui_font_32);
+LV_FONT_DECLARE(ui_font_48);
 
+static const lv_font_t *const s_style_fonts[UI_FONT_COUNT] = {
+    [UI_FONT_12] = &ui_font_12,
+    [UI_FONT_14] = &ui_font_14,
+    [UI_FONT_16] = &ui_font_16,
+    [UI_FONT_20] = &ui_font_20,
+    [UI_FONT_32] = &ui_font_32,
+    [UI_FONT_48] = &ui_font_48,
+};
 
+#define UI_ICON_WIFI        "\xEF\x87\xAB"   // F1EB wifi
+#define UI_ICON_FIRE        "\xEF\x81\xAD"   // F06D fire
+#define UI_ICON_DROP        "\xEF\x81\x83"   // F043 tint
+#define UI_ICON_SNOW        "\xEF\x8B\x9C"   // F2DC snowflake
+#define UI_ICON_WARNING     "\xEF\x81\xB1"   // F071 warning
+#define UI_ICON_POWER       "\xEF\x83\xA7"   // F0E7 bolt
+#define UI_ICON_TARGET      "\xEF\x85\x80"   // F140 bullseye
+#define UI_ICON_CLOSE       "\xEF\x80\x8D"   // F00D xmark
 
+// Predpone statusov z ikono
+#define UI_PREFIX_FIRE      UI_ICON_FIRE " "
+#define UI_PREFIX_SNOW      UI_ICON_SNOW " "
+#define UI_PREFIX_TARGET    UI_ICON_TARGET " "
+#else
+static const lv_font_t *const s_style_fonts[UI_FONT_COUNT] = {
+    [UI_FONT_12] = &lv_font_montserrat_12,
+    [UI_FONT_14] = &lv_font_montserrat_14,
+    [UI_FONT_16] = &lv_font_montserrat_16,
+    [UI_FONT_20] = &lv_font_montserrat_20,
+    [UI_FONT_32] = &lv_font_montserrat_32,
+    [UI_FONT_48] = &lv_font_montserrat_48,
+};
 
+// Vgrajeni Montserrat fonti imajo samo LV_SYMBOL ikone (emoji niso izrisljivi)
+#define UI_ICON_WIFI        LV_SYMBOL_WIFI
+#define UI_ICON_DROP        LV_SYMBOL_TINT
+#define UI_ICON_WARNING     LV_SYMBOL_WARNING
+#define UI_ICON_POWER       LV_SYMBOL_CHARGE
+#define UI_ICON_CLOSE       LV_SYMBOL_CLOSE
 
+// LV_SYMBOL nima plamena, snežinke ne tarče - raje brez ikone kot z napačno
+#define UI_PREFIX_FIRE      ""
+#define UI_PREFIX_SNOW      ""
+#define UI_PREFIX_TARGET    ""
+#endif
+
+static lv_style_t s_text_styles[UI_STYLE_COUNT];
+static lv_style_t s_font_styles[UI_FONT_COUNT];
+static lv_style_t s_screen_style;
+static lv_style_t s_btn_style;
+static lv_style_t s_btn_pressed_style;
+static lv_style_t s_chart_point_style;
+static lv_style_t s_bar_on_style;
+static lv_style_t s_bar_off_style;
+static lv_style_t s_align_left_style;
+static lv_style_t s_align_center_style;
+static uint32_t s_custom_color = 0;     // Trenutna barva UI_STYLE_CUSTOM (samo LVGL task)
+
+/**
+ * @brief Inicializira tabelo deljenih stilov (enkrat, z display lockom)
+ */
+static void init_styles(void)
+{
+    for (int i = 0; i < UI_STYLE_COUNT; i++) {
+        lv_style_init(&s_text_styles[i]);
+        if (i < UI_STYLE_CUSTOM) {
+            lv_style_set_text_color(&s_text_styles[i], lv_color_hex(s_style_colors[i]));
+        }
+    }
+    
+    for (int i = 0; i < UI_FONT_COUNT; i++) {
+        lv_style_init(&s_font_styles[i]);
+        lv_style_set_text_font(&s_font_styles[i], s_style_fonts[i]);
+    }
+    
+    lv_style_init(&s_screen_style);
+    lv_style_set_bg_color(&s_screen_style, lv_color_hex(COLOR_BACKGROUND));
+    lv_style_set_bg_opa(&s_screen_style, LV_OPA_COVER);
+    
+    lv_style_init(&s_btn_style);
+    lv_style_set_bg_color(&s_btn_style, lv_color_hex(0x404040));
+    
+    lv_style_init(&s_btn_pressed_style);
+    lv_style_set_bg_color(&s_btn_pressed_style, lv_color_hex(0x606060));
+    
+    lv_style_init(&s_bar_on_style);
+    lv_style_set_bg_color(&s_bar_on_style, lv_color_hex(0xFFFFFF));
+    lv_style_set_bg_opa(&s_bar_on_style, LV_OPA_COVER);
+    lv_style_set_border_width(&s_bar_on_style, 0);
+    lv_style_set_radius(&s_bar_on_style, 0);
+    lv_style_set_pad_all(&s_bar_on_style, 0);
+    
+    lv_style_init(&s_bar_off_style);
+    lv_style_set_bg_color(&s_bar_off_style, lv_color_hex(0x406070));
+    lv_style_set_bg_opa(&s_bar_off_style, LV_OPA_COVER);
+    lv_style_set_border_width(&s_bar_off_style, 0);
+    lv_style_set_radius(&s_bar_off_style, 0);
+    lv_style_set_pad_all(&s_bar_off_style, 0);
+    
+    lv_style_init(&s_align_left_style);
+    lv_style_set_text_align(&s_align_left_style, LV_TEXT_ALIGN_LEFT);
+    
+    lv_style_init(&s_align_center_style);
+    lv_style_set_text_align(&s_align_center_style, LV_TEXT_ALIGN_CENTER);
+    
+    // Graf brez pik na točkah - samo črte
+    lv_style_init(&s_chart_point_style);
+    lv_style_set_size(&s_chart_point_style, 0, 0);
+}
 
+/**
+ * @brief Poišče deljeni stil za barvo (preferred ima prednost pri enakih barvah)
+ */
+static ui_text_style_t style_for_color(uint32_t color, ui_text_style_t preferred)
+{
+    if (preferred < UI_STYLE_CUSTOM && s_style_colors[preferred] == color) {
+        return preferred;
+    }
+    
+    for (int i = 0; i < UI_STYLE_CUSTOM; i++) {
+        if (s_style_colors[i] == color) {
+            return (ui_text_style_t)i;
+        }
+    }
+    
+    return UI_STYLE_CUSTOM;
+}
 
 //====================================================================
+// View-model: producer taski samo zapišejo novo vrednost (brez display locka),
+// LVGL timer jo v enem prehodu prenese na widgete - in samo če se je spremenila.
+
+typedef enum {
+    UI_FIELD_WIFI = 0,
+    UI_FIELD_TEMP,
+    UI_FIELD_HUM,
+    UI_FIELD_TARGET,
+    UI_FIELD_FURNACE,
+    UI_FIELD_POWER,
+    UI_FIELD_COUNT
+} ui_field_id_t;
+
+typedef struct {
+    char text[UI_TEXT_LEN];
+    ui_text_style_t style;
+    uint32_t color;             // Samo za UI_STYLE_CUSTOM
+} ui_field_value_t;
+
+typedef struct {
+    lv_obj_t *obj;
+    ui_field_value_t pending;   // Zadnja zahtevana vrednost (producer)
+    ui_field_value_t shown;     // Kar je trenutno na widgetu (samo LVGL task)
+    bool dirty;
+} ui_field_t;
+
+/**
+ * @brief Fiksna širina labela
+ *
+ * Label s širino LV_SIZE_CONTENT ob vsaki spremembi dolžine teksta spremeni
+ * velikost (in pri center align tudi pozicijo), LVGL pa invalidira staro in
+ * novo območje. S fiksno širino je invalidirano vedno isto, najmanjše
+ * območje, ki pokrije najdaljši pričakovan tekst.
+ */
+typedef struct {
+    int32_t width;
+    bool align_left;
+} ui_field_layout_t;
+
+static const ui_field_layout_t s_field_layout[UI_FIELD_COUNT] = {
+    [UI_FIELD_WIFI]    = { .width = 150, .align_left = true  },   // "<wifi> 192.168.100.200"
+    [UI_FIELD_TEMP]    = { .width = 190, .align_left = false },   // "-10.5°C" v 48 px
+    [UI_FIELD_HUM]     = { .width = 100, .align_left = false },   // "<drop> 100.0%"
+    [UI_FIELD_TARGET]  = { .width = 160, .align_left = false },   // "<target> Target: 30.0°C"
+    [UI_FIELD_FURNACE] = { .width = 150, .align_left = false },   // "<fire> HEATING"
+    [UI_FIELD_POWER]   = { .width = 90,  .align_left = false },   // "<bolt> 3000 W"
+};
+
+static ui_field_t s_fields[UI_FIELD_COUNT];
+
+// WiFi bar-i niso tekst - ločen del modela
+static uint8_t s_bars_pending = 0;
+static uint8_t s_bars_shown = 0;
+static bool s_bars_dirty = false;
+static ui_update_stats_t s_stats = {0};
+static portMUX_TYPE s_model_mux = portMUX_INITIALIZER_UNLOCKED;
+static lv_timer_t *s_flush_timer = NULL;
+
 /**
- * @brief WiFi ikona (text-based)
+ * @brief Poveže widget s poljem modela in ga nastavi na začetno vrednost
+ * @note Kliče se z display lockom (create_main_screen)
  */
-static const char* get_wifi_icon(int8_t rssi, bool connected)
+static void bind_field(ui_field_id_t id, lv_obj_t *obj, const char *text,
+                       ui_font_style_t font, ui_text_style_t style)
 {
-    if (!connected) return "📡❌";
-    if (rssi > -50) return "📡▂▄▆█";  // Excellent
-    if (rssi > -60) return "📡▂▄▆";   // Good
-    if (rssi > -70) return "📡▂▄";    // Fair
-    return "📡▂";                      // Weak
+    ui_field_t *f = &s_fields[id];
+    
+    f->obj = obj;
+    strlcpy(f->shown.text, text, sizeof(f->shown.text));
+    f->shown.style = style;
+    f->shown.color = 0;
+    f->pending = f->shown;
+    f->dirty = false;
+    
+    lv_label_set_text(obj, text);
+    lv_label_set_long_mode(obj, LV_LABEL_LONG_CLIP);
+    lv_obj_set_width(obj, s_field_layout[id].width);
+    lv_obj_add_style(obj, s_field_layout[id].align_left ? &s_align_left_style : &s_align_center_style, 0);
+    lv_obj_add_style(obj, &s_font_styles[font], 0);
+    lv_obj_add_style(obj, &s_text_styles[style], 0);
+}
+
+/**
+ * @brief Zapiše novo vrednost v model (brez LVGL klicev)
+ */
+static void stage_field(ui_field_id_t id, const char *text, ui_text_style_t style, uint32_t color)
+{
+    ui_field_t *f = &s_fields[id];
+    
+    if (style != UI_STYLE_CUSTOM) {
+        color = 0;
+    }
+    
+    portENTER_CRITICAL(&s_model_mux);
+    s_stats.requested++;
+    if (f->pending.style == style && f->pending.color == color &&
+        strncmp(f->pending.text, text, sizeof(f->pending.text) - 1) == 0) {
+        // Ista vrednost kot zadnjič - nič za narediti
+        s_stats.skipped++;
+    } else {
+        strlcpy(f->pending.text, text, sizeof(f->pending.text));
+        f->pending.style = style;
+        f->pending.color = color;
+        f->dirty = true;
+    }
+    portEXIT_CRITICAL(&s_model_mux);
+}
+
+/**
+ * @brief Trend vrednost → točka grafa (manjkajoča = brez točke)
+ */
+static int32_t chart_value(int16_t value)
+{
+    return (value == UI_TREND_NONE) ? LV_CHART_POINT_NONE : value;
+}
+
+/**
+ * @brief Doda nove trend točke na konec grafa (brez rebuild-a serij)
+ * @note Teče v LVGL tasku
+ */
+static void append_chart_points(void)
+{
+    ui_trend_point_t p;
+    bool have;
+    
+    if (s_chart == NULL) {
+        return;
+    }
+    
+    portENTER_CRITICAL(&s_trend_mux);
+    ui_trend_tick(&s_trend, esp_timer_get_time());
+    have = ui_trend_pop_unread(&s_trend, &p);
+    portEXIT_CRITICAL(&s_trend_mux);
+    
+    while (have) {
+        lv_chart_set_next_value(s_chart, s_ser_temp_min, chart_value(p.temp_min));
+        lv_chart_set_next_value(s_chart, s_ser_temp_avg, chart_value(p.temp_avg));
+        lv_chart_set_next_value(s_chart, s_ser_temp_max, chart_value(p.temp_max));
+        lv_chart_set_next_value(s_chart, s_ser_target, chart_value(p.target));
+        lv_chart_set_next_value(s_chart, s_ser_power, chart_value(p.power));
+        
+        if (p.power != UI_TREND_NONE && p.power > s_power_axis_max) {
+            s_power_axis_max = ((p.power + 99) / 100) * 100;
+            lv_chart_set_axis_range(s_chart, LV_CHART_AXIS_SECONDARY_Y, 0, s_power_axis_max);
+        }
+        
+        portENTER_CRITICAL(&s_trend_mux);
+        have = ui_trend_pop_unread(&s_trend, &p);
+        portEXIT_CRITICAL(&s_trend_mux);
+    }
+}
+
+/**
+ * @brief Prenese spremenjena polja na widgete
+ * @note Teče v LVGL tasku, ki že drži display lock
+ */
+static void ui_flush_timer_cb(lv_timer_t *timer)
+{
+    uint32_t applied = 0;
+    int64_t start_us = esp_timer_get_time();
+    
+    for (int i = 0; i < UI_FIELD_COUNT; i++) {
+        ui_field_t *f = &s_fields[i];
+        ui_field_value_t next;
+        
+        portENTER_CRITICAL(&s_model_mux);
+        if (!f->dirty) {
+            portEXIT_CRITICAL(&s_model_mux);
+            continue;
+        }
+        next = f->pending;
+        f->dirty = false;
+        portEXIT_CRITICAL(&s_model_mux);
+        
+        if (f->obj == NULL) {
+            continue;
+        }
+        
+        // Vsak set invalidira območje labela → samo dejanske spremembe
+        if (strcmp(next.text, f->shown.text) != 0) {
+            lv_label_set_text(f->obj, next.text);
+            applied++;
+        }
+        if (next.style == UI_STYLE_CUSTOM && next.color != s_custom_color) {
+            // Redka pot - barva izven tabele; deljeni stil posodobimo na mestu
+            s_custom_color = next.color;
+            lv_style_set_text_color(&s_text_styles[UI_STYLE_CUSTOM], lv_color_hex(next.color));
+            lv_obj_report_style_change(&s_text_styles[UI_STYLE_CUSTOM]);
+            applied++;
+        }
+        if (next.style != f->shown.style) {
+            lv_obj_replace_style(f->obj, &s_text_styles[f->shown.style],
+                                 &s_text_styles[next.style], 0);
+            applied++;
+        }
+        f->shown = next;
+    }
+    
+    // WiFi bar-i: zamenjaj stil samo bar-om, ki so spremenili stanje
+    portENTER_CRITICAL(&s_model_mux);
+    bool bars_dirty = s_bars_dirty;
+    uint8_t bars = s_bars_pending;
+    s_bars_dirty = false;
+    portEXIT_CRITICAL(&s_model_mux);
+    
+    if (bars_dirty && bars != s_bars_shown) {
+        for (int i = 0; i < UI_WIFI_BARS; i++) {
+            bool on = i < bars;
+            bool was_on = i < s_bars_shown;
+            if (on != was_on && s_wifi_bars[i] != NULL) {
+                lv_obj_replace_style(s_wifi_bars[i], on ? &s_bar_off_style : &s_bar_on_style,
+                                     on ? &s_bar_on_style : &s_bar_off_style, 0);
+                applied++;
+            }
+        }
+        s_bars_shown = bars;
+    }
+    
+    append_chart_points();
+    
+    if (applied > 0) {
+        uint32_t elapsed_us = (uint32_t)(esp_timer_get_time() - start_us);
+        
+        portENTER_CRITICAL(&s_model_mux);
+        s_stats.applied += applied;
+        s_stats.flushes++;
+        s_stats.last_flush_us = elapsed_us;
+        if (elapsed_us > s_stats.max_flush_us) {
+            s_stats.max_flush_us = elapsed_us;
+        }
+        portEXIT_CRITICAL(&s_model_mux);
+    }
+}
+
+/**
+ * @brief +/- gumb: pritisk in long-press auto-repeat
+ */
+static void target_btn_cb(lv_event_t *e)
+{
+    int steps = (int)(intptr_t)lv_event_get_user_data(e);
+    
+    if (s_target_callback == NULL) {
+        return;
+    }
+    
+    s_target_callback(steps);
+    
+    // Novi target pokaži takoj, ne šele ob naslednjem flush periodu
+    lv_timer_ready(s_flush_timer);
+}
+
+//====================================================================
+/**
+ * @brief WiFi ikona
+ */
+static const char* get_wifi_icon(bool connected)
+{
+    return connected ? UI_ICON_WIFI : UI_ICON_WIFI " " UI_ICON_CLOSE;
+}
+
+/**
+ * @brief Moč signala - 4 bar-i (▂▄▆█ niso v nobenem fontu)
+ */
+static void create_wifi_bars(lv_obj_t *screen)
+{
+    for (int i = 0; i < UI_WIFI_BARS; i++) {
+        int32_t height = 4 + i * 3;
+        
+        s_wifi_bars[i] = lv_obj_create(screen);
+        lv_obj_remove_flag(s_wifi_bars[i], LV_OBJ_FLAG_CLICKABLE);
+        lv_obj_add_style(s_wifi_bars[i], &s_bar_off_style, 0);
+        lv_obj_set_size(s_wifi_bars[i], 4, height);
+        // Poravnani na dno, zadnji (najvišji) čisto desno
+        lv_obj_align(s_wifi_bars[i], LV_ALIGN_TOP_RIGHT,
+                     -5 - (UI_WIFI_BARS - 1 - i) * 6, 5 + (4 + (UI_WIFI_BARS - 1) * 3) - height);
+    }
+}
+
+/**
+ * @brief Swipe levo → graf, swipe desno → nazaj na glavni screen
+ */
+static void screen_gesture_cb(lv_event_t *e)
+{
+    lv_dir_t dir = lv_indev_get_gesture_dir(lv_indev_active());
+    
+    if (dir == LV_DIR_LEFT && lv_screen_active() == s_main_screen) {
+        lv_screen_load_anim(s_chart_screen, LV_SCR_LOAD_ANIM_MOVE_LEFT, 200, 0, false);
+    } else if (dir == LV_DIR_RIGHT && lv_screen_active() == s_chart_screen) {
+        lv_screen_load_anim(s_main_screen, LV_SCR_LOAD_ANIM_MOVE_RIGHT, 200, 0, false);
+    }
+}
+
+/**
+ * @brief Kreira trend screen (zadnjih 24 h: temperatura, target, moč)
+ */
+static void create_chart_screen(void)
+{
+    s_chart_screen = lv_obj_create(NULL);
+    lv_obj_add_style(s_chart_screen, &s_screen_style, 0);
+    lv_obj_add_event_cb(s_chart_screen, screen_gesture_cb, LV_EVENT_GESTURE, NULL);
+    
+    lv_obj_t *title = lv_label_create(s_chart_screen);
+    lv_label_set_text(title, "Zadnjih 24 h");
+    lv_obj_add_style(title, &s_font_styles[UI_FONT_16], 0);
+    lv_obj_add_style(title, &s_text_styles[UI_STYLE_NEUTRAL], 0);
+    lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 5);
+    
+    lv_obj_t *legend = lv_label_create(s_chart_screen);
+    lv_label_set_text(legend, "T [°C]   Target   P [W]");
+    lv_obj_add_style(legend, &s_font_styles[UI_FONT_12], 0);
+    lv_obj_add_style(legend, &s_text_styles[UI_STYLE_NEUTRAL], 0);
+    lv_obj_align(legend, LV_ALIGN_BOTTOM_MID, 0, -5);
+    
+    s_chart = lv_chart_create(s_chart_screen);
+    lv_obj_set_size(s_chart, 300, 180);
+    lv_obj_align(s_chart, LV_ALIGN_CENTER, 0, 0);
+    lv_obj_add_style(s_chart, &s_chart_point_style, LV_PART_INDICATOR);
+    
+    lv_chart_set_type(s_chart, LV_CHART_TYPE_LINE);
+    lv_chart_set_point_count(s_chart, UI_TREND_LEN);
+    lv_chart_set_update_mode(s_chart, LV_CHART_UPDATE_MODE_SHIFT);
+    lv_chart_set_div_line_count(s_chart, 5, 5);
+    
+    // Temperature v 0.1 °C, moč v W na sekundarni osi
+    lv_chart_set_axis_range(s_chart, LV_CHART_AXIS_PRIMARY_Y, 100, 300);
+    lv_chart_set_axis_range(s_chart, LV_CHART_AXIS_SECONDARY_Y, 0, s_power_axis_max);
+    
+    s_ser_power = lv_chart_add_series(s_chart, lv_color_hex(s_style_colors[UI_STYLE_POWER]), LV_CHART_AXIS_SECONDARY_Y);
+    s_ser_temp_min = lv_chart_add_series(s_chart, lv_color_hex(0x006600), LV_CHART_AXIS_PRIMARY_Y);
+    s_ser_temp_max = lv_chart_add_series(s_chart, lv_color_hex(0x006600), LV_CHART_AXIS_PRIMARY_Y);
+    s_ser_target = lv_chart_add_series(s_chart, lv_color_hex(s_style_colors[UI_STYLE_TARGET]), LV_CHART_AXIS_PRIMARY_Y);
+    s_ser_temp_avg = lv_chart_add_series(s_chart, lv_color_hex(s_style_colors[UI_STYLE_NORMAL]), LV_CHART_AXIS_PRIMARY_Y);
+    
+    lv_chart_set_all_value(s_chart, s_ser_power, LV_CHART_POINT_NONE);
+    lv_chart_set_all_value(s_chart, s_ser_temp_min, LV_CHART_POINT_NONE);
+    lv_chart_set_all_value(s_chart, s_ser_temp_max, LV_CHART_POINT_NONE);
+    lv_chart_set_all_value(s_chart, s_ser_target, LV_CHART_POINT_NONE);
+    lv_chart_set_all_value(s_chart, s_ser_temp_avg, LV_CHART_POINT_NONE);
+    
+    ESP_LOGI(TAG, "Chart screen created (%d points × %d s)", UI_TREND_LEN, UI_TREND_BUCKET_S);
 }
 
 /**
@@ -53,74 +581,65 @@ static const char* get_wifi_icon(int8_t rssi, bool connected)
 static void create_main_screen(void)
 {
     lv_obj_t *screen = display_manager_get_screen();
+    
+    s_main_screen = screen;
+    lv_obj_add_event_cb(screen, screen_gesture_cb, LV_EVENT_GESTURE, NULL);
 
     // ═══════════════════════════════════════════════
     // BACKGROUND COLOR 
     // ═══════════════════════════════════════════════
-    lv_obj_set_style_bg_color(screen, lv_color_hex(0x003a57), 0);
-    lv_obj_set_style_bg_opa(screen, LV_OPA_COVER, 0);
+    lv_obj_add_style(screen, &s_screen_style, 0);
 
     // ═══════════════════════════════════════════════
     // HEADER - WiFi status
     // ═══════════════════════════════════════════════
     wifi_status_label = lv_label_create(screen);
-    lv_label_set_text(wifi_status_label, "📡 Connecting...");
-    lv_obj_set_style_text_font(wifi_status_label, &lv_font_montserrat_12, 0);
-    lv_obj_set_style_text_color(wifi_status_label, lv_color_hex(0xFFFFFF), 0);
+    bind_field(UI_FIELD_WIFI, wifi_status_label, UI_ICON_WIFI " Connecting...", UI_FONT_12, UI_STYLE_NEUTRAL);
     lv_obj_align(wifi_status_label, LV_ALIGN_TOP_LEFT, 5, 5);
+    create_wifi_bars(screen);
     
     // ═══════════════════════════════════════════════
     // TITLE
     // ═══════════════════════════════════════════════
     lv_obj_t *title = lv_label_create(screen);
     lv_label_set_text(title, "Termostat Box 3");
-    lv_obj_set_style_text_font(title, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_color(title, lv_color_white(), 0);
+    lv_obj_add_style(title, &s_font_styles[UI_FONT_16], 0);
+    lv_obj_add_style(title, &s_text_styles[UI_STYLE_NEUTRAL], 0);
     lv_obj_align(title, LV_ALIGN_TOP_MID, 0, 5);
     
     // ═══════════════════════════════════════════════
     // TEMPERATURE (large display)
     // ═══════════════════════════════════════════════
     temp_label = lv_label_create(screen);
-    lv_label_set_text(temp_label, "--.-°C");
-    lv_obj_set_style_text_font(temp_label, &lv_font_montserrat_48, 0);
-    lv_obj_set_style_text_color(temp_label, lv_color_hex(0x00FF00), 0);
+    bind_field(UI_FIELD_TEMP, temp_label, "--.-°C", UI_FONT_48, UI_STYLE_NORMAL);
     lv_obj_align(temp_label, LV_ALIGN_CENTER, 0, -50);
     
     // ═══════════════════════════════════════════════
     // HUMIDITY
     // ═══════════════════════════════════════════════
     hum_label = lv_label_create(screen);
-    lv_label_set_text(hum_label, "--.-%");
-    lv_obj_set_style_text_font(hum_label, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_color(hum_label, lv_color_hex(0x00BFFF), 0);
+    bind_field(UI_FIELD_HUM, hum_label, "--.-%", UI_FONT_20, UI_STYLE_HUMIDITY);
     lv_obj_align(hum_label, LV_ALIGN_CENTER, 0, 10);
     
     // ═══════════════════════════════════════════════
     // TARGET TEMPERATURE
     // ═══════════════════════════════════════════════
     target_temp_label = lv_label_create(screen);
-    lv_label_set_text(target_temp_label, "Target: 21.0°C");
-    lv_obj_set_style_text_font(target_temp_label, &lv_font_montserrat_16, 0);
-    lv_obj_set_style_text_color(target_temp_label, lv_color_hex(0xFFAA00), 0);
+    bind_field(UI_FIELD_TARGET, target_temp_label, "Target: 21.0°C", UI_FONT_16, UI_STYLE_TARGET);
     lv_obj_align(target_temp_label, LV_ALIGN_CENTER, 0, 50);
     
     // ═══════════════════════════════════════════════
     // FURNACE STATUS
     // ═══════════════════════════════════════════════
     furnace_status_label = lv_label_create(screen);
-    lv_label_set_text(furnace_status_label, "🔥 OFF");
-    lv_obj_set_style_text_font(furnace_status_label, &lv_font_montserrat_20, 0);
-    lv_obj_set_style_text_color(furnace_status_label, lv_color_hex(0x808080), 0);
+    bind_field(UI_FIELD_FURNACE, furnace_status_label, UI_PREFIX_SNOW "OFF", UI_FONT_20, UI_STYLE_OFF);
     lv_obj_align(furnace_status_label, LV_ALIGN_BOTTOM_MID, 0, -50);
     
     // ═══════════════════════════════════════════════
     // POWER MONITORING
     // ═══════════════════════════════════════════════
     power_label = lv_label_create(screen);
-    lv_label_set_text(power_label, "⚡ --- W");
-    lv_obj_set_style_text_font(power_label, &lv_font_montserrat_14, 0);
-    lv_obj_set_style_text_color(power_label, lv_color_hex(0xFFFF00), 0);
+    bind_field(UI_FIELD_POWER, power_label, UI_ICON_POWER " --- W", UI_FONT_14, UI_STYLE_POWER);
     lv_obj_align(power_label, LV_ALIGN_BOTTOM_MID, 0, -25);
 
     // ═══════════════════════════════════════════════
@@ -131,17 +650,18 @@ static void create_main_screen(void)
     lv_obj_align(btn_minus, LV_ALIGN_CENTER, -50, 80);  // Levo od centra
     
     // Button style
-    lv_obj_set_style_bg_color(btn_minus, lv_color_hex(0x404040), 0);
-    lv_obj_set_style_bg_color(btn_minus, lv_color_hex(0x606060), LV_STATE_PRESSED);
+    lv_obj_add_style(btn_minus, &s_btn_style, 0);
+    lv_obj_add_style(btn_minus, &s_btn_pressed_style, LV_STATE_PRESSED);
     
     // Label "-" v gumbu
     lv_obj_t *label_minus = lv_label_create(btn_minus);
     lv_label_set_text(label_minus, "-");
-    lv_obj_set_style_text_font(label_minus, &lv_font_montserrat_32, 0);
+    lv_obj_add_style(label_minus, &s_font_styles[UI_FONT_32], 0);
     lv_obj_center(label_minus);
     
-    // Registriraj event
-    //lv_obj_add_event_cb(btn_minus, btn_minus_cb, LV_EVENT_CLICKED, NULL);
+    // Registriraj event (PRESSED = brez čakanja na release)
+    lv_obj_add_event_cb(btn_minus, target_btn_cb, LV_EVENT_PRESSED, (void *)(intptr_t)-1);
+    lv_obj_add_event_cb(btn_minus, target_btn_cb, LV_EVENT_LONG_PRESSED_REPEAT, (void *)(intptr_t)-1);
     
     // ═══════════════════════════════════════════════
     // PLUS BUTTON
@@ -151,17 +671,18 @@ static void create_main_screen(void)
     lv_obj_align(btn_plus, LV_ALIGN_CENTER, 50, 80);  // Desno od centra
     
     // Button style
-    lv_obj_set_style_bg_color(btn_plus, lv_color_hex(0x404040), 0);
-    lv_obj_set_style_bg_color(btn_plus, lv_color_hex(0x606060), LV_STATE_PRESSED);
+    lv_obj_add_style(btn_plus, &s_btn_style, 0);
+    lv_obj_add_style(btn_plus, &s_btn_pressed_style, LV_STATE_PRESSED);
     
     // Label "+" v gumbu
     lv_obj_t *label_plus = lv_label_create(btn_plus);
     lv_label_set_text(label_plus, "+");
-    lv_obj_set_style_text_font(label_plus, &lv_font_montserrat_32, 0);
+    lv_obj_add_style(label_plus, &s_font_styles[UI_FONT_32], 0);
     lv_obj_center(label_plus);
     
-    // Registriraj event
-    //lv_obj_add_event_cb(btn_plus, btn_plus_cb, LV_EVENT_CLICKED, NULL);
+    // Registriraj event (PRESSED = brez čakanja na release)
+    lv_obj_add_event_cb(btn_plus, target_btn_cb, LV_EVENT_PRESSED, (void *)(intptr_t)1);
+    lv_obj_add_event_cb(btn_plus, target_btn_cb, LV_EVENT_LONG_PRESSED_REPEAT, (void *)(intptr_t)1);
     
    
     ESP_LOGI(TAG, "Main screen created");
@@ -171,30 +692,63 @@ esp_err_t ui_manager_init(void)
 {
     ESP_LOGI(TAG, "Initializing UI manager...");
     
+    size_t heap_before = heap_caps_get_free_size(MALLOC_CAP_DEFAULT);
+    
+    ui_trend_init(&s_trend, esp_timer_get_time());
+    
     bsp_display_lock(0);
+    init_styles();
     create_main_screen();
+    create_chart_screen();
+    s_flush_timer = lv_timer_create(ui_flush_timer_cb, UI_DEFAULT_FLUSH_PERIOD_MS, NULL);
     bsp_display_unlock();
     
-    ESP_LOGI(TAG, "UI manager initialized");
+    if (s_flush_timer == NULL) {
+        ESP_LOGE(TAG, "Failed to create UI flush timer");
+        return ESP_FAIL;
+    }
+    
+    ESP_LOGI(TAG, "UI manager initialized (heap used: %u bytes)",
+             (unsigned)(heap_before - heap_caps_get_free_size(MALLOC_CAP_DEFAULT)));
     return ESP_OK;
 }
 
+void ui_manager_set_flush_period(uint32_t period_ms)
+{
+    if (s_flush_timer == NULL || period_ms == 0) return;
+    
+    bsp_display_lock(0);
+    lv_timer_set_period(s_flush_timer, period_ms);
+    bsp_display_unlock();
+}
+
+void ui_manager_register_target_callback(ui_target_callback_t callback)
+{
+    s_target_callback = callback;
+}
+
+void ui_manager_get_update_stats(ui_update_stats_t *stats)
+{
+    if (stats == NULL) return;
+    
+    portENTER_CRITICAL(&s_model_mux);
+    *stats = s_stats;
+    portEXIT_CRITICAL(&s_model_mux);
+}
+
 void ui_manager_update_temperature(float temperature, bool valid)
 {
     char temp_str[32];
     
     if (valid) {
         snprintf(temp_str, sizeof(temp_str), "%.1f°C", temperature);
+        stage_field(UI_FIELD_TEMP, temp_str, UI_STYLE_NORMAL, 0);
         
-        bsp_display_lock(0);
-        lv_label_set_text(temp_label, temp_str);
-        lv_obj_set_style_text_color(temp_label, lv_color_hex(0x00FF00), 0);
-        bsp_display_unlock();
+        portENTER_CRITICAL(&s_trend_mux);
+        ui_trend_add_temperature(&s_trend, esp_timer_get_time(), temperature);
+        portEXIT_CRITICAL(&s_trend_mux);
     } else {
-        bsp_display_lock(0);
-        lv_label_set_text(temp_label, "ERROR");
-        lv_obj_set_style_text_color(temp_label, lv_color_hex(0xFF0000), 0);
-        bsp_display_unlock();
+        stage_field(UI_FIELD_TEMP, "ERROR", UI_STYLE_ERROR, 0);
     }
 }
 
@@ -203,28 +757,17 @@ void ui_manager_update_humidity(float humidity, bool valid)
     char hum_str[32];
     
     if (valid) {
-        snprintf(hum_str, sizeof(hum_str), "💧%.1f%%", humidity);
-        
-        bsp_display_lock(0);
-        lv_label_set_text(hum_label, hum_str);
-        lv_obj_set_style_text_color(hum_label, lv_color_hex(0x00BFFF), 0);
-        bsp_display_unlock();
+        snprintf(hum_str, sizeof(hum_str), UI_ICON_DROP " %.1f%%", humidity);
+        stage_field(UI_FIELD_HUM, hum_str, UI_STYLE_HUMIDITY, 0);
     } else {
-        bsp_display_lock(0);
-        lv_label_set_text(hum_label, "ERROR");
-        lv_obj_set_style_text_color(hum_label, lv_color_hex(0xFF0000), 0);
-        bsp_display_unlock();
+        stage_field(UI_FIELD_HUM, "ERROR", UI_STYLE_ERROR, 0);
     }
 }
 
 void ui_manager_show_sensor_error(void)
 {
-    bsp_display_lock(0);
-    lv_label_set_text(temp_label, "SENSOR");
-    lv_label_set_text(hum_label, "ERROR");
-    lv_obj_set_style_text_color(temp_label, lv_color_hex(0xFF0000), 0);
-    lv_obj_set_style_text_color(hum_label, lv_color_hex(0xFF0000), 0);
-    bsp_display_unlock();
+    stage_field(UI_FIELD_TEMP, "SENSOR", UI_STYLE_ERROR, 0);
+    stage_field(UI_FIELD_HUM, "ERROR", UI_STYLE_ERROR, 0);
 }
 
 void ui_manager_update_furnace_status(const char *status, uint32_t color)
@@ -232,48 +775,61 @@ void ui_manager_update_furnace_status(const char *status, uint32_t color)
     if (status == NULL) return;
     
     char status_str[64];
+    ui_text_style_t preferred;
     
     // Dodaj ikono glede na status
     if (strcmp(status, "HEATING") == 0) {
-        snprintf(status_str, sizeof(status_str), "🔥 %s", status);
+        snprintf(status_str, sizeof(status_str), UI_PREFIX_FIRE "%s", status);
+        preferred = UI_STYLE_HEATING;
     } else if (strcmp(status, "OFF") == 0) {
-        snprintf(status_str, sizeof(status_str), "❄️ %s", status);
+        snprintf(status_str, sizeof(status_str), UI_PREFIX_SNOW "%s", status);
+        preferred = UI_STYLE_OFF;
     } else {
-        snprintf(status_str, sizeof(status_str), "⚠️ %s", status);
+        snprintf(status_str, sizeof(status_str), UI_ICON_WARNING " %s", status);
+        preferred = UI_STYLE_WARNING;
     }
     
-    bsp_display_lock(0);
-    lv_label_set_text(furnace_status_label, status_str);
-    lv_obj_set_style_text_color(furnace_status_label, lv_color_hex(color), 0);
-    bsp_display_unlock();
+    stage_field(UI_FIELD_FURNACE, status_str, style_for_color(color, preferred), color);
 }
 
 void ui_manager_set_target_temperature(float target_temp)
 {
     char target_str[32];
-    snprintf(target_str, sizeof(target_str), "🎯 Target: %.1f°C", target_temp);
+    snprintf(target_str, sizeof(target_str), UI_PREFIX_TARGET "Target: %.1f°C", target_temp);
     
-    bsp_display_lock(0);
-    lv_label_set_text(target_temp_label, target_str);
-    bsp_display_unlock();
+    stage_field(UI_FIELD_TARGET, target_str, UI_STYLE_TARGET, 0);
+    
+    portENTER_CRITICAL(&s_trend_mux);
+    ui_trend_set_target(&s_trend, esp_timer_get_time(), target_temp);
+    portEXIT_CRITICAL(&s_trend_mux);
 }
 
-void ui_manager_update_wifi_status(bool connected, const char *ip_address, int8_t rssi)
+void ui_manager_update_wifi_status(bool connected, const char *ip_address, uint8_t bars)
 {
     char wifi_str[64];
     
     if (connected && ip_address) {
-        const char *icon = get_wifi_icon(rssi, true);
-        snprintf(wifi_str, sizeof(wifi_str), "%s %s", icon, ip_address);
+        snprintf(wifi_str, sizeof(wifi_str), "%s %s", get_wifi_icon(true), ip_address);
     } else {
-        snprintf(wifi_str, sizeof(wifi_str), "📡 Disconnected");
+        snprintf(wifi_str, sizeof(wifi_str), "%s Disconnected", get_wifi_icon(false));
+        bars = 0;
     }
     
-    bsp_display_lock(0);
-    lv_label_set_text(wifi_status_label, wifi_str);
-    lv_obj_set_style_text_color(wifi_status_label, 
-                                  connected ? lv_color_hex(0x00FF00) : lv_color_hex(0xFF0000), 0);
-    bsp_display_unlock();
+    stage_field(UI_FIELD_WIFI, wifi_str, connected ? UI_STYLE_WIFI_OK : UI_STYLE_WIFI_DOWN, 0);
+    
+    if (bars > UI_WIFI_BARS) {
+        bars = UI_WIFI_BARS;
+    }
+    
+    portENTER_CRITICAL(&s_model_mux);
+    s_stats.requested++;
+    if (bars == s_bars_pending) {
+        s_stats.skipped++;
+    } else {
+        s_bars_pending = bars;
+        s_bars_dirty = true;
+    }
+    portEXIT_CRITICAL(&s_model_mux);
 }
 
 void ui_manager_update_power(float power_w, bool online)
@@ -282,17 +838,19 @@ void ui_manager_update_power(float power_w, bool online)
     
     if (online) {
         if (power_w > 0) {
-            snprintf(power_str, sizeof(power_str), "⚡ %.0f W", power_w);
+            snprintf(power_str, sizeof(power_str), UI_ICON_POWER " %.0f W", power_w);
         } else {
-            snprintf(power_str, sizeof(power_str), "⚡ 0 W");
+            snprintf(power_str, sizeof(power_str), UI_ICON_POWER " 0 W");
         }
     } else {
-        snprintf(power_str, sizeof(power_str), "⚡ Offline");
+        snprintf(power_str, sizeof(power_str), UI_ICON_POWER " Offline");
     }
     
-    bsp_display_lock(0);
-    lv_label_set_text(power_label, power_str);
-    lv_obj_set_style_text_color(power_label, 
-                                  online ? lv_color_hex(0xFFFF00) : lv_color_hex(0xFF0000), 0);
-    bsp_display_unlock();
+    stage_field(UI_FIELD_POWER, power_str, online ? UI_STYLE_POWER : UI_STYLE_ERROR, 0);
+    
+    if (online) {
+        portENTER_CRITICAL(&s_trend_mux);
+        ui_trend_add_power(&s_trend, esp_timer_get_time(), power_w);
+        portEXIT_CRITICAL(&s_trend_mux);
+    }
 }
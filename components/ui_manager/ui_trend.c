@@ -0,0 +1,118 @@
+/**
+ * @file ui_trend.c
+ * @brief Downsamplan zgodovinski buffer za trend graf
+ */
+#include "ui_trend.h"
+#include <string.h>
+
+#define BUCKET_US   ((int64_t)UI_TREND_BUCKET_S * 1000000)
+
+static int16_t to_fixed(float value, float scale)
+{
+    float v = value * scale;
+    
+    if (v > INT16_MAX) return INT16_MAX;
+    if (v <= INT16_MIN) return INT16_MIN + 1;   // INT16_MIN je rezerviran za "ni podatka"
+    return (int16_t)(v >= 0 ? v + 0.5f : v - 0.5f);
+}
+
+static void reset_bucket(ui_trend_t *t)
+{
+    t->temp_sum = 0;
+    t->temp_n = 0;
+    t->temp_min = INT16_MAX;
+    t->temp_max = INT16_MIN;
+    t->power_sum = 0;
+    t->power_n = 0;
+}
+
+static void close_bucket(ui_trend_t *t)
+{
+    ui_trend_point_t *p = &t->points[t->head];
+    
+    if (t->temp_n > 0) {
+        p->temp_min = t->temp_min;
+        p->temp_avg = (int16_t)(t->temp_sum / t->temp_n);
+        p->temp_max = t->temp_max;
+    } else {
+        p->temp_min = UI_TREND_NONE;
+        p->temp_avg = UI_TREND_NONE;
+        p->temp_max = UI_TREND_NONE;
+    }
+    
+    p->target = t->last_target;
+    // Power se javlja samo ob spremembi → brez vzorcev velja zadnja vrednost
+    p->power = (t->power_n > 0) ? (int16_t)(t->power_sum / t->power_n) : t->last_power;
+    
+    t->head = (t->head + 1) % UI_TREND_LEN;
+    if (t->count < UI_TREND_LEN) t->count++;
+    if (t->unread < UI_TREND_LEN) t->unread++;
+    
+    reset_bucket(t);
+}
+
+void ui_trend_init(ui_trend_t *t, int64_t now_us)
+{
+    memset(t, 0, sizeof(*t));
+    t->bucket_start_us = now_us;
+    t->last_target = UI_TREND_NONE;
+    t->last_power = UI_TREND_NONE;
+    reset_bucket(t);
+}
+
+void ui_trend_tick(ui_trend_t *t, int64_t now_us)
+{
+    int64_t elapsed = now_us - t->bucket_start_us;
+    
+    if (elapsed < BUCKET_US) {
+        return;
+    }
+    
+    int64_t buckets = elapsed / BUCKET_US;
+    // Po dolgem premoru ne generiramo več praznih točk, kot jih ring sprejme
+    int64_t closes = (buckets > UI_TREND_LEN) ? UI_TREND_LEN : buckets;
+    
+    for (int64_t i = 0; i < closes; i++) {
+        close_bucket(t);
+    }
+    t->bucket_start_us += buckets * BUCKET_US;
+}
+
+void ui_trend_add_temperature(ui_trend_t *t, int64_t now_us, float temperature)
+{
+    ui_trend_tick(t, now_us);
+    
+    int16_t v = to_fixed(temperature, 10.0f);
+    t->temp_sum += v;
+    t->temp_n++;
+    if (v < t->temp_min) t->temp_min = v;
+    if (v > t->temp_max) t->temp_max = v;
+}
+
+void ui_trend_add_power(ui_trend_t *t, int64_t now_us, float power_w)
+{
+    ui_trend_tick(t, now_us);
+    
+    int16_t v = to_fixed(power_w, 1.0f);
+    t->power_sum += v;
+    t->power_n++;
+    t->last_power = v;
+}
+
+void ui_trend_set_target(ui_trend_t *t, int64_t now_us, float target)
+{
+    ui_trend_tick(t, now_us);
+    t->last_target = to_fixed(target, 10.0f);
+}
+
+bool ui_trend_pop_unread(ui_trend_t *t, ui_trend_point_t *point)
+{
+    if (t->unread == 0) {
+        return false;
+    }
+    
+    uint16_t idx = (t->head + UI_TREND_LEN - t->unread) % UI_TREND_LEN;
+    *point = t->points[idx];
+    t->unread--;
+    return true;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file ui_trend.h
+ * @brief Downsamplan zgodovinski buffer za trend graf (24 h)
+ *
+ * Vzorci se zbirajo v trenutni bucket (min/avg/max), ob izteku bucketa se
+ * zaključen bucket zapiše v ring. Poraba pomnilnika je fiksna ne glede na
+ * frekvenco vzorčenja. Modul ni thread-safe in ne kliče LVGL.
+ */
+#ifndef UI_TREND_H
+#define UI_TREND_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#define UI_TREND_BUCKET_S       300     // 5 min na točko
+#define UI_TREND_LEN            288     // 288 × 5 min = 24 h
+#define UI_TREND_NONE           INT16_MIN
+
+/**
+ * @brief Ena točka grafa (0.1 °C / 1 W)
+ */
+typedef struct {
+    int16_t temp_min;
+    int16_t temp_avg;
+    int16_t temp_max;
+    int16_t target;
+    int16_t power;
+} ui_trend_point_t;
+
+typedef struct {
+    ui_trend_point_t points[UI_TREND_LEN];
+    uint16_t head;              // Naslednji zapis
+    uint16_t count;             // Točk v ringu
+    uint16_t unread;            // Točk, ki jih graf še ni dobil
+    
+    // Trenutni (odprt) bucket
+    int64_t bucket_start_us;
+    int32_t temp_sum;
+    uint16_t temp_n;
+    int16_t temp_min;
+    int16_t temp_max;
+    int32_t power_sum;
+    uint16_t power_n;
+    
+    // Sample-and-hold vrednosti (posodobijo se samo ob spremembi)
+    int16_t last_target;
+    int16_t last_power;
+} ui_trend_t;
+
+/**
+ * @brief Inicializira buffer (prazen, prvi bucket začne ob now_us)
+ */
+void ui_trend_init(ui_trend_t *t, int64_t now_us);
+
+/**
+ * @brief Zaključi vse pretečene buckete (prazni dobijo UI_TREND_NONE)
+ */
+void ui_trend_tick(ui_trend_t *t, int64_t now_us);
+
+void ui_trend_add_temperature(ui_trend_t *t, int64_t now_us, float temperature);
+void ui_trend_add_power(ui_trend_t *t, int64_t now_us, float power_w);
+void ui_trend_set_target(ui_trend_t *t, int64_t now_us, float target);
+
+/**
+ * @brief Vzame najstarejšo točko, ki je graf še ni prikazal
+ * @return False če novih točk ni
+ */
+bool ui_trend_pop_unread(ui_trend_t *t, ui_trend_point_t *point);
+
+#endif // UI_TREND_H
@@ -7,13 +7,29 @@
 
 #include "esp_err.h"
 #include <stdbool.h>
+#include <stdint.h>
+#include <stddef.h>
+
+#define WIFI_MANAGER_MAX_BARS   4
+
+/**
+ * @brief Stanje povezave, kot ga vidi UI
+ */
+typedef struct {
+    bool connected;
+    char ip[16];            // Prazen string če ni povezan
+    int8_t rssi;            // Zadnji vzorec (dBm)
+    uint8_t bars;           // 0-4, s histerezo (ne skače na meji)
+} wifi_manager_status_t;
 
 /**
- * @brief WiFi event callback
- * @param connected True če je WiFi povezan
- * @param ip_address IP naslov (če je povezan)
+ * @brief Callback ob spremembi povezave, IP ali števila bar-ov
+ * 
+ * Kliče se iz event loop ali esp_timer taska - naj bo kratek.
+ * 
+ * @param status Novo stanje
  */
-typedef void (*wifi_event_callback_t)(bool connected, const char *ip_address);
+typedef void (*wifi_status_callback_t)(const wifi_manager_status_t *status);
 
 /**
  * @brief Inicializira WiFi manager
@@ -43,10 +59,20 @@ bool wifi_manager_is_connected(void);
 void wifi_manager_get_ip(char *ip_str, size_t max_len);
 
 /**
- * @brief Registriraj callback za WiFi events
+ * @brief Registriraj callback za spremembe stanja (povezava, IP, bar-i)
+ * 
+ * RSSI se vzorči samo med povezavo; callback se sproži le, ko se
+ * število bar-ov dejansko spremeni.
+ * 
  * @param callback Callback funkcija
  */
-void wifi_manager_register_callback(wifi_event_callback_t callback);
+void wifi_manager_register_status_callback(wifi_status_callback_t callback);
+
+/**
+ * @brief Dobi trenutno stanje
+ * @param status Output struktura
+ */
+void wifi_manager_get_status(wifi_manager_status_t *status);
 
 /**
  * @brief Dobi RSSI (signal strength)
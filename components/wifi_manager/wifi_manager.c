@@ -6,7 +6,10 @@
 #include "esp_wifi.h"
 #include "esp_event.h"
 #include "esp_log.h"
+#include "esp_timer.h"
+#include "esp_random.h"
 #include "nvs_flash.h"
+#include "nvs.h"
 #include "freertos/FreeRTOS.h"
 #include "freertos/event_groups.h"
 #include <string.h>
@@ -15,45 +18,252 @@ static const char *TAG = "wifi_mgr";
 
 #define WIFI_CONNECTED_BIT BIT0
 #define WIFI_FAIL_BIT      BIT1
-#define MAX_RETRY          10
+#define MAX_RETRY          10      // Po tem connect() javi napako, reconnect teče naprej
+
+// Reconnect supervisor - eksponentni backoff z jitterjem, nikoli ne obupa
+#define BACKOFF_MIN_MS     500
+#define BACKOFF_MAX_MS     60000
+#define BACKOFF_JITTER_PCT 25
+
+// Fast reconnect cache (BSSID + kanal zadnjega AP-ja)
+#define NVS_NAMESPACE      "wifi_mgr"
+#define NVS_KEY_FAST       "fast"
+
+typedef struct {
+    uint8_t ssid[32];
+    uint8_t bssid[6];
+    uint8_t channel;
+} wifi_fast_cache_t;
+
+#define RSSI_SAMPLE_MS     10000   // Vzorčenje RSSI med povezavo
+#define RSSI_HYSTERESIS_DB 3       // Bar se spremeni šele 3 dB čez mejo
+
+// Meje za 4/3/2 bar-a (pod zadnjo = 1 bar)
+static const int8_t s_bar_thresholds[] = { -50, -60, -70 };
 
 static EventGroupHandle_t s_wifi_event_group;
 static int s_retry_num = 0;
-static wifi_event_callback_t s_event_callback = NULL;
 static char s_ip_address[16] = {0};
 
+static wifi_config_t s_wifi_config = {0};
+static esp_timer_handle_t s_reconnect_timer = NULL;
+static uint32_t s_backoff_ms = BACKOFF_MIN_MS;
+static int64_t s_link_lost_us = 0;      // Začetek trenutnega izpada (ali boot connect-a)
+static wifi_fast_cache_t s_fast_cache = {0};
+static bool s_fast_cache_valid = false;
+static bool s_config_pending = false;   // s_wifi_config še ni v driverju (uveljavi se ob izpadu)
+
+static wifi_status_callback_t s_status_callback = NULL;
+static wifi_manager_status_t s_status = {0};
+static portMUX_TYPE s_status_mux = portMUX_INITIALIZER_UNLOCKED;
+static esp_timer_handle_t s_rssi_timer = NULL;
+
+static uint8_t rssi_to_bars(int rssi)
+{
+    uint8_t bars = WIFI_MANAGER_MAX_BARS;
+    
+    for (int i = 0; i < (int)(sizeof(s_bar_thresholds) / sizeof(s_bar_thresholds[0])); i++) {
+        if (rssi > s_bar_thresholds[i]) {
+            return bars;
+        }
+        bars--;
+    }
+    return bars;
+}
+
+/**
+ * @brief Bar-i s histerezo - sprememba šele ko je RSSI dovolj čez mejo
+ */
+static uint8_t rssi_to_bars_hyst(int rssi, uint8_t current)
+{
+    if (current == 0) {
+        return rssi_to_bars(rssi);
+    }
+    
+    uint8_t up = rssi_to_bars(rssi - RSSI_HYSTERESIS_DB);
+    if (up > current) {
+        return up;
+    }
+    
+    uint8_t down = rssi_to_bars(rssi + RSSI_HYSTERESIS_DB);
+    if (down < current) {
+        return down;
+    }
+    
+    return current;
+}
+
+/**
+ * @brief Posodobi stanje in obvesti callback samo ob dejanski spremembi
+ */
+static void publish_status(bool connected, const char *ip, int8_t rssi)
+{
+    wifi_manager_status_t snapshot;
+    bool changed;
+    
+    portENTER_CRITICAL(&s_status_mux);
+    uint8_t bars = connected ? rssi_to_bars_hyst(rssi, s_status.connected ? s_status.bars : 0) : 0;
+    
+    changed = (connected != s_status.connected) || (bars != s_status.bars) ||
+              (ip != NULL && strcmp(ip, s_status.ip) != 0);
+    
+    s_status.connected = connected;
+    s_status.rssi = rssi;
+    s_status.bars = bars;
+    if (ip != NULL) {
+        strlcpy(s_status.ip, ip, sizeof(s_status.ip));
+    } else if (!connected) {
+        s_status.ip[0] = '\0';
+    }
+    snapshot = s_status;
+    portEXIT_CRITICAL(&s_status_mux);
+    
+    if (changed && s_status_callback) {
+        s_status_callback(&snapshot);
+    }
+}
+
+static void rssi_timer_cb(void *arg)
+{
+    wifi_ap_record_t ap_info;
+    
+    if (esp_wifi_sta_get_ap_info(&ap_info) == ESP_OK) {
+        publish_status(true, NULL, ap_info.rssi);
+    }
+}
+
+static bool load_fast_cache(wifi_fast_cache_t *cache)
+{
+    nvs_handle_t nvs;
+    size_t len = sizeof(*cache);
+    
+    if (nvs_open(NVS_NAMESPACE, NVS_READONLY, &nvs) != ESP_OK) {
+        return false;
+    }
+    esp_err_t ret = nvs_get_blob(nvs, NVS_KEY_FAST, cache, &len);
+    nvs_close(nvs);
+    
+    return ret == ESP_OK && len == sizeof(*cache);
+}
+
+static void save_fast_cache(const wifi_fast_cache_t *cache)
+{
+    nvs_handle_t nvs;
+    
+    if (nvs_open(NVS_NAMESPACE, NVS_READWRITE, &nvs) != ESP_OK) {
+        return;
+    }
+    if (nvs_set_blob(nvs, NVS_KEY_FAST, cache, sizeof(*cache)) == ESP_OK) {
+        nvs_commit(nvs);
+    }
+    nvs_close(nvs);
+}
+
+static void reconnect_timer_cb(void *arg)
+{
+    esp_wifi_connect();
+}
+
+/**
+ * @brief Naslednji poskus po backoff-u (±jitter, da se naprave ne sinhronizirajo)
+ */
+static void schedule_reconnect(void)
+{
+    uint32_t jitter = s_backoff_ms * BACKOFF_JITTER_PCT / 100;
+    uint32_t delay_ms = s_backoff_ms - jitter + (jitter > 0 ? esp_random() % (2 * jitter + 1) : 0);
+    
+    ESP_LOGW(TAG, "Reconnect attempt %d in %lu ms", s_retry_num, (unsigned long)delay_ms);
+    
+    esp_timer_stop(s_reconnect_timer);
+    esp_timer_start_once(s_reconnect_timer, (uint64_t)delay_ms * 1000);
+    
+    s_backoff_ms = (s_backoff_ms >= BACKOFF_MAX_MS / 2) ? BACKOFF_MAX_MS : s_backoff_ms * 2;
+}
+
 static void wifi_event_handler(void *arg, esp_event_base_t event_base,
                                 int32_t event_id, void *event_data)
 {
     if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_START) {
+        s_link_lost_us = esp_timer_get_time();
         esp_wifi_connect();
-        ESP_LOGI(TAG, "WiFi started, connecting...");
+        ESP_LOGI(TAG, "WiFi started, connecting%s...", s_wifi_config.sta.bssid_set ? " (cached AP)" : "");
     } 
+    else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_CONNECTED) {
+        wifi_event_sta_connected_t *event = (wifi_event_sta_connected_t *)event_data;
+        
+        // Zapiši v NVS samo ob spremembi (flash wear)
+        if (!s_fast_cache_valid || event->channel != s_fast_cache.channel ||
+            memcmp(event->bssid, s_fast_cache.bssid, sizeof(s_fast_cache.bssid)) != 0) {
+            memcpy(s_fast_cache.ssid, s_wifi_config.sta.ssid, sizeof(s_fast_cache.ssid));
+            memcpy(s_fast_cache.bssid, event->bssid, sizeof(s_fast_cache.bssid));
+            s_fast_cache.channel = event->channel;
+            s_fast_cache_valid = true;
+            save_fast_cache(&s_fast_cache);
+            ESP_LOGI(TAG, "Cached AP " MACSTR " on channel %d", MAC2STR(event->bssid), event->channel);
+        }
+        
+        // Po fallbacku na polni scan (ali novem AP) naj naslednji reconnect
+        // spet gre direktno na ta AP in kanal
+        if (!s_wifi_config.sta.bssid_set || s_wifi_config.sta.channel != s_fast_cache.channel ||
+            memcmp(s_wifi_config.sta.bssid, s_fast_cache.bssid, sizeof(s_fast_cache.bssid)) != 0) {
+            memcpy(s_wifi_config.sta.bssid, s_fast_cache.bssid, sizeof(s_wifi_config.sta.bssid));
+            s_wifi_config.sta.channel = s_fast_cache.channel;
+            s_wifi_config.sta.bssid_set = true;
+            s_wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+            s_config_pending = true;
+        }
+    }
     else if (event_base == WIFI_EVENT && event_id == WIFI_EVENT_STA_DISCONNECTED) {
-        if (s_retry_num < MAX_RETRY) {
-            esp_wifi_connect();
-            s_retry_num++;
-            ESP_LOGW(TAG, "Retry connecting to WiFi... (%d/%d)", s_retry_num, MAX_RETRY);
-        } else {
+        bool was_connected = (xEventGroupGetBits(s_wifi_event_group) & WIFI_CONNECTED_BIT) != 0;
+        
+        if (was_connected) {
+            s_link_lost_us = esp_timer_get_time();
+            ESP_LOGW(TAG, "WiFi link lost");
+        }
+        
+        s_retry_num++;
+        if (s_retry_num == MAX_RETRY) {
             xEventGroupSetBits(s_wifi_event_group, WIFI_FAIL_BIT);
-            ESP_LOGE(TAG, "Failed to connect to WiFi after %d attempts", MAX_RETRY);
+            ESP_LOGE(TAG, "Failed to connect to WiFi after %d attempts, retrying in background", MAX_RETRY);
         }
         
-        if (s_event_callback) {
-            s_event_callback(false, NULL);
+        if (s_wifi_config.sta.bssid_set && !was_connected) {
+            // Cached AP ni dosegljiv (zamenjan router, drug kanal) → polni scan
+            ESP_LOGW(TAG, "Cached AP unreachable, falling back to full scan");
+            s_wifi_config.sta.bssid_set = false;
+            s_wifi_config.sta.channel = 0;
+            s_wifi_config.sta.scan_method = WIFI_ALL_CHANNEL_SCAN;
+            esp_wifi_set_config(WIFI_IF_STA, &s_wifi_config);
+            s_config_pending = false;
+        } else if (s_config_pending) {
+            // Povezava je padla - zdaj lahko zamenjamo config brez prekinitve
+            esp_wifi_set_config(WIFI_IF_STA, &s_wifi_config);
+            s_config_pending = false;
         }
+        
+        schedule_reconnect();
+        
+        xEventGroupClearBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
+        esp_timer_stop(s_rssi_timer);
+        publish_status(false, NULL, -100);
     } 
     else if (event_base == IP_EVENT && event_id == IP_EVENT_STA_GOT_IP) {
         ip_event_got_ip_t *event = (ip_event_got_ip_t *)event_data;
         snprintf(s_ip_address, sizeof(s_ip_address), IPSTR, IP2STR(&event->ip_info.ip));
         
-        ESP_LOGI(TAG, "WiFi connected! IP: %s", s_ip_address);
+        int64_t elapsed_ms = (esp_timer_get_time() - s_link_lost_us) / 1000;
+        ESP_LOGI(TAG, "WiFi connected! IP: %s (%lld ms, %d retries)", 
+                 s_ip_address, (long long)elapsed_ms, s_retry_num);
+        
         s_retry_num = 0;
+        s_backoff_ms = BACKOFF_MIN_MS;
+        esp_timer_stop(s_reconnect_timer);
+        xEventGroupClearBits(s_wifi_event_group, WIFI_FAIL_BIT);
         xEventGroupSetBits(s_wifi_event_group, WIFI_CONNECTED_BIT);
         
-        if (s_event_callback) {
-            s_event_callback(true, s_ip_address);
-        }
+        publish_status(true, s_ip_address, wifi_manager_get_rssi());
+        esp_timer_stop(s_rssi_timer);
+        esp_timer_start_periodic(s_rssi_timer, (uint64_t)RSSI_SAMPLE_MS * 1000);
     }
 }
 
@@ -72,6 +282,18 @@ esp_err_t wifi_manager_init(void)
     
     s_wifi_event_group = xEventGroupCreate();
     
+    const esp_timer_create_args_t rssi_timer_args = {
+        .callback = rssi_timer_cb,
+        .name = "wifi_rssi",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&rssi_timer_args, &s_rssi_timer));
+    
+    const esp_timer_create_args_t reconnect_timer_args = {
+        .callback = reconnect_timer_cb,
+        .name = "wifi_reconnect",
+    };
+    ESP_ERROR_CHECK(esp_timer_create(&reconnect_timer_args, &s_reconnect_timer));
+    
     ESP_ERROR_CHECK(esp_netif_init());
     ESP_ERROR_CHECK(esp_event_loop_create_default());
     esp_netif_create_default_wifi_sta();
@@ -116,6 +338,20 @@ esp_err_t wifi_manager_connect(const char *ssid, const char *password, uint32_t
     wifi_config.sta.pmf_cfg.capable = true;
     wifi_config.sta.pmf_cfg.required = false;
     
+    // Fast reconnect: znan AP → brez skeniranja vseh kanalov
+    s_fast_cache_valid = load_fast_cache(&s_fast_cache);
+    if (s_fast_cache_valid &&
+        memcmp(s_fast_cache.ssid, wifi_config.sta.ssid, sizeof(s_fast_cache.ssid)) == 0) {
+        memcpy(wifi_config.sta.bssid, s_fast_cache.bssid, sizeof(wifi_config.sta.bssid));
+        wifi_config.sta.bssid_set = true;
+        wifi_config.sta.channel = s_fast_cache.channel;
+        wifi_config.sta.scan_method = WIFI_FAST_SCAN;
+    } else {
+        s_fast_cache_valid = false;
+    }
+    s_wifi_config = wifi_config;
+    s_config_pending = false;
+    
     ESP_ERROR_CHECK(esp_wifi_set_mode(WIFI_MODE_STA));
     ESP_ERROR_CHECK(esp_wifi_set_config(WIFI_IF_STA, &wifi_config));
     ESP_ERROR_CHECK(esp_wifi_start());
@@ -160,9 +396,18 @@ void wifi_manager_get_ip(char *ip_str, size_t max_len)
     }
 }
 
-void wifi_manager_register_callback(wifi_event_callback_t callback)
+void wifi_manager_register_status_callback(wifi_status_callback_t callback)
 {
-    s_event_callback = callback;
+    s_status_callback = callback;
+}
+
+void wifi_manager_get_status(wifi_manager_status_t *status)
+{
+    if (status == NULL) return;
+    
+    portENTER_CRITICAL(&s_status_mux);
+    *status = s_status;
+    portEXIT_CRITICAL(&s_status_mux);
 }
 
 int8_t wifi_manager_get_rssi(void)
@@ -0,0 +1,90 @@
+/**
+ * @file bench_sensor_history.c
+ * @brief Prepustnost sensor_history: push in branje statistik
+ *
+ *   bench_sensor_history [pushes]
+ *
+ * Najslabši primer za deque je monotono zaporedje (ena stran vedno polna),
+ * najboljši konstanta. Izpiše ns na operacijo - na hostu, ne na ESP32.
+ */
+#include "sensor_history.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static sensor_history_t s_history;
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef float (*signal_fn_t)(long i);
+
+static float signal_noise(long i)
+{
+    static uint32_t rng = 1;
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return 20.0f + (rng >> 8) / 16777216.0f + (i % 3600) * 0.0005f;
+}
+
+static float signal_ramp(long i)
+{
+    return -20.0f + (i % 6000) * 0.01f;     // Naraščajoče → poln min deque
+}
+
+static float signal_flat(long i)
+{
+    (void)i;
+    return 21.0f;
+}
+
+static void bench_push(const char *name, signal_fn_t signal, long pushes)
+{
+    sensor_history_init(&s_history, 2000);
+
+    double t0 = now_s();
+    for (long i = 0; i < pushes; i++) {
+        sensor_history_push(&s_history, (uint32_t)(i * 2000), signal(i), 45.0f);
+    }
+    double dt = now_s() - t0;
+
+    printf("push  %-6s %9ld samples  %7.1f ns/push  %6.2f M/s\n",
+           name, pushes, dt * 1e9 / pushes, pushes / dt / 1e6);
+}
+
+static void bench_stats(long reads)
+{
+    sensor_window_stats_t st;
+    volatile float sink = 0.0f;
+
+    double t0 = now_s();
+    for (long i = 0; i < reads; i++) {
+        sensor_history_get_stats(&s_history, (sensor_window_t)(i % SENSOR_WINDOW_COUNT), &st);
+        sink += st.mean;
+    }
+    double dt = now_s() - t0;
+    (void)sink;
+
+    printf("stats         %9ld reads    %7.1f ns/read\n", reads, dt * 1e9 / reads);
+}
+
+int main(int argc, char **argv)
+{
+    long pushes = (argc > 1) ? atol(argv[1]) : 2000000;
+    if (pushes < 1) {
+        pushes = 1;
+    }
+
+    printf("sensor_history_t: %zu B (ring %zu B, deque pool %zu B)\n",
+           sizeof(sensor_history_t), sizeof(s_history.ring), sizeof(s_history.deque_pool));
+    bench_push("noise", signal_noise, pushes);
+    bench_push("ramp", signal_ramp, pushes);
+    bench_push("flat", signal_flat, pushes);
+    bench_stats(pushes);
+    return 0;
+}
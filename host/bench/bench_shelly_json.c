@@ -0,0 +1,130 @@
+/**
+ * @file bench_shelly_json.c
+ * @brief Prepustnost shelly_json na posnetih Shelly odgovorih
+ *
+ *   bench_shelly_json <korpus> [ponovitev]
+ *
+ * Vsak dokument se parsa v enem kosu in v 512 B kosih (ON_DATA iz
+ * esp_http_client), callback pa išče ista polja kot shelly_manager.
+ * Izpiše ns/byte in MB/s - na hostu, ne na ESP32.
+ */
+#include "shelly_json.h"
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static double now_s(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+typedef struct {
+    float power;
+    float temperature;
+    bool output;
+    uint32_t values;
+} fields_t;
+
+/**
+ * @brief Enako iskanje poti kot status_value_cb / rpc_status_value_cb
+ */
+static void fields_cb(const shelly_json_t *parser, shelly_json_type_t type, const char *value, void *ctx)
+{
+    fields_t *f = ctx;
+    int idx = -1;
+
+    f->values++;
+    if (type == SHELLY_JSON_TRUE || type == SHELLY_JSON_FALSE) {
+        if (shelly_json_match(parser, "relays.[].ison", &idx) ||
+            shelly_json_match(parser, "switch:0.output", NULL) ||
+            shelly_json_match(parser, "output", NULL) ||
+            shelly_json_match(parser, "[].result.output", NULL)) {
+            f->output = (type == SHELLY_JSON_TRUE);
+        }
+    } else if (type == SHELLY_JSON_NUMBER) {
+        if (shelly_json_match(parser, "meters.[].power", &idx) ||
+            shelly_json_match(parser, "switch:0.apower", NULL) ||
+            shelly_json_match(parser, "apower", NULL) ||
+            shelly_json_match(parser, "[].result.apower", NULL)) {
+            f->power = strtof(value, NULL);
+        } else if (shelly_json_match(parser, "tmp.tC", NULL) ||
+                   shelly_json_match(parser, "switch:0.temperature.tC", NULL) ||
+                   shelly_json_match(parser, "temperature.tC", NULL)) {
+            f->temperature = strtof(value, NULL);
+        }
+    }
+}
+
+static void bench_file(const char *name, const char *data, size_t len, long iterations)
+{
+    static const size_t chunks[] = { 0, 512 };
+    fields_t fields;
+
+    for (size_t k = 0; k < sizeof(chunks) / sizeof(chunks[0]); k++) {
+        size_t chunk = chunks[k] ? chunks[k] : len;
+
+        double t0 = now_s();
+        for (long i = 0; i < iterations; i++) {
+            shelly_json_t parser;
+            memset(&fields, 0, sizeof(fields));
+            shelly_json_init(&parser, fields_cb, &fields);
+            for (size_t off = 0; off < len; off += chunk) {
+                shelly_json_feed(&parser, data + off, (len - off < chunk) ? len - off : chunk);
+            }
+        }
+        double dt = now_s() - t0;
+
+        printf("%-28s %5zu B  chunk %4s  %3u values  %6.2f ns/B  %7.1f MB/s  %6.2f us/doc\n",
+               name, len, chunks[k] ? "512" : "all", (unsigned)fields.values,
+               dt * 1e9 / ((double)len * iterations), (double)len * iterations / dt / 1e6,
+               dt * 1e6 / iterations);
+    }
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2) {
+        fprintf(stderr, "usage: %s <corpus dir> [iterations]\n", argv[0]);
+        return 1;
+    }
+    long iterations = (argc > 2) ? atol(argv[2]) : 20000;
+    if (iterations < 1) {
+        iterations = 1;
+    }
+
+    DIR *dir = opendir(argv[1]);
+    if (dir == NULL) {
+        fprintf(stderr, "Cannot open corpus %s\n", argv[1]);
+        return 1;
+    }
+
+    printf("sizeof(shelly_json_t) = %zu B (na skladu klicatelja, brez alokacij)\n",
+           sizeof(shelly_json_t));
+
+    struct dirent *ent;
+    static char data[8192];
+    while ((ent = readdir(dir)) != NULL) {
+        size_t name_len = strlen(ent->d_name);
+        if (name_len < 6 || strcmp(ent->d_name + name_len - 5, ".json") != 0 ||
+            strncmp(ent->d_name, "bad_", 4) == 0) {
+            continue;
+        }
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", argv[1], ent->d_name);
+        FILE *f = fopen(path, "rb");
+        if (f == NULL) {
+            continue;
+        }
+        size_t len = fread(data, 1, sizeof(data), f);
+        fclose(f);
+
+        bench_file(ent->d_name, data, len, iterations);
+    }
+    closedir(dir);
+    return 0;
+}
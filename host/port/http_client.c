@@ -0,0 +1,368 @@
+/**
+ * @file http_client.c
+ * @brief Host nadomestek za esp_http_client na POSIX socketih
+ *
+ * Ena TCP povezava na handle, ki ostane odprta med perform klici
+ * (keep-alive), dokler je strežnik ne zapre. Kot pri pravem odjemalcu se
+ * mrtva povezava pokaže šele ob naslednjem perform (napaka pri pošiljanju
+ * ali branju glave) - ponovno povezavo opravi klicatelj.
+ */
+#include "host_port.h"
+#include "esp_http_client.h"
+#include <arpa/inet.h>
+#include <errno.h>
+#include <netinet/in.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#define HTTP_HEADER_MAX     1024
+#define HTTP_DEFAULT_CHUNK  512
+
+struct esp_http_client {
+    char host[64];
+    int port;
+    char path[160];
+    int fd;                             // -1 = povezava zaprta
+    int timeout_ms;
+    int chunk;
+    http_event_handle_cb handler;
+    void *user_data;
+    esp_http_client_method_t method;
+    char content_type[64];
+    const char *post_data;
+    int post_len;
+    int status_code;
+};
+
+static int s_timeout_override_ms = 0;
+
+void host_http_set_timeout_ms(int timeout_ms)
+{
+    s_timeout_override_ms = timeout_ms;
+}
+
+static void dispatch(esp_http_client_handle_t client, esp_http_client_event_id_t id, void *data, int len)
+{
+    if (client->handler == NULL) {
+        return;
+    }
+    esp_http_client_event_t evt = {
+        .event_id = id,
+        .client = client,
+        .data = data,
+        .data_len = len,
+        .user_data = client->user_data,
+    };
+    client->handler(&evt);
+}
+
+static void close_connection(esp_http_client_handle_t client)
+{
+    if (client->fd >= 0) {
+        close(client->fd);
+        client->fd = -1;
+        dispatch(client, HTTP_EVENT_DISCONNECTED, NULL, 0);
+    }
+}
+
+/**
+ * @brief "http://host[:port]/pot" → host, port, pot
+ */
+static esp_err_t parse_url(esp_http_client_handle_t client, const char *url)
+{
+    static const char prefix[] = "http://";
+
+    if (url == NULL || strncmp(url, prefix, sizeof(prefix) - 1) != 0) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    const char *host = url + sizeof(prefix) - 1;
+    const char *path = strchr(host, '/');
+    size_t host_len = path ? (size_t)(path - host) : strlen(host);
+    char authority[sizeof(client->host)];
+
+    if (host_len == 0 || host_len >= sizeof(authority)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    memcpy(authority, host, host_len);
+    authority[host_len] = '\0';
+
+    int port = 80;
+    char *colon = strchr(authority, ':');
+    if (colon) {
+        *colon = '\0';
+        port = atoi(colon + 1);
+    }
+
+    // Druga naprava → obstoječa povezava ni več uporabna
+    if (client->fd >= 0 && (strcmp(client->host, authority) != 0 || client->port != port)) {
+        close_connection(client);
+    }
+
+    snprintf(client->host, sizeof(client->host), "%s", authority);
+    client->port = port;
+    snprintf(client->path, sizeof(client->path), "%s", path ? path : "/");
+    return ESP_OK;
+}
+
+esp_http_client_handle_t esp_http_client_init(const esp_http_client_config_t *config)
+{
+    if (config == NULL) {
+        return NULL;
+    }
+
+    esp_http_client_handle_t client = calloc(1, sizeof(*client));
+    if (client == NULL) {
+        return NULL;
+    }
+    client->fd = -1;
+    client->timeout_ms = config->timeout_ms > 0 ? config->timeout_ms : 5000;
+    client->chunk = config->buffer_size > 0 ? config->buffer_size : HTTP_DEFAULT_CHUNK;
+    client->handler = config->event_handler;
+    client->user_data = config->user_data;
+
+    if (parse_url(client, config->url) != ESP_OK) {
+        free(client);
+        return NULL;
+    }
+    return client;
+}
+
+esp_err_t esp_http_client_set_url(esp_http_client_handle_t client, const char *url)
+{
+    return client ? parse_url(client, url) : ESP_ERR_INVALID_ARG;
+}
+
+esp_err_t esp_http_client_set_method(esp_http_client_handle_t client, esp_http_client_method_t method)
+{
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->method = method;
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_header(esp_http_client_handle_t client, const char *key, const char *value)
+{
+    if (client == NULL || key == NULL || value == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    // Shelly uporablja samo Content-Type
+    if (strcasecmp(key, "Content-Type") == 0) {
+        snprintf(client->content_type, sizeof(client->content_type), "%s", value);
+    }
+    return ESP_OK;
+}
+
+esp_err_t esp_http_client_set_post_field(esp_http_client_handle_t client, const char *data, int len)
+{
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->post_data = data;
+    client->post_len = data ? len : 0;
+    return ESP_OK;
+}
+
+static esp_err_t connect_socket(esp_http_client_handle_t client)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_port = htons((uint16_t)client->port),
+    };
+    if (inet_pton(AF_INET, client->host, &addr.sin_addr) != 1) {
+        return ESP_ERR_HTTP_CONNECT;    // Na hostu samo IPv4 naslovi, brez DNS
+    }
+
+    int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0) {
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    int timeout_ms = s_timeout_override_ms > 0 ? s_timeout_override_ms : client->timeout_ms;
+    struct timeval tv = {
+        .tv_sec = timeout_ms / 1000,
+        .tv_usec = (timeout_ms % 1000) * 1000,
+    };
+    setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+
+    if (connect(fd, (struct sockaddr *)&addr, sizeof(addr)) != 0) {
+        close(fd);
+        return ESP_ERR_HTTP_CONNECT;
+    }
+
+    client->fd = fd;
+    dispatch(client, HTTP_EVENT_ON_CONNECTED, NULL, 0);
+    return ESP_OK;
+}
+
+static bool send_all(int fd, const char *data, size_t len)
+{
+    while (len > 0) {
+        ssize_t n = send(fd, data, len, MSG_NOSIGNAL);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        len -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Vrednost glave (brez presledkov na začetku), NULL če je ni
+ */
+static const char *find_header(const char *headers, const char *name)
+{
+    size_t name_len = strlen(name);
+
+    for (const char *line = strstr(headers, "\r\n"); line; line = strstr(line, "\r\n")) {
+        line += 2;
+        if (strncasecmp(line, name, name_len) == 0 && line[name_len] == ':') {
+            const char *value = line + name_len + 1;
+            while (*value == ' ') {
+                value++;
+            }
+            return value;
+        }
+    }
+    return NULL;
+}
+
+/**
+ * @brief Pošlje telo odgovora handlerju v kosih velikosti chunk
+ */
+static void deliver(esp_http_client_handle_t client, char *data, int len)
+{
+    for (int offset = 0; offset < len; offset += client->chunk) {
+        int n = (len - offset < client->chunk) ? len - offset : client->chunk;
+        dispatch(client, HTTP_EVENT_ON_DATA, data + offset, n);
+    }
+}
+
+esp_err_t esp_http_client_perform(esp_http_client_handle_t client)
+{
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    client->status_code = 0;
+    if (client->fd < 0) {
+        esp_err_t err = connect_socket(client);
+        if (err != ESP_OK) {
+            return err;
+        }
+    }
+
+    bool post = (client->method == HTTP_METHOD_POST);
+    char request[512];
+    int len = snprintf(request, sizeof(request),
+                       "%s %s HTTP/1.1\r\nHost: %s\r\nUser-Agent: ESP32 HTTP Client/1.0\r\n",
+                       post ? "POST" : "GET", client->path, client->host);
+    if (post) {
+        if (client->content_type[0]) {
+            len += snprintf(request + len, sizeof(request) - len, "Content-Type: %s\r\n",
+                            client->content_type);
+        }
+        len += snprintf(request + len, sizeof(request) - len, "Content-Length: %d\r\n",
+                        client->post_len);
+    }
+    len += snprintf(request + len, sizeof(request) - len, "\r\n");
+
+    if (!send_all(client->fd, request, (size_t)len) ||
+        (post && client->post_len > 0 && !send_all(client->fd, client->post_data, (size_t)client->post_len))) {
+        close_connection(client);
+        return ESP_ERR_HTTP_WRITE_DATA;
+    }
+    dispatch(client, HTTP_EVENT_HEADERS_SENT, NULL, 0);
+
+    // Glava odgovora (in morebitni začetek telesa)
+    char buf[HTTP_HEADER_MAX + 1];
+    int have = 0;
+    char *body = NULL;
+    while (body == NULL) {
+        if (have == HTTP_HEADER_MAX) {
+            close_connection(client);
+            return ESP_ERR_HTTP_FETCH_HEADER;
+        }
+        ssize_t n = recv(client->fd, buf + have, HTTP_HEADER_MAX - have, 0);
+        if (n <= 0) {
+            bool timeout = (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK));
+            close_connection(client);
+            return timeout ? ESP_ERR_HTTP_EAGAIN : ESP_ERR_HTTP_FETCH_HEADER;
+        }
+        have += (int)n;
+        buf[have] = '\0';
+        body = strstr(buf, "\r\n\r\n");
+    }
+    body[2] = '\0';     // Glave se končajo z zadnjim \r\n
+    body += 4;
+    int body_have = have - (int)(body - buf);
+
+    int major = 0, minor = 0;
+    if (sscanf(buf, "HTTP/%d.%d %d", &major, &minor, &client->status_code) != 3) {
+        close_connection(client);
+        return ESP_ERR_HTTP_FETCH_HEADER;
+    }
+
+    const char *value = find_header(buf, "Content-Length");
+    int content_length = value ? atoi(value) : -1;
+    value = find_header(buf, "Connection");
+    bool close_after = (value && strncasecmp(value, "close", 5) == 0) || content_length < 0;
+
+    if (content_length >= 0 && body_have > content_length) {
+        body_have = content_length;
+    }
+    deliver(client, body, body_have);
+
+    int remaining = content_length >= 0 ? content_length - body_have : -1;
+    char *rx = malloc((size_t)client->chunk);
+    if (rx == NULL) {
+        close_connection(client);
+        return ESP_ERR_NO_MEM;
+    }
+    while (remaining != 0) {
+        int want = (remaining < 0 || remaining > client->chunk) ? client->chunk : remaining;
+        ssize_t n = recv(client->fd, rx, (size_t)want, 0);
+        if (n <= 0) {
+            if (remaining < 0 && n == 0) {
+                break;      // Telo brez Content-Length se konča z zaprtjem
+            }
+            free(rx);
+            close_connection(client);
+            return ESP_FAIL;
+        }
+        dispatch(client, HTTP_EVENT_ON_DATA, rx, (int)n);
+        if (remaining > 0) {
+            remaining -= (int)n;
+        }
+    }
+    free(rx);
+
+    dispatch(client, HTTP_EVENT_ON_FINISH, NULL, 0);
+    if (close_after) {
+        close_connection(client);
+    }
+    return ESP_OK;
+}
+
+int esp_http_client_get_status_code(esp_http_client_handle_t client)
+{
+    return client ? client->status_code : -1;
+}
+
+esp_err_t esp_http_client_cleanup(esp_http_client_handle_t client)
+{
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    close_connection(client);
+    free(client);
+    return ESP_OK;
+}
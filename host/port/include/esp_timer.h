@@ -0,0 +1,31 @@
+/**
+ * @file esp_timer.h
+ * @brief Host nadomestek za esp_timer (navidezna ura + one-shot timerji)
+ *
+ * Čas je navidezen (host_clock_*), zato replay teče hitreje od realnega
+ * časa in je ponovljiv. Brez nastavljanja ura stoji na 0. Pretečene
+ * timerje pokliče host_clock_set_us/advance_us v klicočem threadu.
+ */
+#ifndef HOST_ESP_TIMER_H
+#define HOST_ESP_TIMER_H
+
+#include "esp_err.h"
+#include <stdint.h>
+
+typedef struct esp_timer *esp_timer_handle_t;
+typedef void (*esp_timer_cb_t)(void *arg);
+
+typedef struct {
+    esp_timer_cb_t callback;
+    void *arg;
+    const char *name;
+} esp_timer_create_args_t;
+
+int64_t esp_timer_get_time(void);
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle);
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us);
+esp_err_t esp_timer_stop(esp_timer_handle_t timer);
+esp_err_t esp_timer_delete(esp_timer_handle_t timer);
+
+#endif // HOST_ESP_TIMER_H
@@ -0,0 +1,58 @@
+/**
+ * @file esp_websocket_client.h
+ * @brief Host nadomestek za esp_websocket_client (brez omrežja)
+ *
+ * Odjemalec se nikamor ne poveže - test sam sproži dogodke prek
+ * host_ws_event() in tako poda poljubno razrezane okvirje.
+ */
+#ifndef ESP_WEBSOCKET_CLIENT_H
+#define ESP_WEBSOCKET_CLIENT_H
+
+#include "esp_err.h"
+#include "freertos/FreeRTOS.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+typedef const char *esp_event_base_t;
+typedef void (*esp_event_handler_t)(void *arg, esp_event_base_t base, int32_t event_id, void *event_data);
+
+typedef struct esp_websocket_client *esp_websocket_client_handle_t;
+
+typedef enum {
+    WEBSOCKET_EVENT_ANY = -1,
+    WEBSOCKET_EVENT_ERROR = 0,
+    WEBSOCKET_EVENT_CONNECTED,
+    WEBSOCKET_EVENT_DISCONNECTED,
+    WEBSOCKET_EVENT_DATA,
+    WEBSOCKET_EVENT_CLOSED,
+} esp_websocket_event_id_t;
+
+typedef struct {
+    const char *data_ptr;
+    int data_len;
+    bool fin;
+    uint8_t op_code;
+    esp_websocket_client_handle_t client;
+    void *user_context;
+    int payload_len;
+    int payload_offset;
+} esp_websocket_event_data_t;
+
+typedef struct {
+    const char *uri;
+    int reconnect_timeout_ms;
+    int network_timeout_ms;
+    int task_stack;
+} esp_websocket_client_config_t;
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config);
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t client, esp_websocket_event_id_t event,
+                                        esp_event_handler_t handler, void *arg);
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t client);
+esp_err_t esp_websocket_client_set_uri(esp_websocket_client_handle_t client, const char *uri);
+int esp_websocket_client_send_text(esp_websocket_client_handle_t client, const char *data, int len,
+                                   TickType_t timeout);
+
+#endif // ESP_WEBSOCKET_CLIENT_H
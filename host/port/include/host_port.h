@@ -0,0 +1,58 @@
+/**
+ * @file host_port.h
+ * @brief Upravljanje host nadomestka ESP-IDF/FreeRTOS (navidezna ura, HTTP, WebSocket)
+ */
+#ifndef HOST_PORT_H
+#define HOST_PORT_H
+
+#include "esp_websocket_client.h"
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Nastavi navidezni čas, ki ga vrača esp_timer_get_time()
+ * @param now_us Čas v µs
+ */
+void host_clock_set_us(int64_t now_us);
+
+/**
+ * @brief Premakni navidezni čas naprej
+ * @param delta_us Korak v µs
+ */
+void host_clock_advance_us(int64_t delta_us);
+
+/**
+ * @brief Povozi timeout vseh novih HTTP povezav (0 = timeout_ms iz konfiguracije)
+ *
+ * Testi s tem skrajšajo 5 s timeout shelly_manager-ja.
+ *
+ * @param timeout_ms Timeout branja/pisanja v ms
+ */
+void host_http_set_timeout_ms(int timeout_ms);
+
+/**
+ * @brief Stanje nadomestnega WebSocket odjemalca
+ */
+typedef struct {
+    bool running;           // Med start in stop
+    char uri[64];           // Trenutni URI (prazen, če odjemalca ni)
+    uint32_t starts;        // esp_websocket_client_start klici
+    uint32_t stops;         // esp_websocket_client_stop klici
+    uint32_t texts_sent;    // esp_websocket_client_send_text klici
+} host_ws_stats_t;
+
+/**
+ * @brief Pokliči handler odjemalca, kot bi ga WebSocket task
+ * @param event_id WEBSOCKET_EVENT_*
+ * @param data Podatki dogodka (NULL za CONNECTED/DISCONNECTED)
+ * @return False če odjemalec ni zagnan
+ */
+bool host_ws_event(int32_t event_id, esp_websocket_event_data_t *data);
+
+/**
+ * @brief Vrne stanje nadomestnega WebSocket odjemalca
+ * @param stats Output struktura
+ */
+void host_ws_get_stats(host_ws_stats_t *stats);
+
+#endif // HOST_PORT_H
@@ -0,0 +1,24 @@
+/**
+ * @file sdkconfig.h
+ * @brief Privzete Kconfig vrednosti (main/Kconfig.projbuild) za host build
+ *
+ * PID varianto replay-a prevedemo z -DCONFIG_THERMOSTAT_CONTROL_PID=1,
+ * kot bi jo izbral menuconfig.
+ */
+#ifndef HOST_SDKCONFIG_H
+#define HOST_SDKCONFIG_H
+
+#define CONFIG_THERMOSTAT_TEMP_HYSTERESIS           5
+#define CONFIG_THERMOSTAT_TEMP_HYSTERESIS_ABOVE     3
+
+#if CONFIG_THERMOSTAT_CONTROL_PID
+#define CONFIG_THERMOSTAT_PID_KP                    50
+#define CONFIG_THERMOSTAT_PID_TI_S                  3600
+#define CONFIG_THERMOSTAT_PID_TD_S                  600
+#define CONFIG_THERMOSTAT_PID_CYCLE_S               900
+#define CONFIG_THERMOSTAT_PID_MIN_ON_OFF_S          180
+#else
+#define CONFIG_THERMOSTAT_CONTROL_HYSTERESIS        1
+#endif
+
+#endif // HOST_SDKCONFIG_H
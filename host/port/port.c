@@ -0,0 +1,449 @@
+/**
+ * @file port.c
+ * @brief Host nadomestek za ESP-IDF/FreeRTOS (pthreads + navidezna ura)
+ *
+ * Dovolj za prevajanje komponent, ki so odvisne le od esp_err, esp_log,
+ * esp_timer in osnovnih FreeRTOS primitivov. Timeouti semaforjev in vrst
+ * tečejo v realnem času, esp_timer_get_time() in one-shot timerji pa
+ * navidezni čas.
+ */
+#include "host_port.h"
+#include "esp_err.h"
+#include "esp_http_client.h"
+#include "esp_log.h"
+#include "esp_timer.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/semphr.h"
+#include "freertos/queue.h"
+#include <errno.h>
+#include <sched.h>
+#include <stdarg.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+// ═══════════════════════════════════════════════════════════
+// esp_err / esp_log
+// ═══════════════════════════════════════════════════════════
+
+const char *esp_err_to_name(esp_err_t code)
+{
+    switch (code) {
+        case ESP_OK:                    return "ESP_OK";
+        case ESP_FAIL:                  return "ESP_FAIL";
+        case ESP_ERR_NO_MEM:            return "ESP_ERR_NO_MEM";
+        case ESP_ERR_INVALID_ARG:       return "ESP_ERR_INVALID_ARG";
+        case ESP_ERR_INVALID_STATE:     return "ESP_ERR_INVALID_STATE";
+        case ESP_ERR_INVALID_SIZE:      return "ESP_ERR_INVALID_SIZE";
+        case ESP_ERR_NOT_FOUND:         return "ESP_ERR_NOT_FOUND";
+        case ESP_ERR_NOT_SUPPORTED:     return "ESP_ERR_NOT_SUPPORTED";
+        case ESP_ERR_TIMEOUT:           return "ESP_ERR_TIMEOUT";
+        case ESP_ERR_INVALID_RESPONSE:  return "ESP_ERR_INVALID_RESPONSE";
+        case ESP_ERR_INVALID_CRC:       return "ESP_ERR_INVALID_CRC";
+        case ESP_ERR_NOT_FINISHED:      return "ESP_ERR_NOT_FINISHED";
+        case ESP_ERR_HTTP_CONNECT:      return "ESP_ERR_HTTP_CONNECT";
+        case ESP_ERR_HTTP_WRITE_DATA:   return "ESP_ERR_HTTP_WRITE_DATA";
+        case ESP_ERR_HTTP_FETCH_HEADER: return "ESP_ERR_HTTP_FETCH_HEADER";
+        case ESP_ERR_HTTP_EAGAIN:       return "ESP_ERR_HTTP_EAGAIN";
+        default:                        return "UNKNOWN ERROR";
+    }
+}
+
+static esp_log_level_t s_log_level = ESP_LOG_WARN;
+
+void esp_log_level_set(const char *tag, esp_log_level_t level)
+{
+    (void)tag;      // Na hostu en nivo za vse tage
+    s_log_level = level;
+}
+
+void host_log_write(esp_log_level_t level, const char *tag, const char *format, ...)
+{
+    static const char letters[] = "NEWIDV";
+
+    if (level > s_log_level) {
+        return;
+    }
+
+    fprintf(stderr, "%c (%lld) %s: ", letters[level],
+            (long long)(esp_timer_get_time() / 1000), tag);
+    va_list args;
+    va_start(args, format);
+    vfprintf(stderr, format, args);
+    va_end(args);
+    fputc('\n', stderr);
+}
+
+// ═══════════════════════════════════════════════════════════
+// Navidezna ura
+// ═══════════════════════════════════════════════════════════
+
+static _Atomic int64_t s_clock_us = 0;
+
+struct esp_timer {
+    esp_timer_create_args_t args;
+    int64_t deadline_us;
+    bool armed;
+    struct esp_timer *next;
+};
+
+static pthread_mutex_t s_timer_lock = PTHREAD_MUTEX_INITIALIZER;
+static struct esp_timer *s_timers = NULL;
+
+/**
+ * @brief Pokliče pretečene one-shot timerje (vsakega posebej, brez locka)
+ */
+static void run_expired_timers(void)
+{
+    int64_t now = atomic_load(&s_clock_us);
+
+    for (;;) {
+        struct esp_timer *due = NULL;
+
+        pthread_mutex_lock(&s_timer_lock);
+        for (struct esp_timer *t = s_timers; t != NULL; t = t->next) {
+            if (t->armed && t->deadline_us <= now &&
+                (due == NULL || t->deadline_us < due->deadline_us)) {
+                due = t;
+            }
+        }
+        if (due != NULL) {
+            due->armed = false;
+        }
+        pthread_mutex_unlock(&s_timer_lock);
+
+        if (due == NULL) {
+            return;
+        }
+        due->args.callback(due->args.arg);
+    }
+}
+
+int64_t esp_timer_get_time(void)
+{
+    return atomic_load(&s_clock_us);
+}
+
+void host_clock_set_us(int64_t now_us)
+{
+    atomic_store(&s_clock_us, now_us);
+    run_expired_timers();
+}
+
+void host_clock_advance_us(int64_t delta_us)
+{
+    atomic_fetch_add(&s_clock_us, delta_us);
+    run_expired_timers();
+}
+
+esp_err_t esp_timer_create(const esp_timer_create_args_t *create_args, esp_timer_handle_t *out_handle)
+{
+    if (create_args == NULL || create_args->callback == NULL || out_handle == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    struct esp_timer *timer = calloc(1, sizeof(*timer));
+    if (timer == NULL) {
+        return ESP_ERR_NO_MEM;
+    }
+    timer->args = *create_args;
+
+    pthread_mutex_lock(&s_timer_lock);
+    timer->next = s_timers;
+    s_timers = timer;
+    pthread_mutex_unlock(&s_timer_lock);
+
+    *out_handle = timer;
+    return ESP_OK;
+}
+
+esp_err_t esp_timer_start_once(esp_timer_handle_t timer, uint64_t timeout_us)
+{
+    esp_err_t ret = ESP_OK;
+
+    pthread_mutex_lock(&s_timer_lock);
+    if (timer->armed) {
+        ret = ESP_ERR_INVALID_STATE;
+    } else {
+        timer->deadline_us = atomic_load(&s_clock_us) + (int64_t)timeout_us;
+        timer->armed = true;
+    }
+    pthread_mutex_unlock(&s_timer_lock);
+    return ret;
+}
+
+esp_err_t esp_timer_stop(esp_timer_handle_t timer)
+{
+    esp_err_t ret = ESP_OK;
+
+    pthread_mutex_lock(&s_timer_lock);
+    if (!timer->armed) {
+        ret = ESP_ERR_INVALID_STATE;
+    }
+    timer->armed = false;
+    pthread_mutex_unlock(&s_timer_lock);
+    return ret;
+}
+
+esp_err_t esp_timer_delete(esp_timer_handle_t timer)
+{
+    pthread_mutex_lock(&s_timer_lock);
+    for (struct esp_timer **p = &s_timers; *p != NULL; p = &(*p)->next) {
+        if (*p == timer) {
+            *p = timer->next;
+            break;
+        }
+    }
+    pthread_mutex_unlock(&s_timer_lock);
+
+    free(timer);
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Taski
+// ═══════════════════════════════════════════════════════════
+
+typedef struct {
+    TaskFunction_t fn;
+    void *arg;
+} task_start_t;
+
+static void *task_entry(void *p)
+{
+    task_start_t start = *(task_start_t *)p;
+    free(p);
+    start.fn(start.arg);
+    return NULL;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t fn, const char *name, uint32_t stack_depth,
+                       void *arg, UBaseType_t priority, TaskHandle_t *handle)
+{
+    (void)name;
+    (void)stack_depth;
+    (void)priority;
+
+    task_start_t *start = malloc(sizeof(*start));
+    if (start == NULL) {
+        return pdFAIL;
+    }
+    start->fn = fn;
+    start->arg = arg;
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, task_entry, start) != 0) {
+        free(start);
+        return pdFAIL;
+    }
+    pthread_detach(thread);
+
+    if (handle) {
+        *handle = NULL;     // Taskov na hostu ne upravljamo od zunaj
+    }
+    return pdPASS;
+}
+
+void vTaskDelete(TaskHandle_t task)
+{
+    if (task == NULL) {
+        pthread_exit(NULL);
+    }
+}
+
+void vTaskDelay(TickType_t ticks)
+{
+    usleep((useconds_t)ticks * 1000 * portTICK_PERIOD_MS);
+}
+
+TickType_t xTaskGetTickCount(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (TickType_t)(ts.tv_sec * 1000 + ts.tv_nsec / 1000000);
+}
+
+void taskYIELD(void)
+{
+    sched_yield();
+}
+
+/**
+ * @brief Absolutni rok za pthread_*_timedwait
+ */
+static struct timespec deadline(TickType_t ticks)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_REALTIME, &ts);
+    uint64_t ms = (uint64_t)ticks * portTICK_PERIOD_MS;
+    ts.tv_sec += ms / 1000;
+    ts.tv_nsec += (long)(ms % 1000) * 1000000;
+    if (ts.tv_nsec >= 1000000000) {
+        ts.tv_sec++;
+        ts.tv_nsec -= 1000000000;
+    }
+    return ts;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Mutex
+// ═══════════════════════════════════════════════════════════
+
+struct host_semaphore {
+    pthread_mutex_t mutex;
+};
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void)
+{
+    SemaphoreHandle_t sem = calloc(1, sizeof(*sem));
+    if (sem) {
+        pthread_mutex_init(&sem->mutex, NULL);
+    }
+    return sem;
+}
+
+BaseType_t xSemaphoreTake(SemaphoreHandle_t sem, TickType_t ticks)
+{
+    if (ticks == portMAX_DELAY) {
+        return pthread_mutex_lock(&sem->mutex) == 0 ? pdTRUE : pdFALSE;
+    }
+    if (ticks == 0) {
+        return pthread_mutex_trylock(&sem->mutex) == 0 ? pdTRUE : pdFALSE;
+    }
+    struct timespec ts = deadline(ticks);
+    return pthread_mutex_timedlock(&sem->mutex, &ts) == 0 ? pdTRUE : pdFALSE;
+}
+
+BaseType_t xSemaphoreGive(SemaphoreHandle_t sem)
+{
+    return pthread_mutex_unlock(&sem->mutex) == 0 ? pdTRUE : pdFALSE;
+}
+
+void vSemaphoreDelete(SemaphoreHandle_t sem)
+{
+    if (sem) {
+        pthread_mutex_destroy(&sem->mutex);
+        free(sem);
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// Vrsta
+// ═══════════════════════════════════════════════════════════
+
+struct host_queue {
+    pthread_mutex_t mutex;
+    pthread_cond_t not_empty;
+    pthread_cond_t not_full;
+    UBaseType_t length;
+    UBaseType_t item_size;
+    UBaseType_t head;
+    UBaseType_t count;
+    uint8_t *storage;
+};
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t item_size)
+{
+    QueueHandle_t queue = calloc(1, sizeof(*queue));
+    if (queue == NULL) {
+        return NULL;
+    }
+    queue->storage = malloc((size_t)length * item_size);
+    if (queue->storage == NULL) {
+        free(queue);
+        return NULL;
+    }
+    queue->length = length;
+    queue->item_size = item_size;
+    pthread_mutex_init(&queue->mutex, NULL);
+    pthread_cond_init(&queue->not_empty, NULL);
+    pthread_cond_init(&queue->not_full, NULL);
+    return queue;
+}
+
+/**
+ * @brief Počakaj na pogoj (ticks = 0 → ne čakaj)
+ * @return false ob timeoutu
+ */
+static bool queue_wait(QueueHandle_t queue, pthread_cond_t *cond, bool (*ready)(QueueHandle_t),
+                       TickType_t ticks)
+{
+    struct timespec ts = deadline(ticks == portMAX_DELAY ? 0 : ticks);
+
+    while (!ready(queue)) {
+        if (ticks == 0) {
+            return false;
+        }
+        if (ticks == portMAX_DELAY) {
+            pthread_cond_wait(cond, &queue->mutex);
+        } else if (pthread_cond_timedwait(cond, &queue->mutex, &ts) == ETIMEDOUT) {
+            return ready(queue);
+        }
+    }
+    return true;
+}
+
+static bool queue_has_space(QueueHandle_t queue)
+{
+    return queue->count < queue->length;
+}
+
+static bool queue_has_items(QueueHandle_t queue)
+{
+    return queue->count > 0;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void *item, TickType_t ticks)
+{
+    pthread_mutex_lock(&queue->mutex);
+    if (!queue_wait(queue, &queue->not_full, queue_has_space, ticks)) {
+        pthread_mutex_unlock(&queue->mutex);
+        return pdFALSE;
+    }
+
+    UBaseType_t tail = (queue->head + queue->count) % queue->length;
+    memcpy(queue->storage + (size_t)tail * queue->item_size, item, queue->item_size);
+    queue->count++;
+    pthread_cond_signal(&queue->not_empty);
+    pthread_mutex_unlock(&queue->mutex);
+    return pdTRUE;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void *item, TickType_t ticks)
+{
+    pthread_mutex_lock(&queue->mutex);
+    if (!queue_wait(queue, &queue->not_empty, queue_has_items, ticks)) {
+        pthread_mutex_unlock(&queue->mutex);
+        return pdFALSE;
+    }
+
+    memcpy(item, queue->storage + (size_t)queue->head * queue->item_size, queue->item_size);
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    pthread_cond_signal(&queue->not_full);
+    pthread_mutex_unlock(&queue->mutex);
+    return pdTRUE;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue)
+{
+    pthread_mutex_lock(&queue->mutex);
+    UBaseType_t count = queue->count;
+    pthread_mutex_unlock(&queue->mutex);
+    return count;
+}
+
+void vQueueDelete(QueueHandle_t queue)
+{
+    if (queue == NULL) {
+        return;
+    }
+    pthread_mutex_destroy(&queue->mutex);
+    pthread_cond_destroy(&queue->not_empty);
+    pthread_cond_destroy(&queue->not_full);
+    free(queue->storage);
+    free(queue);
+}
@@ -0,0 +1,120 @@
+/**
+ * @file websocket.c
+ * @brief Host nadomestek za esp_websocket_client
+ *
+ * En odjemalec naenkrat. Dogodki se kličejo sinhrono iz klicateljeve
+ * niti (host_ws_event), kot bi jih sicer klical WebSocket task.
+ */
+#include "host_port.h"
+#include "esp_websocket_client.h"
+#include <stdlib.h>
+#include <string.h>
+
+struct esp_websocket_client {
+    char uri[64];
+    bool running;
+    esp_event_handler_t handler;
+    void *handler_arg;
+};
+
+static struct esp_websocket_client *s_client = NULL;
+static host_ws_stats_t s_stats = {0};
+
+esp_websocket_client_handle_t esp_websocket_client_init(const esp_websocket_client_config_t *config)
+{
+    if (config == NULL || config->uri == NULL || s_client != NULL) {
+        return NULL;
+    }
+
+    s_client = calloc(1, sizeof(*s_client));
+    if (s_client != NULL) {
+        strncpy(s_client->uri, config->uri, sizeof(s_client->uri) - 1);
+    }
+    return s_client;
+}
+
+esp_err_t esp_websocket_register_events(esp_websocket_client_handle_t client, esp_websocket_event_id_t event,
+                                        esp_event_handler_t handler, void *arg)
+{
+    (void)event;    // Vsi dogodki gredo istemu handlerju (WEBSOCKET_EVENT_ANY)
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    client->handler = handler;
+    client->handler_arg = arg;
+    return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_start(esp_websocket_client_handle_t client)
+{
+    if (client == NULL || client->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    client->running = true;
+    s_stats.starts++;
+    return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_stop(esp_websocket_client_handle_t client)
+{
+    if (client == NULL || !client->running) {
+        return ESP_ERR_INVALID_STATE;
+    }
+    client->running = false;
+    s_stats.stops++;
+    return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_destroy(esp_websocket_client_handle_t client)
+{
+    if (client == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    free(client);
+    s_client = NULL;
+    return ESP_OK;
+}
+
+esp_err_t esp_websocket_client_set_uri(esp_websocket_client_handle_t client, const char *uri)
+{
+    if (client == NULL || uri == NULL || strlen(uri) >= sizeof(client->uri)) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    strcpy(client->uri, uri);
+    return ESP_OK;
+}
+
+int esp_websocket_client_send_text(esp_websocket_client_handle_t client, const char *data, int len,
+                                   TickType_t timeout)
+{
+    (void)timeout;
+    if (client == NULL || !client->running) {
+        return -1;
+    }
+    s_stats.texts_sent++;
+    return len;
+}
+
+// ═══════════════════════════════════════════════════════════
+// host_port.h
+// ═══════════════════════════════════════════════════════════
+
+bool host_ws_event(int32_t event_id, esp_websocket_event_data_t *data)
+{
+    if (s_client == NULL || !s_client->running || s_client->handler == NULL) {
+        return false;
+    }
+    if (data != NULL) {
+        data->client = s_client;
+    }
+    s_client->handler(s_client->handler_arg, "WEBSOCKET_EVENTS", event_id, data);
+    return true;
+}
+
+void host_ws_get_stats(host_ws_stats_t *stats)
+{
+    *stats = s_stats;
+    stats->running = s_client != NULL && s_client->running;
+    strncpy(stats->uri, s_client ? s_client->uri : "", sizeof(stats->uri) - 1);
+    stats->uri[sizeof(stats->uri) - 1] = '\0';
+}
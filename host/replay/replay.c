@@ -0,0 +1,630 @@
+/**
+ * @file replay.c
+ * @brief Host replay kontrolne zanke termostata (hitreje od realnega časa)
+ *
+ * Poganja main/thermostat_loop.c - isto zanko kot sensor task v main.c
+ * (vzorec → UI → furnace_controller → Shelly) - nad posnetim ali
+ * simuliranim potekom temperature. Komponente so prave (furnace_controller,
+ * furnace_logic, sensor_filter, sensor_history, setpoint_manager,
+ * schedule_table, shelly_json), senzor, Shelly in UI pa so nadomestki iz
+ * host/standins. Čas je navidezen - dan teče v nekaj ms. Target nastavlja
+ * tedenski urnik iz thermostat_loop.c, kot ga v firmware-u schedule_manager.
+ *
+ * Načina:
+ *   --trace FILE          odprta zanka: senzor bere posneto temperaturo
+ *   --plant               zaprta zanka: prostor (host/sim) se odziva na peč;
+ *                         zunanja temperatura iz --trace ali --outdoor
+ *
+ * Strategijo izbere Kconfig kot v firmware-u: thermostat_replay je
+ * histereza, thermostat_replay_pid je preveden s CONFIG_THERMOSTAT_CONTROL_PID.
+ *
+ * Izpis: preklopi releja, HTTP klici, napaka udobja, overshoot, energija.
+ * Z --max-* / --min-* opcijami replay vrne 1, če meja ni izpolnjena (ctest).
+ */
+#include "config.h"
+#include "furnace_controller.h"
+#include "host_port.h"
+#include "room_model.h"
+#include "schedule_table.h"
+#include "sensor_manager.h"
+#include "setpoint_manager.h"
+#include "shelly_manager.h"
+#include "standins.h"
+#include "thermostat_loop.h"
+#include "ui_manager.h"
+#include "esp_log.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static const char *TAG = "replay";
+
+#define REPLAY_HUMIDITY         45.0f
+#define REPLAY_RECORD_PERIOD_S  60
+#define REPLAY_OUTDOOR_SWING    4.0f    // Dnevno nihanje okoli --outdoor (°C)
+
+#define REPLAY_START_YEAR       2026    // Ponedeljek 12. 1. 2026 00:00 (lokalni čas)
+#define REPLAY_START_MONTH      1
+#define REPLAY_START_DAY        12
+
+// ═══════════════════════════════════════════════════════════
+// Opcije
+// ═══════════════════════════════════════════════════════════
+
+typedef struct {
+    const char *trace_path;
+    const char *record_path;
+    bool plant;
+    float days;
+    float outdoor;
+    float fixed_target;             // NAN = tedenski urnik
+    bool optimal_start;
+    bool filter_set;
+    sensor_filter_config_t filter;
+    float noise;
+    float spikes;
+    uint32_t seed;
+    bool push;
+    shelly_api_t api;
+    float power_w;
+    bool verbose;
+    float max_http_per_min;         // < 0 = brez preverjanja
+    float max_switches_per_day;
+    float min_switches_per_day;
+    float max_comfort_error;
+    float max_overshoot;
+    float max_cold_hours;
+    float min_cold_hours;
+    float max_energy_per_day;
+} replay_options_t;
+
+static void usage(const char *argv0)
+{
+    fprintf(stderr,
+            "Usage: %s [--trace FILE] [--plant] [options]\n"
+            "  --trace FILE            time_s,room_c[,outdoor_c] (CSV, '#' = komentar)\n"
+            "  --plant                 zaprta zanka s toplotnim modelom prostora\n"
+            "  --days N                trajanje brez trace (privzeto 1)\n"
+            "  --outdoor C             povprečna zunanja temperatura brez trace (privzeto 0)\n"
+            "  --target C              konstanten target namesto tedenskega urnika\n"
+            "  --no-optimal-start      ne napovej prihodnjega targeta iz urnika\n"
+            "  --filter raw|median|ema|kalman\n"
+            "  --noise SIGMA           šum senzorja (°C, privzeto 0.05)\n"
+            "  --spikes RATE           delež osamljenih napak (privzeto 0)\n"
+            "  --seed N\n"
+            "  --push                  NotifyStatus kanal je povezan\n"
+            "  --api gen1|rpc\n"
+            "  --power W               moč peči (privzeto 2000)\n"
+            "  --record FILE           zapiši potek (plant) vsakih %d s\n"
+            "  --max-http-per-min X | --max-comfort-error X\n"
+            "  --max-switches-per-day X | --min-switches-per-day X\n"
+            "  --max-overshoot X       največji overshoot po izklopu (°C)\n"
+            "  --max-cold-hours X | --min-cold-hours X   °C·h pod targetom\n"
+            "  --max-energy-per-day X  kWh/dan\n"
+            "  -v                      ESP_LOGI izpis komponent\n",
+            argv0, REPLAY_RECORD_PERIOD_S);
+}
+
+static bool parse_options(int argc, char **argv, replay_options_t *opt)
+{
+    const sensor_filter_config_t filter_defaults = SENSOR_FILTER_DEFAULT_CONFIG();
+
+    *opt = (replay_options_t){
+        .days = 1.0f,
+        .outdoor = 0.0f,
+        .fixed_target = NAN,
+        .optimal_start = true,
+        .filter = filter_defaults,
+        .noise = 0.05f,
+        .seed = 1,
+        .api = SHELLY_API_MODE,
+        .power_w = 2000.0f,
+        .max_http_per_min = -1.0f,
+        .max_switches_per_day = -1.0f,
+        .min_switches_per_day = -1.0f,
+        .max_comfort_error = -1.0f,
+        .max_overshoot = -1.0f,
+        .max_cold_hours = -1.0f,
+        .min_cold_hours = -1.0f,
+        .max_energy_per_day = -1.0f,
+    };
+    opt->filter.median_len = SENSOR_FILTER_MEDIAN_LEN;
+    opt->filter.smoother = SENSOR_FILTER_SMOOTHER;
+
+    for (int i = 1; i < argc; i++) {
+        const char *arg = argv[i];
+        const char *val = (i + 1 < argc) ? argv[i + 1] : NULL;
+        bool takes_value = true;
+
+        if (strcmp(arg, "--plant") == 0) {
+            opt->plant = true;
+            takes_value = false;
+        } else if (strcmp(arg, "--no-optimal-start") == 0) {
+            opt->optimal_start = false;
+            takes_value = false;
+        } else if (strcmp(arg, "--push") == 0) {
+            opt->push = true;
+            takes_value = false;
+        } else if (strcmp(arg, "-v") == 0) {
+            opt->verbose = true;
+            takes_value = false;
+        } else if (val == NULL) {
+            usage(argv[0]);
+            return false;
+        } else if (strcmp(arg, "--trace") == 0) {
+            opt->trace_path = val;
+        } else if (strcmp(arg, "--record") == 0) {
+            opt->record_path = val;
+        } else if (strcmp(arg, "--days") == 0) {
+            opt->days = strtof(val, NULL);
+        } else if (strcmp(arg, "--outdoor") == 0) {
+            opt->outdoor = strtof(val, NULL);
+        } else if (strcmp(arg, "--target") == 0) {
+            opt->fixed_target = strtof(val, NULL);
+        } else if (strcmp(arg, "--filter") == 0) {
+            opt->filter_set = true;
+            opt->filter.median_len = (strcmp(val, "raw") == 0) ? 1 : SENSOR_FILTER_MEDIAN_LEN;
+            opt->filter.smoother = (strcmp(val, "ema") == 0) ? SENSOR_SMOOTHER_EMA :
+                                   (strcmp(val, "kalman") == 0) ? SENSOR_SMOOTHER_KALMAN :
+                                   SENSOR_SMOOTHER_NONE;
+        } else if (strcmp(arg, "--noise") == 0) {
+            opt->noise = strtof(val, NULL);
+        } else if (strcmp(arg, "--spikes") == 0) {
+            opt->spikes = strtof(val, NULL);
+        } else if (strcmp(arg, "--seed") == 0) {
+            opt->seed = (uint32_t)strtoul(val, NULL, 10);
+        } else if (strcmp(arg, "--api") == 0) {
+            opt->api = (strcmp(val, "gen1") == 0) ? SHELLY_API_GEN1 : SHELLY_API_RPC;
+        } else if (strcmp(arg, "--power") == 0) {
+            opt->power_w = strtof(val, NULL);
+        } else if (strcmp(arg, "--max-http-per-min") == 0) {
+            opt->max_http_per_min = strtof(val, NULL);
+        } else if (strcmp(arg, "--max-switches-per-day") == 0) {
+            opt->max_switches_per_day = strtof(val, NULL);
+        } else if (strcmp(arg, "--min-switches-per-day") == 0) {
+            opt->min_switches_per_day = strtof(val, NULL);
+        } else if (strcmp(arg, "--max-comfort-error") == 0) {
+            opt->max_comfort_error = strtof(val, NULL);
+        } else if (strcmp(arg, "--max-overshoot") == 0) {
+            opt->max_overshoot = strtof(val, NULL);
+        } else if (strcmp(arg, "--max-cold-hours") == 0) {
+            opt->max_cold_hours = strtof(val, NULL);
+        } else if (strcmp(arg, "--min-cold-hours") == 0) {
+            opt->min_cold_hours = strtof(val, NULL);
+        } else if (strcmp(arg, "--max-energy-per-day") == 0) {
+            opt->max_energy_per_day = strtof(val, NULL);
+        } else {
+            usage(argv[0]);
+            return false;
+        }
+
+        if (takes_value) {
+            i++;
+        }
+    }
+
+    if (opt->trace_path == NULL && !opt->plant) {
+        usage(argv[0]);
+        return false;
+    }
+    return true;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Trace
+// ═══════════════════════════════════════════════════════════
+
+typedef struct {
+    float t;
+    float room;
+    float outdoor;      // NAN če stolpca ni
+} trace_point_t;
+
+typedef struct {
+    trace_point_t *points;
+    size_t count;
+} trace_t;
+
+static bool trace_load(const char *path, trace_t *trace)
+{
+    FILE *f = fopen(path, "r");
+    if (f == NULL) {
+        perror(path);
+        return false;
+    }
+
+    size_t capacity = 0;
+    char line[128];
+    trace->points = NULL;
+    trace->count = 0;
+
+    while (fgets(line, sizeof(line), f)) {
+        trace_point_t p = { .outdoor = NAN };
+        if (line[0] == '#' || sscanf(line, "%f,%f,%f", &p.t, &p.room, &p.outdoor) < 2) {
+            continue;   // Komentar ali glava
+        }
+        if (trace->count == capacity) {
+            capacity = capacity ? capacity * 2 : 1024;
+            trace_point_t *grown = realloc(trace->points, capacity * sizeof(*grown));
+            if (grown == NULL) {
+                free(trace->points);
+                fclose(f);
+                return false;
+            }
+            trace->points = grown;
+        }
+        trace->points[trace->count++] = p;
+    }
+
+    fclose(f);
+    if (trace->count < 2) {
+        fprintf(stderr, "%s: need at least two samples\n", path);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Linearna interpolacija posnetka ob času t
+ */
+static trace_point_t trace_at(const trace_t *trace, float t)
+{
+    static size_t cursor = 0;   // Čas v replayu le narašča
+
+    if (t <= trace->points[0].t) {
+        return trace->points[0];
+    }
+    while (cursor + 1 < trace->count && trace->points[cursor + 1].t <= t) {
+        cursor++;
+    }
+    if (cursor + 1 >= trace->count) {
+        return trace->points[trace->count - 1];
+    }
+
+    const trace_point_t *a = &trace->points[cursor];
+    const trace_point_t *b = &trace->points[cursor + 1];
+    float w = (t - a->t) / (b->t - a->t);
+    return (trace_point_t){
+        .t = t,
+        .room = a->room + w * (b->room - a->room),
+        .outdoor = a->outdoor + w * (b->outdoor - a->outdoor),
+    };
+}
+
+// ═══════════════════════════════════════════════════════════
+// Metrike
+// ═══════════════════════════════════════════════════════════
+
+typedef struct {
+    double abs_error_sum;       // Σ|T - target| po vzorcih
+    double sq_error_sum;
+    double cold_deg_s;          // ∫ max(0, target - T) dt
+    uint32_t samples;
+    // Overshoot po vsakem ciklu: vrh temperature po izklopu peči
+    bool was_heating;
+    float heating_reference;    // Najvišja reference med zadnjim vklopom
+    bool coasting;
+    float coast_reference;
+    float coast_peak;
+    float overshoot_max;
+    double overshoot_sum;
+    uint32_t cycles;
+} comfort_t;
+
+static void comfort_close_cycle(comfort_t *c)
+{
+    if (c->coasting) {
+        float overshoot = fmaxf(c->coast_peak - c->coast_reference, 0.0f);
+        c->overshoot_max = fmaxf(c->overshoot_max, overshoot);
+        c->overshoot_sum += overshoot;
+        c->cycles++;
+    }
+    c->coasting = false;
+}
+
+/**
+ * @brief Dodaj vzorec
+ * @param room Dejanska temperatura prostora
+ * @param target Target kontrolerja
+ * @param reference Kam sme kontroler greti (target ali prihodnji target ob pred-gretju)
+ * @param heating Relay na Shelly
+ * @param dt_s Trajanje vzorca
+ */
+static void comfort_sample(comfort_t *c, float room, float target, float reference, bool heating,
+                           float dt_s)
+{
+    if (c->coasting && (heating || reference != c->coast_reference)) {
+        comfort_close_cycle(c);
+    }
+    if (c->was_heating && !heating) {
+        // Izklop zaradi nižjega targeta (npr. 22:00) ni overshoot
+        c->coasting = true;
+        c->coast_reference = fmaxf(c->heating_reference, reference);
+        c->coast_peak = room;
+    }
+    if (heating) {
+        c->heating_reference = c->was_heating ? fmaxf(c->heating_reference, reference) : reference;
+    }
+    if (c->coasting) {
+        c->coast_peak = fmaxf(c->coast_peak, room);
+    }
+    c->was_heating = heating;
+
+    float error = room - target;
+    c->abs_error_sum += fabsf(error);
+    c->sq_error_sum += error * error;
+    if (error < 0.0f) {
+        c->cold_deg_s += -error * dt_s;
+    }
+    c->samples++;
+}
+
+static float outdoor_at(const replay_options_t *opt, float t)
+{
+    // Najhladneje ob 5h, najtopleje ob 17h
+    float hour = fmodf(t / 3600.0f, 24.0f);
+    return opt->outdoor - REPLAY_OUTDOOR_SWING * cosf((hour - 5.0f) * (float)M_PI / 12.0f);
+}
+
+// ═══════════════════════════════════════════════════════════
+// Urnik
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief schedule_manager nad navidezno uro
+ *
+ * Isto kot reschedule() v schedule_manager.c: ob zagonu in ob vsakem
+ * prehodu (one-shot timer) pokliče callback, ki ga main.c registrira.
+ */
+typedef struct {
+    schedule_table_t table;
+    bool applied_valid;
+    float applied_target;
+    time_t timer_at;            // 0 = timer ni nastavljen
+} replay_schedule_t;
+
+static void schedule_reschedule(replay_schedule_t *sched, time_t now)
+{
+    schedule_status_t status;
+    bool valid = schedule_table_lookup(&sched->table, now, &status);
+
+    sched->timer_at = status.next_change > now ? status.next_change : 0;
+    if (!valid) {
+        return;
+    }
+
+    bool changed = !sched->applied_valid || status.target != sched->applied_target;
+    sched->applied_target = status.target;
+    sched->applied_valid = true;
+    thermostat_loop_schedule_update(&status, changed, now);
+}
+
+/**
+ * @brief Kam sme kontroler greti: prihodnji target, dokler pred-gretje sme teči
+ */
+static float schedule_reference(const replay_schedule_t *sched, time_t now, bool optimal_start)
+{
+    schedule_status_t status;
+    if (!schedule_table_lookup(&sched->table, now, &status)) {
+        return setpoint_manager_get();
+    }
+
+    bool preheat_window = optimal_start && status.next_change > now &&
+                          status.next_target > status.target &&
+                          status.next_change - now <= FURNACE_MODEL_MAX_LEAD_S;
+    return preheat_window ? status.next_target : status.target;
+}
+
+// ═══════════════════════════════════════════════════════════
+// main
+// ═══════════════════════════════════════════════════════════
+
+int main(int argc, char **argv)
+{
+    replay_options_t opt;
+    if (!parse_options(argc, argv, &opt)) {
+        return 2;
+    }
+    esp_log_level_set("*", opt.verbose ? ESP_LOG_INFO : ESP_LOG_WARN);
+
+    trace_t trace = {0};
+    if (opt.trace_path && !trace_load(opt.trace_path, &trace)) {
+        return 2;
+    }
+    bool trace_outdoor = trace.count > 0 && !isnan(trace.points[0].outdoor);
+    float duration_s = trace.count ? trace.points[trace.count - 1].t : opt.days * 86400.0f;
+
+    FILE *record = NULL;
+    if (opt.record_path) {
+        record = fopen(opt.record_path, "w");
+        if (record == NULL) {
+            perror(opt.record_path);
+            return 2;
+        }
+        fprintf(record, "time_s,room_c,outdoor_c\n");
+    }
+
+    // Lokalni čas kot na napravi - urnik upošteva CET/CEST
+    setenv("TZ", SCHEDULE_TIMEZONE, 1);
+    tzset();
+    struct tm start_tm = {
+        .tm_year = REPLAY_START_YEAR - 1900,
+        .tm_mon = REPLAY_START_MONTH - 1,
+        .tm_mday = REPLAY_START_DAY,
+        .tm_isdst = -1,
+    };
+    time_t start_epoch = mktime(&start_tm);
+
+    replay_schedule_t schedule = {0};
+    if (isnan(opt.fixed_target)) {
+        schedule_table_compile(&schedule.table, thermostat_loop_schedule, thermostat_loop_schedule_count);
+    } else {
+        schedule_period_t constant = { SCHEDULE_EVERY_DAY, 0, 0, opt.fixed_target };
+        schedule_table_compile(&schedule.table, &constant, 1);
+    }
+
+    // Začetno stanje: prostor na prvem targetu
+    schedule_status_t first;
+    schedule_table_lookup(&schedule.table, start_epoch, &first);
+    float initial = trace.count ? trace.points[0].room : first.target;
+
+    room_model_t room;
+    room_model_init(&room, NULL, initial);
+
+    sensor_standin_set_noise(opt.noise, opt.spikes, opt.seed);
+    sensor_standin_set(initial, REPLAY_HUMIDITY);
+    shelly_standin_configure(opt.power_w, opt.push);
+
+    // Boot kot v main.c: UI, Shelly & furnace, senzor, urnik
+    thermostat_loop_config_t loop_cfg = THERMOSTAT_LOOP_DEFAULT_CONFIG();
+    loop_cfg.target = first.target;
+    loop_cfg.api = opt.api;
+    loop_cfg.optimal_start = opt.optimal_start;
+
+    ui_manager_init();
+    if (thermostat_loop_init(&loop_cfg) != ESP_OK) {
+        fprintf(stderr, "thermostat_loop_init failed\n");
+        return 1;
+    }
+    ui_manager_set_target_temperature(setpoint_manager_get());
+    thermostat_loop_set_link(true);
+    if (thermostat_loop_furnace_start() != ESP_OK) {
+        fprintf(stderr, "furnace start failed\n");
+        return 2;
+    }
+    sensor_manager_init();
+    if (opt.filter_set) {
+        sensor_manager_set_filter(&opt.filter);
+    }
+    sensor_manager_start(SENSOR_READ_INTERVAL_MS);
+    schedule_reschedule(&schedule, start_epoch);
+
+    comfort_t comfort = {0};
+    const float dt_s = SENSOR_READ_INTERVAL_MS / 1000.0f;
+    uint32_t samples = 0;
+
+    struct timespec wall0, wall1;
+    clock_gettime(CLOCK_MONOTONIC, &wall0);
+
+    for (float t = 0.0f; t < duration_s; t += dt_s) {
+        bool heating = shelly_standin_relay(SHELLY_FURNACE_CHANNEL);
+        float outdoor;
+        float room_temp;
+
+        if (trace.count && !opt.plant) {
+            trace_point_t p = trace_at(&trace, t);
+            outdoor = p.outdoor;
+            room_temp = p.room;
+        } else {
+            outdoor = trace_outdoor ? trace_at(&trace, t).outdoor : outdoor_at(&opt, t);
+            room_model_step(&room, heating, outdoor, dt_s);
+            room_temp = room.temp;
+        }
+
+        host_clock_set_us((int64_t)((t + dt_s) * 1e6f));
+        time_t now = start_epoch + (time_t)(t + dt_s);
+        if (schedule.timer_at != 0 && now >= schedule.timer_at) {
+            schedule_reschedule(&schedule, now);
+        }
+
+        // Sensor task (sensor_manager_wait vrne vzorec takoj) + Shelly I/O task
+        sensor_standin_set(room_temp, REPLAY_HUMIDITY);
+        thermostat_loop_sensor_step();
+        shelly_standin_process();
+
+        comfort_sample(&comfort, room_temp, setpoint_manager_get(),
+                       schedule_reference(&schedule, now, opt.optimal_start), heating, dt_s);
+        samples++;
+
+        if (record && ((uint32_t)t % REPLAY_RECORD_PERIOD_S) == 0) {
+            fprintf(record, "%u,%.2f,%.2f\n", (unsigned)t, room_temp, outdoor);
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &wall1);
+    comfort_close_cycle(&comfort);
+    if (record) {
+        fclose(record);
+    }
+
+    // ═══════════════════════════════════════════════════════
+    // Poročilo
+    // ═══════════════════════════════════════════════════════
+    shelly_standin_stats_t shelly;
+    shelly_standin_get_stats(&shelly);
+    furnace_cmd_stats_t cmd;
+    furnace_controller_get_cmd_stats(&cmd);
+    ui_standin_stats_t ui;
+    ui_standin_get_stats(&ui);
+
+    double days = duration_s / 86400.0;
+    double minutes = duration_s / 60.0;
+    double wall_ms = (wall1.tv_sec - wall0.tv_sec) * 1e3 + (wall1.tv_nsec - wall0.tv_nsec) / 1e6;
+    // Pred write suppression: relay ukaz + /status na vsak vzorec
+    double baseline_calls = 2.0 * samples;
+    double comfort_mae = comfort.abs_error_sum / comfort.samples;
+    double switches_per_day = shelly.relay_switches / days;
+    double cold_hours = comfort.cold_deg_s / 3600.0;
+    double energy_per_day = shelly.energy_wh / 1000.0 / days;
+
+    printf("replay:          %.2f days, %u samples (%s, %s) in %.1f ms\n",
+           days, (unsigned)samples, opt.plant ? "plant" : "trace",
+           FURNACE_CONTROL_MODE == FURNACE_CONTROL_PID ? "pid" : "hysteresis", wall_ms);
+    printf("relay switches:  %u (%.1f/day), furnace status updates seen by UI: %u\n",
+           (unsigned)shelly.relay_switches, switches_per_day, (unsigned)ui.furnace_updates);
+    printf("http calls:      %u (%.2f/min, %.1f%% below %.0f/min baseline), "
+           "%u writes, %u polls, %u suppressed\n",
+           (unsigned)shelly.http_calls, shelly.http_calls / minutes,
+           100.0 * (1.0 - shelly.http_calls / baseline_calls), baseline_calls / minutes,
+           (unsigned)cmd.issued, (unsigned)cmd.status_polls, (unsigned)cmd.suppressed);
+    printf("comfort error:   %.3f °C mean |T-target|, %.3f °C RMS, %.2f °C·h below target\n",
+           comfort_mae, sqrt(comfort.sq_error_sum / comfort.samples), cold_hours);
+    printf("overshoot:       %.2f °C max, %.2f °C mean over %u heating cycles\n",
+           comfort.overshoot_max, comfort.cycles ? comfort.overshoot_sum / comfort.cycles : 0.0,
+           (unsigned)comfort.cycles);
+    printf("energy:          %.2f kWh (%.2f kWh/day, furnace on %.1f h)\n",
+           shelly.energy_wh / 1000.0, energy_per_day, shelly.on_s / 3600.0);
+
+    int ret = 0;
+    if (opt.max_http_per_min >= 0.0f && shelly.http_calls / minutes > opt.max_http_per_min) {
+        ESP_LOGE(TAG, "HTTP calls %.2f/min exceed %.2f/min", shelly.http_calls / minutes,
+                 opt.max_http_per_min);
+        ret = 1;
+    }
+    if (opt.max_switches_per_day >= 0.0f && switches_per_day > opt.max_switches_per_day) {
+        ESP_LOGE(TAG, "Relay switches %.1f/day exceed %.1f/day", switches_per_day,
+                 opt.max_switches_per_day);
+        ret = 1;
+    }
+    if (opt.min_switches_per_day >= 0.0f && switches_per_day < opt.min_switches_per_day) {
+        ESP_LOGE(TAG, "Relay switches %.1f/day below %.1f/day", switches_per_day,
+                 opt.min_switches_per_day);
+        ret = 1;
+    }
+    if (opt.max_comfort_error >= 0.0f && comfort_mae > opt.max_comfort_error) {
+        ESP_LOGE(TAG, "Comfort error %.3f °C exceeds %.3f °C", comfort_mae, opt.max_comfort_error);
+        ret = 1;
+    }
+    if (opt.max_overshoot >= 0.0f && comfort.overshoot_max > opt.max_overshoot) {
+        ESP_LOGE(TAG, "Overshoot %.2f °C exceeds %.2f °C", comfort.overshoot_max, opt.max_overshoot);
+        ret = 1;
+    }
+    if (opt.max_cold_hours >= 0.0f && cold_hours > opt.max_cold_hours) {
+        ESP_LOGE(TAG, "%.2f °C·h below target exceed %.2f °C·h", cold_hours, opt.max_cold_hours);
+        ret = 1;
+    }
+    if (opt.min_cold_hours >= 0.0f && cold_hours < opt.min_cold_hours) {
+        ESP_LOGE(TAG, "%.2f °C·h below target is under %.2f °C·h", cold_hours, opt.min_cold_hours);
+        ret = 1;
+    }
+    if (opt.max_energy_per_day >= 0.0f && energy_per_day > opt.max_energy_per_day) {
+        ESP_LOGE(TAG, "Energy %.2f kWh/day exceeds %.2f kWh/day", energy_per_day,
+                 opt.max_energy_per_day);
+        ret = 1;
+    }
+
+    free(trace.points);
+    return ret;
+}
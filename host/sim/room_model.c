@@ -0,0 +1,29 @@
+/**
+ * @file room_model.c
+ * @brief Toplotni model prostora z radiatorjem
+ */
+#include "room_model.h"
+
+void room_model_init(room_model_t *room, const room_params_t *params, float temp)
+{
+    const room_params_t defaults = ROOM_PARAMS_DEFAULT();
+
+    room->params = params ? *params : defaults;
+    room->temp = temp;
+    room->radiator = temp;
+}
+
+void room_model_step(room_model_t *room, bool heating, float outdoor, float dt_s)
+{
+    const room_params_t *p = &room->params;
+
+    while (dt_s > 0.0f) {
+        float dt = (dt_s < 1.0f) ? dt_s : 1.0f;
+        float source = heating ? p->supply_temp : room->temp;
+
+        room->radiator += (source - room->radiator) * dt / p->radiator_tau_s;
+        room->temp += (p->k_rad * (room->radiator - room->temp) -
+                       p->k_loss * (room->temp - outdoor)) * dt;
+        dt_s -= dt;
+    }
+}
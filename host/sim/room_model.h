@@ -0,0 +1,61 @@
+/**
+ * @file room_model.h
+ * @brief Toplotni model prostora z radiatorjem za zaprto-zančni replay
+ *
+ * Dva člena prvega reda:
+ *   radiator:  dTrad/dt = (Tsrc - Trad) / tau,  Tsrc = supply ob vklopu, sicer T
+ *   prostor:   dT/dt = k_rad * (Trad - T) - k_loss * (T - Tout)
+ * Zakasnitev radiatorja je razlog za overshoot pri bang-bang regulaciji.
+ */
+#ifndef ROOM_MODEL_H
+#define ROOM_MODEL_H
+
+#include <stdbool.h>
+
+/**
+ * @brief Parametri prostora
+ */
+typedef struct {
+    float k_rad;            // Prenos radiator → prostor (1/s)
+    float k_loss;           // Izgube prostor → zunaj (1/s)
+    float radiator_tau_s;   // Časovna konstanta radiatorja (s)
+    float supply_temp;      // Temperatura vode ob vklopu peči (°C)
+} room_params_t;
+
+/**
+ * @brief Privzeto: ~5 °C/h ogrevanje z vročim radiatorjem, ~1.4 °C/h ohlajanje pri 20 K razlike
+ */
+#define ROOM_PARAMS_DEFAULT() {     \
+    .k_rad = 0.00004f,              \
+    .k_loss = 0.00002f,             \
+    .radiator_tau_s = 900.0f,       \
+    .supply_temp = 65.0f,           \
+}
+
+/**
+ * @brief Stanje prostora
+ */
+typedef struct {
+    room_params_t params;
+    float temp;             // Zrak v prostoru (°C)
+    float radiator;         // Radiator (°C)
+} room_model_t;
+
+/**
+ * @brief Inicializira prostor v ravnovesju pri dani temperaturi
+ * @param room Stanje
+ * @param params Parametri (NULL = ROOM_PARAMS_DEFAULT)
+ * @param temp Začetna temperatura (°C)
+ */
+void room_model_init(room_model_t *room, const room_params_t *params, float temp);
+
+/**
+ * @brief Simuliraj dt sekund (interno po 1 s korakih)
+ * @param room Stanje
+ * @param heating Ali peč greje
+ * @param outdoor Zunanja temperatura (°C)
+ * @param dt_s Trajanje (s)
+ */
+void room_model_step(room_model_t *room, bool heating, float outdoor, float dt_s);
+
+#endif // ROOM_MODEL_H
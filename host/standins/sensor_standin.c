@@ -0,0 +1,131 @@
+/**
+ * @file sensor_standin.c
+ * @brief Simuliran AHT21 za host replay (sensor_manager.h API)
+ *
+ * Vsak sensor_manager_wait() izmeri temperaturo, ki jo je nazadnje
+ * nastavil replay (sensor_standin_set), doda šum in osamljene napake ter
+ * vzorec pelje skozi isti filter in zgodovino kot sampling task.
+ */
+#include "standins.h"
+#include "sensor_manager.h"
+#include "esp_timer.h"
+#include "config.h"
+#include <math.h>
+#include <stddef.h>
+
+static sensor_filter_t s_filter;
+static sensor_history_t s_history;
+static bool s_ready = false;
+
+static float s_temperature = 20.0f;
+static float s_humidity = 45.0f;
+static float s_sigma = 0.0f;
+static float s_spike_rate = 0.0f;
+static uint32_t s_rng = 1;
+
+/**
+ * @brief xorshift32 → [0, 1)
+ */
+static float rand_unit(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return (s_rng >> 8) / 16777216.0f;
+}
+
+/**
+ * @brief Približek normalne porazdelitve (vsota 12 enakomernih)
+ */
+static float rand_normal(void)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        sum += rand_unit();
+    }
+    return sum - 6.0f;
+}
+
+static void ensure_ready(void)
+{
+    if (!s_ready) {
+        sensor_filter_init(&s_filter, NULL);
+        sensor_history_init(&s_history, SENSOR_READ_INTERVAL_MS);
+        s_ready = true;
+    }
+}
+
+void sensor_standin_set_noise(float sigma, float spike_rate, uint32_t seed)
+{
+    s_sigma = sigma;
+    s_spike_rate = spike_rate;
+    s_rng = seed ? seed : 1;
+}
+
+void sensor_standin_set(float temperature, float humidity)
+{
+    s_temperature = temperature;
+    s_humidity = humidity;
+}
+
+// ═══════════════════════════════════════════════════════════
+// sensor_manager.h
+// ═══════════════════════════════════════════════════════════
+
+esp_err_t sensor_manager_init(void)
+{
+    ensure_ready();
+    return ESP_OK;
+}
+
+esp_err_t sensor_manager_start(uint32_t interval_ms)
+{
+    ensure_ready();
+    sensor_history_init(&s_history, interval_ms);
+    return ESP_OK;
+}
+
+void sensor_manager_set_filter(const sensor_filter_config_t *config)
+{
+    ensure_ready();
+    sensor_filter_init(&s_filter, config);
+}
+
+esp_err_t sensor_manager_wait(sensor_data_t *data, uint32_t timeout_ms)
+{
+    (void)timeout_ms;   // Vzorec je vedno takoj na voljo
+    ensure_ready();
+
+    float raw = s_temperature + s_sigma * rand_normal();
+    if (s_spike_rate > 0.0f && rand_unit() < s_spike_rate) {
+        // Osamljena napačna meritev (npr. motnja na I2C)
+        raw += (rand_unit() < 0.5f) ? -3.0f : 3.0f;
+    }
+    // AHT21 ločljivost je ~0.01 °C
+    raw = roundf(raw * 100.0f) / 100.0f;
+
+    data->temperature = raw;
+    data->humidity = s_humidity;
+    data->temperature_filtered = sensor_filter_update(&s_filter, raw);
+    data->valid = true;
+
+    sensor_history_push(&s_history, (uint32_t)(esp_timer_get_time() / 1000), raw, s_humidity);
+    return ESP_OK;
+}
+
+bool sensor_manager_get_window_stats(sensor_window_t window, sensor_window_stats_t *stats)
+{
+    ensure_ready();
+    return sensor_history_get_stats(&s_history, window, stats);
+}
+
+bool sensor_manager_get_history_sample(uint16_t age, sensor_sample_t *sample)
+{
+    ensure_ready();
+    return sensor_history_get_sample(&s_history, age, sample);
+}
+
+bool sensor_manager_is_initialized(void)
+{
+    return s_ready;
+}
@@ -0,0 +1,321 @@
+/**
+ * @file shelly_standin.c
+ * @brief Simulirana Shelly 2PM za host replay (shelly_manager.h API)
+ *
+ * Ukazi gredo v vrsto kot na napravi, izvede pa jih šele
+ * shelly_standin_process() - replay ga kliče po vsakem vzorcu, kar ustreza
+ * Shelly I/O tasku, ki konča pred naslednjim 2 s tikom. Odgovori so Gen2+
+ * JSON dokumenti in gredo skozi shelly_json, kot bi prišli po HTTP.
+ */
+#include "standins.h"
+#include "shelly_manager.h"
+#include "shelly_json.h"
+#include "esp_timer.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define STANDIN_QUEUE_LEN   8       // Enako kot SHELLY_QUEUE_LEN
+
+static shelly_api_t s_api = SHELLY_API_GEN1;
+static shelly_result_callback_t s_result_callback = NULL;
+static shelly_notify_callback_t s_notify_callback = NULL;
+
+static float s_power_w = 2000.0f;
+static bool s_push = false;
+static bool s_relay[2] = {false, false};
+static int64_t s_on_since_us = 0;
+static shelly_standin_stats_t s_stats = {0};
+
+static shelly_cmd_t s_queue[STANDIN_QUEUE_LEN];
+static int64_t s_queued_us[STANDIN_QUEUE_LEN];
+static int s_queue_len = 0;
+
+// ═══════════════════════════════════════════════════════════
+// Simulirana naprava
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief Obračunaj porabo do zdaj (kanal 0 je peč)
+ */
+static void account_energy(void)
+{
+    int64_t now_us = esp_timer_get_time();
+    if (s_relay[0]) {
+        double on_s = (now_us - s_on_since_us) / 1e6;
+        s_stats.on_s += on_s;
+        s_stats.energy_wh += on_s * s_power_w / 3600.0;
+    }
+    s_on_since_us = now_us;
+}
+
+static void device_switch(uint8_t channel, bool on)
+{
+    s_stats.relay_writes++;
+    if (s_relay[channel] == on) {
+        return;
+    }
+
+    account_energy();
+    s_relay[channel] = on;
+    s_stats.relay_switches++;
+
+    if (s_push && s_notify_callback) {
+        // NotifyStatus pride po WebSocketu ob vsakem preklopu
+        shelly_notify_t event = {
+            .channel = channel,
+            .has_output = true,
+            .output = on,
+            .has_power = true,
+            .power = on ? s_power_w : 0.0f,
+        };
+        s_stats.notifications++;
+        s_notify_callback(&event);
+    }
+}
+
+/**
+ * @brief Switch.GetStatus odgovor, kot ga vrne Gen3
+ */
+static int format_switch_status(char *buf, size_t len, uint8_t channel)
+{
+    bool on = s_relay[channel];
+    return snprintf(buf, len,
+                    "{\"id\":%d,\"source\":\"HTTP_in\",\"output\":%s,\"apower\":%.1f,"
+                    "\"voltage\":231.4,\"current\":%.3f,\"aenergy\":{\"total\":1234.5,"
+                    "\"by_minute\":[0.0,0.0,0.0],\"minute_ts\":1700000000},"
+                    "\"temperature\":{\"tC\":41.2,\"tF\":106.2}}",
+                    channel, on ? "true" : "false", on ? s_power_w : 0.0f,
+                    on ? s_power_w / 231.4f : 0.0f);
+}
+
+typedef struct {
+    shelly_status_t *status;
+    uint8_t channel;
+} parse_ctx_t;
+
+static void status_value_cb(const shelly_json_t *parser, shelly_json_type_t type,
+                            const char *value, void *ctx)
+{
+    parse_ctx_t *parse = (parse_ctx_t *)ctx;
+    shelly_status_t *status = parse->status;
+
+    if ((type == SHELLY_JSON_TRUE || type == SHELLY_JSON_FALSE) &&
+        (shelly_json_match(parser, "output", NULL) ||
+         shelly_json_match(parser, "[].result.output", NULL))) {
+        bool on = (type == SHELLY_JSON_TRUE);
+        if (parse->channel == 0) {
+            status->output_0 = on;
+        } else {
+            status->output_1 = on;
+        }
+    } else if (type == SHELLY_JSON_NUMBER) {
+        float v = strtof(value, NULL);
+        if (shelly_json_match(parser, "apower", NULL) ||
+            shelly_json_match(parser, "[].result.apower", NULL)) {
+            if (parse->channel == 0) {
+                status->power_0 = v;
+            } else {
+                status->power_1 = v;
+            }
+        } else if (shelly_json_match(parser, "temperature.tC", NULL) ||
+                   shelly_json_match(parser, "[].result.temperature.tC", NULL)) {
+            status->temperature = v;
+        }
+    }
+}
+
+/**
+ * @brief Parsaj telo odgovora po kosih, kot ga vrača esp_http_client
+ */
+static esp_err_t parse_response(const char *body, uint8_t channel, shelly_status_t *status)
+{
+    parse_ctx_t ctx = { .status = status, .channel = channel };
+    shelly_json_t parser;
+    shelly_json_init(&parser, status_value_cb, &ctx);
+
+    size_t len = strlen(body);
+    for (size_t off = 0; off < len; off += 64) {
+        size_t chunk = (len - off < 64) ? len - off : 64;
+        shelly_json_feed(&parser, body + off, chunk);
+    }
+    if (!shelly_json_done(&parser)) {
+        return ESP_ERR_INVALID_RESPONSE;
+    }
+
+    status->online = true;
+    return ESP_OK;
+}
+
+/**
+ * @brief En kontrolni cikel: (opcijski) Switch.Set + Switch.GetStatus
+ *
+ * RPC backend pošlje oboje kot en batch, Gen1 kot dve zahtevi.
+ */
+static esp_err_t device_request(uint8_t channel, bool write, bool on, shelly_status_t *status)
+{
+    char body[384];
+    char switch_status[320];
+
+    if (write) {
+        bool was_on = s_relay[channel];
+        device_switch(channel, on);
+        format_switch_status(switch_status, sizeof(switch_status), channel);
+        if (s_api == SHELLY_API_RPC) {
+            s_stats.http_calls++;
+            snprintf(body, sizeof(body), "[{\"id\":1,\"result\":{\"was_on\":%s}},{\"id\":2,\"result\":%s}]",
+                     was_on ? "true" : "false", switch_status);
+        } else {
+            s_stats.http_calls += 2;
+            snprintf(body, sizeof(body), "%s", switch_status);
+        }
+    } else {
+        s_stats.http_calls++;
+        format_switch_status(body, sizeof(body), channel);
+    }
+
+    memset(status, 0, sizeof(*status));
+    return parse_response(body, channel, status);
+}
+
+// ═══════════════════════════════════════════════════════════
+// Nadzor simulacije
+// ═══════════════════════════════════════════════════════════
+
+void shelly_standin_configure(float power_w, bool push)
+{
+    s_power_w = power_w;
+    s_push = push;
+}
+
+void shelly_standin_process(void)
+{
+    // Callback lahko takoj pošlje nov ukaz - izvedi le tiste, ki so že v vrsti
+    int pending = s_queue_len;
+    shelly_cmd_t cmds[STANDIN_QUEUE_LEN];
+    int64_t queued_us[STANDIN_QUEUE_LEN];
+    memcpy(cmds, s_queue, sizeof(cmds));
+    memcpy(queued_us, s_queued_us, sizeof(queued_us));
+    s_queue_len = 0;
+
+    for (int i = 0; i < pending; i++) {
+        shelly_result_t result = { .cmd = cmds[i] };
+
+        switch (cmds[i].type) {
+            case SHELLY_CMD_SET_RELAY:
+                result.err = shelly_manager_set_relay(cmds[i].channel, cmds[i].on);
+                break;
+            case SHELLY_CMD_GET_STATUS:
+                result.err = device_request(cmds[i].channel, false, false, &result.status);
+                break;
+            case SHELLY_CMD_SET_AND_STATUS:
+                result.err = device_request(cmds[i].channel, true, cmds[i].on, &result.status);
+                break;
+            default:
+                result.err = ESP_ERR_INVALID_ARG;
+                break;
+        }
+
+        result.latency_ms = (uint32_t)((esp_timer_get_time() - queued_us[i]) / 1000);
+        if (s_result_callback) {
+            s_result_callback(&result);
+        }
+    }
+}
+
+bool shelly_standin_relay(uint8_t channel)
+{
+    return channel < 2 && s_relay[channel];
+}
+
+void shelly_standin_get_stats(shelly_standin_stats_t *stats)
+{
+    account_energy();
+    *stats = s_stats;
+}
+
+// ═══════════════════════════════════════════════════════════
+// shelly_manager.h
+// ═══════════════════════════════════════════════════════════
+
+esp_err_t shelly_manager_init(const char *ip_address)
+{
+    return ip_address ? ESP_OK : ESP_ERR_INVALID_ARG;
+}
+
+void shelly_manager_set_api(shelly_api_t api)
+{
+    s_api = api;
+}
+
+shelly_api_t shelly_manager_get_api(void)
+{
+    return s_api;
+}
+
+esp_err_t shelly_manager_set_relay(uint8_t channel, bool on)
+{
+    if (channel > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    s_stats.http_calls++;
+    device_switch(channel, on);
+    return ESP_OK;
+}
+
+esp_err_t shelly_manager_get_status(shelly_status_t *status)
+{
+    if (status == NULL) {
+        return ESP_ERR_INVALID_ARG;
+    }
+
+    // Shelly.GetStatus vrne oba kanala v enem odgovoru
+    char body[320];
+    shelly_status_t ch1 = {0};
+    memset(status, 0, sizeof(*status));
+    s_stats.http_calls++;
+
+    format_switch_status(body, sizeof(body), 1);
+    esp_err_t err = parse_response(body, 1, &ch1);
+    if (err == ESP_OK) {
+        format_switch_status(body, sizeof(body), 0);
+        err = parse_response(body, 0, status);
+    }
+    status->output_1 = ch1.output_1;
+    status->power_1 = ch1.power_1;
+    return err;
+}
+
+esp_err_t shelly_manager_post(const shelly_cmd_t *cmd)
+{
+    if (cmd == NULL || cmd->channel > 1) {
+        return ESP_ERR_INVALID_ARG;
+    }
+    if (s_queue_len >= STANDIN_QUEUE_LEN) {
+        return ESP_ERR_TIMEOUT;
+    }
+    s_queue[s_queue_len] = *cmd;
+    s_queued_us[s_queue_len] = esp_timer_get_time();
+    s_queue_len++;
+    return ESP_OK;
+}
+
+void shelly_manager_register_result_callback(shelly_result_callback_t callback)
+{
+    s_result_callback = callback;
+}
+
+void shelly_manager_register_notify_callback(shelly_notify_callback_t callback)
+{
+    s_notify_callback = callback;
+}
+
+esp_err_t shelly_manager_notify_start(void)
+{
+    return s_push ? ESP_OK : ESP_FAIL;
+}
+
+bool shelly_manager_notify_connected(void)
+{
+    return s_push;
+}
@@ -0,0 +1,96 @@
+/**
+ * @file standins.h
+ * @brief Host nadomestki za sensor_manager, shelly_manager in ui_manager
+ *
+ * Nadomestki implementirajo javne API-je komponent (sensor_manager.h,
+ * shelly_manager.h, ui_manager.h), zato furnace_controller in replay
+ * driver tečeta nespremenjena. Tu so le dodatni klici, s katerimi replay
+ * krmili simulacijo in bere števce.
+ */
+#ifndef STANDINS_H
+#define STANDINS_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+// ═══════════════════════════════════════════════════════════
+// Shelly
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief Števci simulirane Shelly naprave
+ */
+typedef struct {
+    uint32_t http_calls;        // Vse HTTP zahteve (batch = ena zahteva)
+    uint32_t relay_writes;      // Switch.Set ukazi (tudi brez spremembe)
+    uint32_t relay_switches;    // Dejanski preklopi releja
+    uint32_t notifications;     // Poslana NotifyStatus obvestila
+    double energy_wh;           // Poraba peči (relay vklopljen × moč)
+    double on_s;                // Skupni čas vklopa
+} shelly_standin_stats_t;
+
+/**
+ * @brief Nastavi simulirano napravo
+ * @param power_w Moč peči, ko je relay vklopljen (W)
+ * @param push Ali je WebSocket kanal za obvestila povezan
+ */
+void shelly_standin_configure(float power_w, bool push);
+
+/**
+ * @brief Izvede ukaze iz vrste (kot Shelly I/O task) in pokliče callbacke
+ */
+void shelly_standin_process(void);
+
+/**
+ * @brief Stanje releja na napravi
+ * @param channel Kanal (0 ali 1)
+ */
+bool shelly_standin_relay(uint8_t channel);
+
+/**
+ * @brief Preberi števce (energija je obračunana do trenutnega časa)
+ * @param stats Output struktura
+ */
+void shelly_standin_get_stats(shelly_standin_stats_t *stats);
+
+// ═══════════════════════════════════════════════════════════
+// Senzor
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief Šum AHT21 (ponovljiv - fiksen seed)
+ * @param sigma Standardni odklon meritve (°C)
+ * @param spike_rate Delež vzorcev z osamljeno napako (0..1)
+ * @param seed Seed generatorja
+ */
+void sensor_standin_set_noise(float sigma, float spike_rate, uint32_t seed);
+
+/**
+ * @brief Dejanska temperatura/vlaga v prostoru (naslednji vzorec jo izmeri)
+ * @param temperature Temperatura (°C)
+ * @param humidity Relativna vlaga (%)
+ */
+void sensor_standin_set(float temperature, float humidity);
+
+// ═══════════════════════════════════════════════════════════
+// UI
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief Kaj je UI prikazal
+ */
+typedef struct {
+    uint32_t furnace_updates;   // Spremembe besedila statusa peči
+    uint32_t power_updates;     // Posodobitve moči
+    uint32_t sensor_errors;
+    char furnace_status[16];    // Zadnje besedilo statusa
+    float target;               // Zadnji prikazan target
+} ui_standin_stats_t;
+
+/**
+ * @brief Preberi števce UI nadomestka
+ * @param stats Output struktura
+ */
+void ui_standin_get_stats(ui_standin_stats_t *stats);
+
+#endif // STANDINS_H
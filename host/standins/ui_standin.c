@@ -0,0 +1,61 @@
+/**
+ * @file ui_standin.c
+ * @brief UI brez zaslona za host replay (ui_manager.h API)
+ *
+ * Beleži le, kaj bi bilo prikazano - replay iz tega preveri, da je UI
+ * dobil vsako spremembo stanja peči.
+ */
+#include "standins.h"
+#include "ui_manager.h"
+#include <string.h>
+
+static ui_standin_stats_t s_stats = {0};
+
+esp_err_t ui_manager_init(void)
+{
+    memset(&s_stats, 0, sizeof(s_stats));
+    return ESP_OK;
+}
+
+void ui_manager_update_temperature(float temperature, bool valid)
+{
+    (void)temperature;
+    (void)valid;
+}
+
+void ui_manager_update_humidity(float humidity, bool valid)
+{
+    (void)humidity;
+    (void)valid;
+}
+
+void ui_manager_show_sensor_error(void)
+{
+    s_stats.sensor_errors++;
+}
+
+void ui_manager_update_furnace_status(const char *status, uint32_t color)
+{
+    (void)color;
+    if (strncmp(s_stats.furnace_status, status, sizeof(s_stats.furnace_status)) != 0) {
+        strncpy(s_stats.furnace_status, status, sizeof(s_stats.furnace_status) - 1);
+        s_stats.furnace_updates++;
+    }
+}
+
+void ui_manager_set_target_temperature(float target_temp)
+{
+    s_stats.target = target_temp;
+}
+
+void ui_manager_update_power(float power_w, bool online)
+{
+    (void)power_w;
+    (void)online;
+    s_stats.power_updates++;
+}
+
+void ui_standin_get_stats(ui_standin_stats_t *stats)
+{
+    *stats = s_stats;
+}
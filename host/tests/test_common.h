@@ -0,0 +1,37 @@
+/**
+ * @file test_common.h
+ * @brief Minimalni assert makri za host teste (brez zunanjega ogrodja)
+ */
+#ifndef TEST_COMMON_H
+#define TEST_COMMON_H
+
+#include <math.h>
+#include <stdio.h>
+
+static int s_test_failures = 0;
+
+#define TEST_CHECK(cond) do {                                               \
+        if (!(cond)) {                                                      \
+            fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); \
+            s_test_failures++;                                              \
+        }                                                                   \
+    } while (0)
+
+#define TEST_CHECK_FLOAT(actual, expected, eps) do {                        \
+        double a_ = (actual), e_ = (expected);                              \
+        if (fabs(a_ - e_) > (eps)) {                                        \
+            fprintf(stderr, "%s:%d: %s = %g, expected %g\n", __FILE__, __LINE__, \
+                    #actual, a_, e_);                                       \
+            s_test_failures++;                                              \
+        }                                                                   \
+    } while (0)
+
+#define TEST_RUN(fn) do {                                                   \
+        int before_ = s_test_failures;                                      \
+        fn();                                                               \
+        printf("%-40s %s\n", #fn, s_test_failures == before_ ? "ok" : "FAILED"); \
+    } while (0)
+
+#define TEST_EXIT() (s_test_failures ? 1 : 0)
+
+#endif // TEST_COMMON_H
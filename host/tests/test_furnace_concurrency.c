@@ -0,0 +1,283 @@
+/**
+ * @file test_furnace_concurrency.c
+ * @brief Stres test furnace_controller: sočasni pisci in bralci posnetka
+ *
+ * Niti ustrezajo taskom na napravi: sensor task (update_temperature),
+ * Shelly I/O task (rezultati ukazov), WebSocket task (NotifyStatus),
+ * manual override in več bralcev (UI). Preveri se:
+ *  - posnetek ni nikoli raztrgan (state in power iz istega zapisa),
+ *  - version pri bralcu ne pada,
+ *  - števci ne izgubijo posodobitev (issued = vsi poslani relay ukazi),
+ *  - v vrsti je največ en ukaz (pending handshake).
+ *
+ * shelly_manager je tu nadomeščen z lastnim mockom, ki ima le en slot.
+ */
+#include "furnace_controller.h"
+#include "shelly_manager.h"
+#include "host_port.h"
+#include "esp_log.h"
+#include "test_common.h"
+#include <pthread.h>
+#include <stdatomic.h>
+#include <string.h>
+
+#define WRITER_ITERATIONS   200000
+#define READER_COUNT        3
+#define POWER_BASE_W        1000.0f     // Vklopljen relay vedno poroča >= 1000 W
+
+// ═══════════════════════════════════════════════════════════
+// Mock shelly_manager (en slot = Shelly I/O vrsta)
+// ═══════════════════════════════════════════════════════════
+
+static shelly_result_callback_t s_result_cb;
+static shelly_notify_callback_t s_notify_cb;
+
+static pthread_mutex_t s_slot_lock = PTHREAD_MUTEX_INITIALIZER;
+static bool s_slot_full = false;
+static shelly_cmd_t s_slot;
+
+static atomic_uint s_posted_writes = 0;     // SET_AND_STATUS sprejeti v vrsto
+static atomic_uint s_manual_writes = 0;     // Sinhroni set_relay (manual override)
+static atomic_uint s_double_posts = 0;      // Post, ko je slot še poln
+static atomic_bool s_stop = false;
+
+esp_err_t shelly_manager_init(const char *ip_address)
+{
+    (void)ip_address;
+    return ESP_OK;
+}
+
+shelly_api_t shelly_manager_get_api(void)
+{
+    return SHELLY_API_RPC;
+}
+
+void shelly_manager_register_result_callback(shelly_result_callback_t callback)
+{
+    s_result_cb = callback;
+}
+
+void shelly_manager_register_notify_callback(shelly_notify_callback_t callback)
+{
+    s_notify_cb = callback;
+}
+
+esp_err_t shelly_manager_notify_start(void)
+{
+    return ESP_OK;
+}
+
+bool shelly_manager_notify_connected(void)
+{
+    return false;   // Polling pot - več ukazov v vrsti
+}
+
+esp_err_t shelly_manager_get_status(shelly_status_t *status)
+{
+    memset(status, 0, sizeof(*status));
+    status->online = true;
+    return ESP_OK;
+}
+
+esp_err_t shelly_manager_set_relay(uint8_t channel, bool on)
+{
+    (void)channel;
+    (void)on;
+    atomic_fetch_add(&s_manual_writes, 1);
+    return ESP_OK;
+}
+
+esp_err_t shelly_manager_post(const shelly_cmd_t *cmd)
+{
+    pthread_mutex_lock(&s_slot_lock);
+    if (s_slot_full) {
+        atomic_fetch_add(&s_double_posts, 1);
+        pthread_mutex_unlock(&s_slot_lock);
+        return ESP_ERR_TIMEOUT;
+    }
+    s_slot = *cmd;
+    s_slot_full = true;
+    if (cmd->type == SHELLY_CMD_SET_AND_STATUS) {
+        atomic_fetch_add(&s_posted_writes, 1);
+    }
+    pthread_mutex_unlock(&s_slot_lock);
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Niti
+// ═══════════════════════════════════════════════════════════
+
+static void *sensor_task(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < WRITER_ITERATIONS; i++) {
+        host_clock_advance_us(2000000);
+        // Izmenično hladno/toplo → veliko relay ukazov
+        furnace_controller_update_temperature((i / 4) % 2 ? 15.0f : 25.0f);
+        if (i % 1000 == 0) {
+            furnace_controller_set_target(20.0f + (i / 1000) % 3);
+        }
+    }
+    return NULL;
+}
+
+static void *shelly_io_task(void *arg)
+{
+    (void)arg;
+    unsigned n = 0;
+    while (!atomic_load(&s_stop)) {
+        shelly_cmd_t cmd;
+        bool have = false;
+
+        pthread_mutex_lock(&s_slot_lock);
+        if (s_slot_full) {
+            cmd = s_slot;
+            s_slot_full = false;
+            have = true;
+        }
+        pthread_mutex_unlock(&s_slot_lock);
+
+        if (!have) {
+            sched_yield();
+            continue;
+        }
+
+        n++;
+        // GET_STATUS občasno najde relay preklopljen od zunaj
+        bool on = (cmd.type == SHELLY_CMD_SET_AND_STATUS) ? cmd.on : (n % 7 == 0);
+        shelly_result_t result = {
+            .cmd = cmd,
+            .err = ESP_OK,
+            .status = {
+                .output_0 = on,
+                .power_0 = on ? POWER_BASE_W + (n % 500) : 0.0f,
+                .online = true,
+            },
+        };
+        s_result_cb(&result);
+    }
+    return NULL;
+}
+
+static void *websocket_task(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < WRITER_ITERATIONS; i++) {
+        bool on = (i % 3) == 0;
+        shelly_notify_t event = {
+            .channel = 0,
+            .has_output = true,
+            .output = on,
+            .has_power = true,
+            .power = on ? POWER_BASE_W + (i % 500) : 0.0f,
+        };
+        s_notify_cb(&event);
+    }
+    return NULL;
+}
+
+static void *manual_task(void *arg)
+{
+    (void)arg;
+    for (int i = 0; i < WRITER_ITERATIONS / 4; i++) {
+        furnace_controller_manual_override(i & 1);
+    }
+    return NULL;
+}
+
+typedef struct {
+    unsigned reads;
+    unsigned torn;
+    unsigned version_regressions;
+} reader_result_t;
+
+static void *reader_task(void *arg)
+{
+    reader_result_t *res = (reader_result_t *)arg;
+    uint32_t last_version = 0;
+
+    while (!atomic_load(&s_stop)) {
+        furnace_snapshot_t snap;
+        furnace_controller_get_snapshot(&snap);
+        res->reads++;
+
+        // Vsak zapis je par (state, power): OFF/ERROR → 0 W, HEATING → 0 W
+        // (manual override) ali >= POWER_BASE_W (Shelly)
+        bool consistent;
+        switch (snap.state) {
+            case FURNACE_HEATING:
+                consistent = snap.power_w == 0.0f || snap.power_w >= POWER_BASE_W;
+                break;
+            case FURNACE_OFF:
+            case FURNACE_ERROR:
+                consistent = snap.power_w == 0.0f;
+                break;
+            default:
+                consistent = false;
+                break;
+        }
+        if (!consistent) {
+            res->torn++;
+        }
+        if (snap.version < last_version) {
+            res->version_regressions++;
+        }
+        last_version = snap.version;
+    }
+    return NULL;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Test
+// ═══════════════════════════════════════════════════════════
+
+static void test_concurrent_writers_and_readers(void)
+{
+    TEST_CHECK(furnace_controller_init("127.0.0.1", 0) == ESP_OK);
+    furnace_controller_set_intervals(10000, 4000);
+
+    pthread_t io, sensor, ws, manual, readers[READER_COUNT];
+    reader_result_t results[READER_COUNT] = {0};
+
+    pthread_create(&io, NULL, shelly_io_task, NULL);
+    for (int i = 0; i < READER_COUNT; i++) {
+        pthread_create(&readers[i], NULL, reader_task, &results[i]);
+    }
+    pthread_create(&sensor, NULL, sensor_task, NULL);
+    pthread_create(&ws, NULL, websocket_task, NULL);
+    pthread_create(&manual, NULL, manual_task, NULL);
+
+    pthread_join(sensor, NULL);
+    pthread_join(ws, NULL);
+    pthread_join(manual, NULL);
+    atomic_store(&s_stop, true);
+    pthread_join(io, NULL);
+
+    unsigned reads = 0;
+    for (int i = 0; i < READER_COUNT; i++) {
+        pthread_join(readers[i], NULL);
+        reads += results[i].reads;
+        TEST_CHECK(results[i].torn == 0);
+        TEST_CHECK(results[i].version_regressions == 0);
+    }
+
+    furnace_cmd_stats_t stats;
+    furnace_controller_get_cmd_stats(&stats);
+    unsigned expected = atomic_load(&s_posted_writes) + atomic_load(&s_manual_writes);
+
+    printf("  %u snapshot reads, %lu issued (expected %u), %lu polls, %lu resyncs\n",
+           reads, (unsigned long)stats.issued, expected, (unsigned long)stats.status_polls,
+           (unsigned long)stats.resyncs);
+
+    TEST_CHECK(stats.issued == expected);
+    TEST_CHECK(atomic_load(&s_double_posts) == 0);
+    TEST_CHECK(reads > 0);
+}
+
+int main(void)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);   // Resync opozorila so tu pričakovana
+    TEST_RUN(test_concurrent_writers_and_readers);
+    return TEST_EXIT();
+}
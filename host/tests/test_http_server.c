@@ -0,0 +1,193 @@
+/**
+ * @file test_http_server.c
+ * @brief Lokalni HTTP/1.1 strežnik za teste shelly_manager-ja
+ */
+#include "test_http_server.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+static int s_listen_fd = -1;
+static int s_conn_fd = -1;
+static test_http_handler_t s_handler = NULL;
+static test_http_stats_t s_stats = {0};
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * @brief Prebere eno zahtevo (glava + telo po Content-Length)
+ * @return false ko odjemalec zapre povezavo
+ */
+static bool read_request(int fd, test_http_request_t *req)
+{
+    char buf[2048];
+    int have = 0;
+    char *body = NULL;
+
+    while (body == NULL) {
+        if (have >= (int)sizeof(buf) - 1) {
+            return false;
+        }
+        ssize_t n = recv(fd, buf + have, sizeof(buf) - 1 - have, 0);
+        if (n <= 0) {
+            return false;
+        }
+        have += (int)n;
+        buf[have] = '\0';
+        body = strstr(buf, "\r\n\r\n");
+    }
+    *body = '\0';
+    body += 4;
+
+    memset(req, 0, sizeof(*req));
+    if (sscanf(buf, "%7s %159s", req->method, req->path) != 2) {
+        return false;
+    }
+
+    int content_length = 0;
+    for (char *line = strstr(buf, "\r\n"); line; line = strstr(line + 2, "\r\n")) {
+        if (strncasecmp(line + 2, "Content-Length:", 15) == 0) {
+            content_length = atoi(line + 17);
+        }
+    }
+    if (content_length >= (int)sizeof(req->body)) {
+        return false;
+    }
+
+    int body_have = have - (int)(body - buf);
+    memcpy(req->body, body, (size_t)body_have);
+    while (body_have < content_length) {
+        ssize_t n = recv(fd, req->body + body_have, (size_t)(content_length - body_have), 0);
+        if (n <= 0) {
+            return false;
+        }
+        body_have += (int)n;
+    }
+    req->body[content_length] = '\0';
+    return true;
+}
+
+static void send_reply(int fd, const test_http_reply_t *reply)
+{
+    static const char *const reasons[] = { [200] = "OK", [400] = "Bad Request", [404] = "Not Found" };
+    const char *body = reply->body ? reply->body : "";
+    const char *reason = (reply->status < (int)(sizeof(reasons) / sizeof(reasons[0])) &&
+                          reasons[reply->status]) ? reasons[reply->status] : "Error";
+    char head[256];
+
+    int len = snprintf(head, sizeof(head),
+                       "HTTP/1.1 %d %s\r\nContent-Type: application/json\r\n"
+                       "Content-Length: %zu\r\nConnection: %s\r\n\r\n",
+                       reply->status, reason, strlen(body), reply->close ? "close" : "keep-alive");
+    send(fd, head, (size_t)len, MSG_NOSIGNAL);
+    send(fd, body, strlen(body), MSG_NOSIGNAL);
+}
+
+static void serve_connection(int fd)
+{
+    test_http_request_t req;
+
+    while (read_request(fd, &req)) {
+        test_http_reply_t reply = { .status = 200 };
+
+        pthread_mutex_lock(&s_lock);
+        test_http_handler_t handler = s_handler;
+        s_stats.requests++;
+        pthread_mutex_unlock(&s_lock);
+
+        if (handler) {
+            handler(&req, &reply);
+        }
+        if (reply.delay_ms > 0) {
+            usleep((useconds_t)reply.delay_ms * 1000);
+        }
+        if (reply.drop) {
+            break;
+        }
+        send_reply(fd, &reply);
+        if (reply.close) {
+            break;
+        }
+    }
+}
+
+static void *server_thread(void *arg)
+{
+    (void)arg;
+
+    while (1) {
+        int fd = accept(s_listen_fd, NULL, NULL);
+        if (fd < 0) {
+            continue;
+        }
+
+        pthread_mutex_lock(&s_lock);
+        s_conn_fd = fd;
+        s_stats.connections++;
+        pthread_mutex_unlock(&s_lock);
+
+        serve_connection(fd);
+
+        pthread_mutex_lock(&s_lock);
+        s_conn_fd = -1;
+        pthread_mutex_unlock(&s_lock);
+        close(fd);
+    }
+    return NULL;
+}
+
+int test_http_server_start(test_http_handler_t handler)
+{
+    struct sockaddr_in addr = {
+        .sin_family = AF_INET,
+        .sin_addr.s_addr = htonl(INADDR_LOOPBACK),
+        .sin_port = 0,      // Naključen prost port
+    };
+    socklen_t addr_len = sizeof(addr);
+
+    s_handler = handler;
+    s_listen_fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (s_listen_fd < 0 ||
+        bind(s_listen_fd, (struct sockaddr *)&addr, sizeof(addr)) != 0 ||
+        listen(s_listen_fd, 4) != 0 ||
+        getsockname(s_listen_fd, (struct sockaddr *)&addr, &addr_len) != 0) {
+        perror("test_http_server");
+        return -1;
+    }
+
+    pthread_t thread;
+    if (pthread_create(&thread, NULL, server_thread, NULL) != 0) {
+        return -1;
+    }
+    pthread_detach(thread);
+    return ntohs(addr.sin_port);
+}
+
+void test_http_server_set_handler(test_http_handler_t handler)
+{
+    pthread_mutex_lock(&s_lock);
+    s_handler = handler;
+    pthread_mutex_unlock(&s_lock);
+}
+
+void test_http_server_close_idle(void)
+{
+    pthread_mutex_lock(&s_lock);
+    if (s_conn_fd >= 0) {
+        shutdown(s_conn_fd, SHUT_RDWR);
+    }
+    pthread_mutex_unlock(&s_lock);
+    usleep(20000);      // Strežnik zapre socket, preden odjemalec pošlje naslednjo zahtevo
+}
+
+void test_http_server_get_stats(test_http_stats_t *stats)
+{
+    pthread_mutex_lock(&s_lock);
+    *stats = s_stats;
+    pthread_mutex_unlock(&s_lock);
+}
@@ -0,0 +1,66 @@
+/**
+ * @file test_http_server.h
+ * @brief Lokalni HTTP/1.1 strežnik za teste (stand-in za Shelly napravo)
+ *
+ * Posluša na 127.0.0.1 na naključnem portu in streže eno povezavo naenkrat
+ * (kot Shelly). Odgovor za vsako zahtevo pripravi handler testa.
+ */
+#ifndef TEST_HTTP_SERVER_H
+#define TEST_HTTP_SERVER_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/**
+ * @brief Prejeta zahteva
+ */
+typedef struct {
+    char method[8];
+    char path[160];
+    char body[512];
+} test_http_request_t;
+
+/**
+ * @brief Odgovor, ki ga izpolni handler (privzeto 200, prazno telo)
+ */
+typedef struct {
+    int status;
+    const char *body;
+    bool close;             // "Connection: close" in zapri po odgovoru
+    bool drop;              // Zapri povezavo brez odgovora
+    int delay_ms;           // Zamik pred odgovorom
+} test_http_reply_t;
+
+typedef void (*test_http_handler_t)(const test_http_request_t *req, test_http_reply_t *reply);
+
+/**
+ * @brief Števci strežnika
+ */
+typedef struct {
+    uint32_t connections;   // Sprejete TCP povezave
+    uint32_t requests;      // Obdelane zahteve
+} test_http_stats_t;
+
+/**
+ * @brief Zažene strežnik v svoji niti
+ * @param handler Pripravi odgovor za vsako zahtevo
+ * @return Port ali -1 ob napaki
+ */
+int test_http_server_start(test_http_handler_t handler);
+
+/**
+ * @brief Zamenja handler (velja od naslednje zahteve)
+ */
+void test_http_server_set_handler(test_http_handler_t handler);
+
+/**
+ * @brief Zapre trenutno odprto povezavo (kot Shelly po idle timeoutu)
+ */
+void test_http_server_close_idle(void);
+
+/**
+ * @brief Vrne števce strežnika
+ */
+void test_http_server_get_stats(test_http_stats_t *stats);
+
+#endif // TEST_HTTP_SERVER_H
@@ -0,0 +1,257 @@
+/**
+ * @file test_schedule_table.c
+ * @brief Unit testi za schedule_table (tedenska tabela, počitnice, override)
+ *
+ * Časi so lokalni v SCHEDULE_TIMEZONE (CET/CEST), tako kot na napravi.
+ * Teden 2026-10-19 (ponedeljek) vključuje prehod CEST → CET v nedeljo 25. 10.
+ */
+#include "schedule_table.h"
+#include "config.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+static const schedule_period_t s_periods[] = {
+    { SCHEDULE_WEEKDAYS, 6,  0, 21.0f },
+    { SCHEDULE_WEEKDAYS, 22, 0, 18.0f },
+    { SCHEDULE_WEEKEND,  7, 30, 21.0f },
+    { SCHEDULE_WEEKEND,  23, 0, 18.0f },
+    { SCHEDULE_DAY(3),   6,  0, 22.0f },   // Sreda ob isti minuti - kasnejše pravilo velja
+};
+
+static schedule_table_t s_table;
+
+/**
+ * @brief Lokalni čas → time_t (mktime sam izbere CET/CEST)
+ */
+static time_t at(int year, int month, int day, int hour, int minute)
+{
+    struct tm tm = {
+        .tm_year = year - 1900,
+        .tm_mon = month - 1,
+        .tm_mday = day,
+        .tm_hour = hour,
+        .tm_min = minute,
+        .tm_isdst = -1,
+    };
+    return mktime(&tm);
+}
+
+static void compile_default(void)
+{
+    memset(&s_table, 0, sizeof(s_table));
+    TEST_CHECK(schedule_table_compile(&s_table, s_periods,
+                                      sizeof(s_periods) / sizeof(s_periods[0])));
+}
+
+static void test_compile_sorted(void)
+{
+    compile_default();
+
+    // 2×5 + 2×2 prehodov, sredin 06:00 se združi v enega
+    TEST_CHECK(s_table.count == 14);
+    for (int i = 1; i < s_table.count; i++) {
+        TEST_CHECK(s_table.transitions[i - 1].minute_of_week < s_table.transitions[i].minute_of_week);
+    }
+
+    schedule_period_t bad = { SCHEDULE_WEEKDAYS, 24, 0, 21.0f };
+    TEST_CHECK(!schedule_table_compile(&s_table, &bad, 1));
+    TEST_CHECK(s_table.count == 14);     // Neveljavno pravilo ne pokvari tabele
+}
+
+static void test_weekday_weekend(void)
+{
+    schedule_status_t s;
+    compile_default();
+
+    TEST_CHECK(schedule_table_lookup(&s_table, at(2026, 10, 19, 5, 59), &s));
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_WEEKLY);
+    TEST_CHECK_FLOAT(s.target, 18.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 19, 6, 0));
+    TEST_CHECK_FLOAT(s.next_target, 21.0f, 1e-6);
+
+    schedule_table_lookup(&s_table, at(2026, 10, 19, 6, 0), &s);
+    TEST_CHECK_FLOAT(s.target, 21.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 19, 22, 0));
+
+    // Sobota: ob 06:00 še noč, dan se začne ob 07:30
+    schedule_table_lookup(&s_table, at(2026, 10, 24, 6, 30), &s);
+    TEST_CHECK_FLOAT(s.target, 18.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 24, 7, 30));
+
+    schedule_table_lookup(&s_table, at(2026, 10, 24, 22, 30), &s);
+    TEST_CHECK_FLOAT(s.target, 21.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 24, 23, 0));
+}
+
+static void test_same_minute_precedence(void)
+{
+    schedule_status_t s;
+    compile_default();
+
+    schedule_table_lookup(&s_table, at(2026, 10, 21, 6, 30), &s);
+    TEST_CHECK_FLOAT(s.target, 22.0f, 1e-6);
+
+    schedule_table_lookup(&s_table, at(2026, 10, 20, 22, 30), &s);
+    TEST_CHECK(s.next_change == at(2026, 10, 21, 6, 0));
+    TEST_CHECK_FLOAT(s.next_target, 22.0f, 1e-6);
+}
+
+static void test_week_wrap(void)
+{
+    schedule_status_t s;
+    compile_default();
+
+    // Nedelja pred prvim prehodom v tednu → zadnji prehod prejšnjega tedna
+    schedule_table_lookup(&s_table, at(2026, 10, 18, 3, 0), &s);
+    TEST_CHECK_FLOAT(s.target, 18.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 18, 7, 30));
+
+    // Nedelja zvečer → naslednji prehod je ponedeljek v novem tednu
+    schedule_table_lookup(&s_table, at(2026, 10, 18, 23, 30), &s);
+    TEST_CHECK_FLOAT(s.target, 18.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 19, 6, 0));
+    TEST_CHECK_FLOAT(s.next_target, 21.0f, 1e-6);
+
+    // En sam prehod na teden: naslednji je čez cel teden
+    schedule_period_t one = { SCHEDULE_DAY(1), 6, 0, 20.0f };
+    TEST_CHECK(schedule_table_compile(&s_table, &one, 1));
+    schedule_table_lookup(&s_table, at(2026, 10, 12, 6, 0), &s);
+    TEST_CHECK_FLOAT(s.target, 20.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 19, 6, 0));
+}
+
+static void test_dst_cest_to_cet(void)
+{
+    schedule_status_t s;
+    compile_default();
+
+    // Sobota 23:30 CEST → nedelja 07:30 CET: 8 h na uri, 9 h dejansko
+    time_t now = at(2026, 10, 24, 23, 30);
+    schedule_table_lookup(&s_table, now, &s);
+    TEST_CHECK(s.next_change == at(2026, 10, 25, 7, 30));
+    TEST_CHECK(s.next_change - now == 9 * 3600);
+
+    struct tm tm;
+    localtime_r(&s.next_change, &tm);
+    TEST_CHECK(tm.tm_hour == 7 && tm.tm_min == 30 && tm.tm_isdst == 0);
+
+    // Ponovljena ura 02:00-03:00 (oba primerka) ostane nočni target
+    time_t first = at(2026, 10, 25, 1, 59) + 60;
+    for (time_t t = first; t < first + 2 * 3600; t += 15 * 60) {
+        schedule_table_lookup(&s_table, t, &s);
+        TEST_CHECK_FLOAT(s.target, 18.0f, 1e-6);
+        TEST_CHECK(s.next_change == at(2026, 10, 25, 7, 30));
+    }
+}
+
+static void test_holidays(void)
+{
+    schedule_status_t s;
+    compile_default();
+
+    schedule_holiday_t trip = { at(2026, 10, 20, 0, 0), at(2026, 10, 22, 12, 0), 16.0f };
+    schedule_holiday_t overlap = { at(2026, 10, 21, 0, 0), at(2026, 10, 23, 0, 0), 16.0f };
+    schedule_holiday_t empty = { at(2026, 10, 26, 0, 0), at(2026, 10, 26, 0, 0), 16.0f };
+    TEST_CHECK(schedule_table_add_holiday(&s_table, &trip));
+    TEST_CHECK(!schedule_table_add_holiday(&s_table, &overlap));
+    TEST_CHECK(!schedule_table_add_holiday(&s_table, &empty));
+    TEST_CHECK(s_table.holiday_count == 1);
+
+    // Začetek počitnic pride pred jutranji prehod
+    schedule_table_lookup(&s_table, at(2026, 10, 19, 23, 0), &s);
+    TEST_CHECK(s.next_change == trip.start);
+    TEST_CHECK_FLOAT(s.next_target, 16.0f, 1e-6);
+
+    schedule_table_lookup(&s_table, at(2026, 10, 21, 8, 0), &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_HOLIDAY);
+    TEST_CHECK_FLOAT(s.target, 16.0f, 1e-6);
+    TEST_CHECK(s.next_change == trip.end);
+    TEST_CHECK_FLOAT(s.next_target, 21.0f, 1e-6);  // Četrtek 12:00 je dan
+
+    schedule_table_lookup(&s_table, trip.end, &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_WEEKLY);
+
+    schedule_table_prune_holidays(&s_table, at(2026, 10, 22, 11, 59));
+    TEST_CHECK(s_table.holiday_count == 1);
+    schedule_table_prune_holidays(&s_table, trip.end);
+    TEST_CHECK(s_table.holiday_count == 0);
+}
+
+static void test_override_expiry(void)
+{
+    schedule_status_t s;
+    compile_default();
+
+    // until = 0 → do naslednjega prehoda urnika
+    time_t now = at(2026, 10, 19, 8, 0);
+    schedule_table_set_override(&s_table, 23.0f, 0, now);
+    schedule_table_lookup(&s_table, now, &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_OVERRIDE);
+    TEST_CHECK_FLOAT(s.target, 23.0f, 1e-6);
+    TEST_CHECK(s.next_change == at(2026, 10, 19, 22, 0));
+    TEST_CHECK_FLOAT(s.next_target, 18.0f, 1e-6);
+
+    schedule_table_lookup(&s_table, at(2026, 10, 19, 21, 59), &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_OVERRIDE);
+    schedule_table_lookup(&s_table, at(2026, 10, 19, 22, 0), &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_WEEKLY);
+    TEST_CHECK_FLOAT(s.target, 18.0f, 1e-6);
+
+    // Eksplicitni konec ima prednost tudi pred počitnicami
+    schedule_holiday_t trip = { at(2026, 10, 20, 0, 0), at(2026, 10, 21, 0, 0), 16.0f };
+    TEST_CHECK(schedule_table_add_holiday(&s_table, &trip));
+    schedule_table_set_override(&s_table, 20.0f, at(2026, 10, 20, 12, 0), now);
+    schedule_table_lookup(&s_table, at(2026, 10, 20, 11, 0), &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_OVERRIDE);
+    TEST_CHECK_FLOAT(s.next_target, 16.0f, 1e-6);
+    schedule_table_lookup(&s_table, at(2026, 10, 20, 12, 0), &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_HOLIDAY);
+
+    schedule_table_set_override(&s_table, 20.0f, at(2026, 10, 20, 12, 0), now);
+    schedule_table_clear_override(&s_table);
+    schedule_table_lookup(&s_table, now, &s);
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_WEEKLY);
+}
+
+static void test_empty_schedule(void)
+{
+    schedule_status_t s;
+    memset(&s_table, 0, sizeof(s_table));
+    time_t now = at(2026, 10, 19, 8, 0);
+
+    TEST_CHECK(!schedule_table_lookup(&s_table, now, &s));
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_NONE);
+    TEST_CHECK(s.next_change == 0);
+
+    // Brez urnika override velja do preklica
+    schedule_table_set_override(&s_table, 19.0f, 0, now);
+    TEST_CHECK(schedule_table_lookup(&s_table, now + 30 * 86400, &s));
+    TEST_CHECK(s.source == SCHEDULE_SOURCE_OVERRIDE);
+    TEST_CHECK(s.next_change == 0);
+
+    // Počitnice brez tedenskega urnika: pred in po njih ni targeta
+    schedule_table_clear_override(&s_table);
+    schedule_holiday_t trip = { at(2026, 10, 20, 0, 0), at(2026, 10, 21, 0, 0), 16.0f };
+    TEST_CHECK(schedule_table_add_holiday(&s_table, &trip));
+    TEST_CHECK(!schedule_table_lookup(&s_table, now, &s));
+    TEST_CHECK(s.next_change == trip.start);
+    TEST_CHECK(schedule_table_lookup(&s_table, at(2026, 10, 20, 8, 0), &s));
+    TEST_CHECK(!schedule_table_lookup(&s_table, trip.end, &s));
+}
+
+int main(void)
+{
+    setenv("TZ", SCHEDULE_TIMEZONE, 1);
+    tzset();
+
+    TEST_RUN(test_compile_sorted);
+    TEST_RUN(test_weekday_weekend);
+    TEST_RUN(test_same_minute_precedence);
+    TEST_RUN(test_week_wrap);
+    TEST_RUN(test_dst_cest_to_cet);
+    TEST_RUN(test_holidays);
+    TEST_RUN(test_override_expiry);
+    TEST_RUN(test_empty_schedule);
+    return TEST_EXIT();
+}
@@ -0,0 +1,200 @@
+/**
+ * @file test_sensor_filter.c
+ * @brief Unit testi za sensor_filter + preklopi histereze na posnetem dnevu
+ *
+ * Posnetek winter_day.csv (60 s) se interpolira na 2 s vzorce, doda se šum
+ * in osamljene napake kot pri motnjah na I2C. Isti komparator kot v
+ * furnace_controller (vklop 0.5 °C pod, izklop 0.3 °C nad targetom) šteje
+ * preklope na surovi in na filtrirani vrednosti.
+ */
+#include "sensor_filter.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+#define TRACE_MAX_ROWS      2000
+#define SAMPLE_INTERVAL_S   2
+#define HYST_LOW            0.5f
+#define HYST_HIGH           0.3f
+#define TARGET_C            21.0f
+
+static const char *s_trace_path = NULL;
+static uint32_t s_rng = 12345;
+
+static float rand_unit(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return (s_rng >> 8) / 16777216.0f;
+}
+
+static float rand_normal(void)
+{
+    float sum = 0.0f;
+    for (int i = 0; i < 12; i++) {
+        sum += rand_unit();
+    }
+    return sum - 6.0f;
+}
+
+static void test_median_rejects_spike(void)
+{
+    sensor_filter_config_t cfg = SENSOR_FILTER_DEFAULT_CONFIG();
+    cfg.smoother = SENSOR_SMOOTHER_NONE;
+    sensor_filter_t f;
+    sensor_filter_init(&f, &cfg);
+
+    for (int i = 0; i < 10; i++) {
+        TEST_CHECK_FLOAT(sensor_filter_update(&f, 21.0f), 21.0f, 1e-3);
+    }
+    TEST_CHECK_FLOAT(sensor_filter_update(&f, 24.0f), 21.0f, 1e-3);
+    TEST_CHECK_FLOAT(sensor_filter_update(&f, 18.0f), 21.0f, 1e-3);
+    TEST_CHECK_FLOAT(sensor_filter_update(&f, 21.0f), 21.0f, 1e-3);
+}
+
+static void test_ema_step(void)
+{
+    sensor_filter_config_t cfg = SENSOR_FILTER_DEFAULT_CONFIG();
+    cfg.median_len = 1;
+    sensor_filter_t f;
+    sensor_filter_init(&f, &cfg);
+
+    TEST_CHECK_FLOAT(sensor_filter_update(&f, 20.0f), 20.0f, 1e-4);
+    TEST_CHECK_FLOAT(sensor_filter_update(&f, 21.0f), 20.3f, 1e-4);
+    TEST_CHECK_FLOAT(sensor_filter_update(&f, 21.0f), 20.51f, 1e-4);
+
+    sensor_filter_reset(&f);
+    TEST_CHECK_FLOAT(sensor_filter_update(&f, 18.0f), 18.0f, 1e-4);
+}
+
+static void test_kalman_settles(void)
+{
+    sensor_filter_config_t cfg = SENSOR_FILTER_DEFAULT_CONFIG();
+    cfg.median_len = 1;
+    cfg.smoother = SENSOR_SMOOTHER_KALMAN;
+    sensor_filter_t f;
+    sensor_filter_init(&f, &cfg);
+
+    s_rng = 777;
+    double err2 = 0.0;
+    int n = 0;
+    for (int i = 0; i < 2000; i++) {
+        float out = sensor_filter_update(&f, 20.0f + 0.1f * rand_normal());
+        if (i >= 200) {
+            err2 += (out - 20.0f) * (out - 20.0f);
+            n++;
+        }
+    }
+    // Šum σ 0.1 °C → ocena mora biti bistveno mirnejša od vhoda
+    TEST_CHECK(sqrt(err2 / n) < 0.04);
+}
+
+static void test_fixed_point_matches_float(void)
+{
+    const sensor_smoother_t smoothers[] = { SENSOR_SMOOTHER_NONE, SENSOR_SMOOTHER_EMA,
+                                            SENSOR_SMOOTHER_KALMAN };
+
+    for (size_t s = 0; s < sizeof(smoothers) / sizeof(smoothers[0]); s++) {
+        sensor_filter_config_t cfg = SENSOR_FILTER_DEFAULT_CONFIG();
+        cfg.smoother = smoothers[s];
+        sensor_filter_t f_float, f_fixed;
+        sensor_filter_init(&f_float, &cfg);
+        cfg.fixed_point = true;
+        sensor_filter_init(&f_fixed, &cfg);
+
+        s_rng = 4242;
+        float max_diff = 0.0f;
+        for (int i = 0; i < 5000; i++) {
+            float raw = 20.0f + 2.0f * sinf(i * 0.002f) + 0.2f * rand_normal();
+            float diff = fabsf(sensor_filter_update(&f_float, raw) -
+                               sensor_filter_update(&f_fixed, raw));
+            if (diff > max_diff) {
+                max_diff = diff;
+            }
+        }
+        TEST_CHECK(max_diff < 0.01f);
+    }
+}
+
+/**
+ * @brief Komparator z isto histerezo kot furnace_controller
+ */
+static void hysteresis_step(bool *on, float temp, uint32_t *toggles)
+{
+    if (!*on && temp < TARGET_C - HYST_LOW) {
+        *on = true;
+        (*toggles)++;
+    } else if (*on && temp > TARGET_C + HYST_HIGH) {
+        *on = false;
+        (*toggles)++;
+    }
+}
+
+static void test_winter_day_toggles(void)
+{
+    FILE *f = fopen(s_trace_path, "r");
+    TEST_CHECK(f != NULL);
+    if (f == NULL) {
+        return;
+    }
+
+    static float time_s[TRACE_MAX_ROWS], room_c[TRACE_MAX_ROWS];
+    int rows = 0;
+    char line[128];
+    while (fgets(line, sizeof(line), f) && rows < TRACE_MAX_ROWS) {
+        float t, room, outdoor;
+        if (sscanf(line, "%f,%f,%f", &t, &room, &outdoor) == 3) {
+            time_s[rows] = t;
+            room_c[rows] = room;
+            rows++;
+        }
+    }
+    fclose(f);
+    TEST_CHECK(rows > 1000);
+    if (rows < 2) {
+        return;
+    }
+
+    sensor_filter_t filter;
+    sensor_filter_init(&filter, NULL);
+    s_rng = 1;
+
+    bool raw_on = false, filt_on = false;
+    uint32_t raw_toggles = 0, filt_toggles = 0;
+    int row = 0;
+    for (float t = time_s[0]; t <= time_s[rows - 1]; t += SAMPLE_INTERVAL_S) {
+        while (row < rows - 2 && time_s[row + 1] <= t) {
+            row++;
+        }
+        float k = (t - time_s[row]) / (time_s[row + 1] - time_s[row]);
+        float truth = room_c[row] + k * (room_c[row + 1] - room_c[row]);
+
+        // Šum σ 0.15 °C + 1 % osamljenih napak ±3 °C, ločljivost 0.01 °C
+        float raw = truth + 0.15f * rand_normal();
+        if (rand_unit() < 0.01f) {
+            raw += (rand_unit() < 0.5f) ? -3.0f : 3.0f;
+        }
+        raw = roundf(raw * 100.0f) / 100.0f;
+
+        hysteresis_step(&raw_on, raw, &raw_toggles);
+        hysteresis_step(&filt_on, sensor_filter_update(&filter, raw), &filt_toggles);
+    }
+
+    printf("  winter_day toggles: raw %u, median-5 + EMA 0.3 %u\n",
+           (unsigned)raw_toggles, (unsigned)filt_toggles);
+    TEST_CHECK(raw_toggles >= 100);
+    TEST_CHECK(filt_toggles * 5 <= raw_toggles);
+}
+
+int main(int argc, char **argv)
+{
+    s_trace_path = (argc > 1) ? argv[1] : "traces/winter_day.csv";
+
+    TEST_RUN(test_median_rejects_spike);
+    TEST_RUN(test_ema_step);
+    TEST_RUN(test_kalman_settles);
+    TEST_RUN(test_fixed_point_matches_float);
+    TEST_RUN(test_winter_day_toggles);
+    return TEST_EXIT();
+}
@@ -0,0 +1,192 @@
+/**
+ * @file test_sensor_history.c
+ * @brief Unit testi za sensor_history: inkrementalne statistike proti polnemu izračunu
+ *
+ * Vsak push se primerja z naivnim izračunom čez zadnjih N vzorcev ringa
+ * (mean, min, max, varianca, trend, vlaga) - tudi čez preliv ringa in
+ * pri intervalih, kjer je okno omejeno s kapaciteto deque-a.
+ */
+#include "sensor_history.h"
+#include "test_common.h"
+#include <stdlib.h>
+#include <string.h>
+
+static sensor_history_t s_history;
+
+static uint32_t s_rng = 12345;
+
+static float rand_unit(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return (s_rng >> 8) / 16777216.0f;
+}
+
+/**
+ * @brief Naivne statistike čez zadnjih n vzorcev (age 0..n-1)
+ */
+static void reference_stats(const sensor_history_t *h, uint16_t n, sensor_window_stats_t *ref)
+{
+    double sum = 0.0, sum_sq = 0.0, sum_hum = 0.0, sum_jx = 0.0;
+    int16_t min = INT16_MAX, max = INT16_MIN;
+    sensor_sample_t s;
+
+    for (uint16_t age = 0; age < n; age++) {
+        sensor_history_get_sample(h, age, &s);
+        double x = s.temp_centi;
+        uint16_t j = n - 1 - age;      // Najstarejši = 0
+        sum += x;
+        sum_sq += x * x;
+        sum_jx += j * x;
+        sum_hum += s.hum_centi;
+        if (s.temp_centi < min) min = s.temp_centi;
+        if (s.temp_centi > max) max = s.temp_centi;
+    }
+
+    double mean = sum / n;
+    memset(ref, 0, sizeof(*ref));
+    ref->count = n;
+    ref->mean = (float)(mean / 100.0);
+    ref->min = min / 100.0f;
+    ref->max = max / 100.0f;
+    ref->variance = (float)((sum_sq / n - mean * mean) / 10000.0);
+    ref->humidity_mean = (float)(sum_hum / n / 100.0);
+
+    if (n >= 2) {
+        sensor_sample_t newest, oldest;
+        sensor_history_get_sample(h, 0, &newest);
+        sensor_history_get_sample(h, n - 1, &oldest);
+        double sxx = (double)n * ((double)n * n - 1.0) / 12.0;
+        double sxy = sum_jx - (n - 1.0) / 2.0 * sum;
+        double interval_ms = (double)(newest.time_ms - oldest.time_ms) / (n - 1.0);
+        ref->trend_per_hour = (float)(sxy / sxx / 100.0 * 3600000.0 / interval_ms);
+    }
+}
+
+static void check_window(sensor_window_t w, uint16_t expected_size)
+{
+    sensor_window_stats_t got, ref;
+    uint16_t n = s_history.count < expected_size ? s_history.count : expected_size;
+
+    TEST_CHECK(sensor_history_get_stats(&s_history, w, &got));
+    reference_stats(&s_history, n, &ref);
+
+    TEST_CHECK(got.count == n);
+    TEST_CHECK_FLOAT(got.mean, ref.mean, 1e-4);
+    TEST_CHECK_FLOAT(got.min, ref.min, 1e-6);
+    TEST_CHECK_FLOAT(got.max, ref.max, 1e-6);
+    TEST_CHECK_FLOAT(got.variance, ref.variance, 1e-3);
+    TEST_CHECK_FLOAT(got.trend_per_hour, ref.trend_per_hour, 1e-3);
+    TEST_CHECK_FLOAT(got.humidity_mean, ref.humidity_mean, 1e-3);
+}
+
+/**
+ * @brief Naključni sprehod s skoki, preliv ringa, primerjava ob vsakem N-tem vzorcu
+ */
+static void run_against_reference(uint32_t interval_ms, const uint16_t sizes[SENSOR_WINDOW_COUNT])
+{
+    sensor_history_init(&s_history, interval_ms);
+
+    float temp = 20.0f;
+    uint32_t now = 0xFFFF0000u;     // time_ms se med testom prelije
+    int failures_before = s_test_failures;
+
+    for (int i = 0; i < 3 * SENSOR_HISTORY_LEN + 17; i++) {
+        temp += (rand_unit() - 0.5f) * 0.1f;
+        if (rand_unit() < 0.01f) {
+            temp += (rand_unit() < 0.5f) ? -3.0f : 3.0f;
+        }
+        sensor_history_push(&s_history, now, temp, 40.0f + 10.0f * rand_unit());
+        now += interval_ms;
+
+        if (i < 64 || i % 97 == 0) {
+            for (int w = 0; w < SENSOR_WINDOW_COUNT; w++) {
+                check_window((sensor_window_t)w, sizes[w]);
+            }
+        }
+        if (s_test_failures != failures_before) {
+            fprintf(stderr, "  interval %u ms, sample %d\n", (unsigned)interval_ms, i);
+            return;
+        }
+    }
+}
+
+static void test_default_interval(void)
+{
+    const uint16_t sizes[] = { 30, 300, 1800 };
+    run_against_reference(2000, sizes);
+}
+
+static void test_slow_interval(void)
+{
+    const uint16_t sizes[] = { 6, 60, 360 };
+    run_against_reference(10000, sizes);
+}
+
+static void test_fast_interval_capped(void)
+{
+    // Pri 500 ms bi okna potrebovala 120/1200/7200 vzorcev - omejena so s kapaciteto
+    const uint16_t sizes[] = { SENSOR_WINDOW_1MIN_CAP, SENSOR_WINDOW_10MIN_CAP, SENSOR_WINDOW_1H_CAP };
+    run_against_reference(500, sizes);
+}
+
+static void test_monotonic_extremes(void)
+{
+    // Naraščajoče zaporedje: min deque ima vedno celo okno (najslabši primer kapacitete)
+    sensor_window_stats_t st;
+    sensor_history_init(&s_history, 2000);
+
+    for (int i = 0; i < 2 * SENSOR_HISTORY_LEN; i++) {
+        sensor_history_push(&s_history, (uint32_t)i * 2000, -20.0f + i * 0.01f, 50.0f);
+    }
+    TEST_CHECK(sensor_history_get_stats(&s_history, SENSOR_WINDOW_1H, &st));
+    TEST_CHECK_FLOAT(st.min, -20.0f + SENSOR_HISTORY_LEN * 0.01f, 1e-4);
+    TEST_CHECK_FLOAT(st.max, -20.0f + (2 * SENSOR_HISTORY_LEN - 1) * 0.01f, 1e-4);
+    TEST_CHECK_FLOAT(st.trend_per_hour, 0.01f * 1800.0f, 1e-2);
+
+    for (int i = 0; i < 2 * SENSOR_HISTORY_LEN; i++) {
+        sensor_history_push(&s_history, (uint32_t)i * 2000, 30.0f - i * 0.01f, 50.0f);
+    }
+    TEST_CHECK(sensor_history_get_stats(&s_history, SENSOR_WINDOW_1MIN, &st));
+    TEST_CHECK(st.count == SENSOR_WINDOW_1MIN_CAP);
+    TEST_CHECK_FLOAT(st.max - st.min, (SENSOR_WINDOW_1MIN_CAP - 1) * 0.01f, 1e-4);
+}
+
+static void test_empty_and_bounds(void)
+{
+    sensor_window_stats_t st;
+    sensor_sample_t sample;
+    sensor_history_init(&s_history, 2000);
+
+    TEST_CHECK(!sensor_history_get_stats(&s_history, SENSOR_WINDOW_1MIN, &st));
+    TEST_CHECK(!sensor_history_get_stats(&s_history, SENSOR_WINDOW_COUNT, &st));
+    TEST_CHECK(!sensor_history_get_sample(&s_history, 0, &sample));
+
+    sensor_history_push(&s_history, 1000, -5.25f, 30.0f);
+    TEST_CHECK(sensor_history_get_sample(&s_history, 0, &sample));
+    TEST_CHECK(sample.temp_centi == -525 && sample.time_ms == 1000);
+    TEST_CHECK(!sensor_history_get_sample(&s_history, 1, &sample));
+    TEST_CHECK(sensor_history_get_stats(&s_history, SENSOR_WINDOW_1H, &st));
+    TEST_CHECK(st.count == 1 && st.trend_per_hour == 0.0f);
+}
+
+static void test_footprint(void)
+{
+    // 1800 × 8 B ring + 4260 × 2 B deque (prej 10800 × 2 B)
+    printf("  sizeof(sensor_history_t) = %zu B (deque pool %zu B)\n",
+           sizeof(sensor_history_t), sizeof(s_history.deque_pool));
+    TEST_CHECK(SENSOR_HISTORY_DEQUE_LEN == 4260);
+    TEST_CHECK(sizeof(s_history.deque_pool) == 4260 * sizeof(uint16_t));
+}
+
+int main(void)
+{
+    TEST_RUN(test_default_interval);
+    TEST_RUN(test_slow_interval);
+    TEST_RUN(test_fast_interval_capped);
+    TEST_RUN(test_monotonic_extremes);
+    TEST_RUN(test_empty_and_bounds);
+    TEST_RUN(test_footprint);
+    return TEST_EXIT();
+}
@@ -0,0 +1,283 @@
+/**
+ * @file test_shelly_batch.c
+ * @brief JSON-RPC batch in prehod na posamične klice proti lokalnemu strežniku
+ *
+ * Batch se izklopi le, ko ga naprava zavrne (HTTP 400/404 ali en error
+ * objekt namesto polja). Timeout in napaka enega klica v batchu ga ne
+ * izklopita; po zavrnitvi se batch čez 1 h (navidezni čas) poskusi znova.
+ */
+#include "shelly_manager.h"
+#include "host_port.h"
+#include "esp_log.h"
+#include "test_common.h"
+#include "test_http_server.h"
+#include <pthread.h>
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+#define SWITCH_STATUS \
+    "{\"id\":0,\"source\":\"HTTP_in\",\"output\":true,\"apower\":1523.4,\"voltage\":231.2," \
+    "\"current\":6.61,\"aenergy\":{\"total\":9321.4,\"by_minute\":[25.1,25.3,25.2]," \
+    "\"minute_ts\":1760563800},\"temperature\":{\"tC\":48.2,\"tF\":118.8}}"
+
+static const char s_batch_ok[] =
+    "[{\"id\":1,\"src\":\"shellyplus2pm-c4d8d5\",\"result\":{\"was_on\":false}},"
+    "{\"id\":2,\"src\":\"shellyplus2pm-c4d8d5\",\"result\":" SWITCH_STATUS "}]";
+
+// Stara firmware: batch ni veljaven zahtevek, odgovor je en error objekt
+static const char s_batch_top_error[] =
+    "{\"id\":null,\"src\":\"shellyplus2pm-c4d8d5\","
+    "\"error\":{\"code\":-32700,\"message\":\"Parse error\"}}";
+
+// Batch sprejet, a Switch.Set je spodletel (npr. zaklenjen kanal)
+static const char s_batch_element_error[] =
+    "[{\"id\":1,\"src\":\"shellyplus2pm-c4d8d5\",\"error\":{\"code\":-105,\"message\":\"Locked\"}},"
+    "{\"id\":2,\"src\":\"shellyplus2pm-c4d8d5\",\"result\":" SWITCH_STATUS "}]";
+
+typedef enum {
+    BATCH_OK = 0,
+    BATCH_HTTP_400,
+    BATCH_HTTP_404,
+    BATCH_TOP_ERROR,
+    BATCH_ELEMENT_ERROR,
+    BATCH_TIMEOUT,
+} batch_mode_t;
+
+static pthread_mutex_t s_lock = PTHREAD_MUTEX_INITIALIZER;
+static batch_mode_t s_mode = BATCH_OK;
+static uint32_t s_posts = 0;
+static uint32_t s_gets = 0;
+
+static void rpc_handler(const test_http_request_t *req, test_http_reply_t *reply)
+{
+    pthread_mutex_lock(&s_lock);
+    batch_mode_t mode = s_mode;
+    if (strcmp(req->method, "POST") == 0) {
+        s_posts++;
+    } else {
+        s_gets++;
+    }
+    pthread_mutex_unlock(&s_lock);
+
+    if (strcmp(req->method, "POST") == 0 && strcmp(req->path, "/rpc") == 0) {
+        switch (mode) {
+            case BATCH_OK:            reply->body = s_batch_ok; break;
+            case BATCH_HTTP_400:      reply->status = 400; break;
+            case BATCH_HTTP_404:      reply->status = 404; break;
+            case BATCH_TOP_ERROR:     reply->body = s_batch_top_error; break;
+            case BATCH_ELEMENT_ERROR: reply->body = s_batch_element_error; break;
+            case BATCH_TIMEOUT:       reply->body = s_batch_ok; reply->delay_ms = 500; break;
+        }
+    } else if (strncmp(req->path, "/rpc/Switch.Set?id=0&on=", 24) == 0) {
+        reply->body = "{\"was_on\":false}";
+    } else if (strcmp(req->path, "/rpc/Switch.GetStatus?id=0") == 0) {
+        reply->body = SWITCH_STATUS;
+    } else {
+        reply->status = 404;
+    }
+}
+
+static void set_mode(batch_mode_t mode)
+{
+    pthread_mutex_lock(&s_lock);
+    s_mode = mode;
+    pthread_mutex_unlock(&s_lock);
+}
+
+static void get_counts(uint32_t *posts, uint32_t *gets)
+{
+    pthread_mutex_lock(&s_lock);
+    *posts = s_posts;
+    *gets = s_gets;
+    pthread_mutex_unlock(&s_lock);
+}
+
+/**
+ * @brief En kontrolni cikel; vrne število POST in GET zahtev, ki jih je porabil
+ */
+static esp_err_t control_cycle(uint32_t *posts, uint32_t *gets, shelly_status_t *status)
+{
+    uint32_t p0, g0, p1, g1;
+
+    get_counts(&p0, &g0);
+    esp_err_t err = shelly_manager_set_relay_and_status(0, true, status);
+    get_counts(&p1, &g1);
+    *posts = p1 - p0;
+    *gets = g1 - g0;
+    return err;
+}
+
+static void check_status(const shelly_status_t *st)
+{
+    TEST_CHECK(st->online);
+    TEST_CHECK(st->output_0);
+    TEST_CHECK_FLOAT(st->power_0, 1523.4f, 1e-2);
+    TEST_CHECK_FLOAT(st->temperature, 48.2f, 1e-2);
+}
+
+// ═══════════════════════════════════════════════════════════
+// Testi
+// ═══════════════════════════════════════════════════════════
+
+static void test_batch_single_round_trip(void)
+{
+    shelly_status_t st;
+    uint32_t posts, gets;
+
+    shelly_manager_set_api(SHELLY_API_RPC);
+    set_mode(BATCH_OK);
+
+    for (int i = 0; i < 3; i++) {
+        TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+        TEST_CHECK(posts == 1 && gets == 0);
+        check_status(&st);
+    }
+}
+
+/**
+ * @brief Zavrnjen batch → ta cikel in naslednji gresta po posamičnih klicih
+ */
+static void check_rejected(batch_mode_t mode)
+{
+    shelly_status_t st;
+    uint32_t posts, gets;
+
+    shelly_manager_set_api(SHELLY_API_RPC);
+    set_mode(mode);
+
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 2);
+    check_status(&st);
+
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 0 && gets == 2);
+    check_status(&st);
+}
+
+static void test_http_400_falls_back(void)
+{
+    check_rejected(BATCH_HTTP_400);
+}
+
+static void test_http_404_falls_back(void)
+{
+    check_rejected(BATCH_HTTP_404);
+}
+
+static void test_top_level_error_falls_back(void)
+{
+    check_rejected(BATCH_TOP_ERROR);
+}
+
+static void test_element_error_keeps_batch(void)
+{
+    shelly_status_t st;
+    uint32_t posts, gets;
+
+    shelly_manager_set_api(SHELLY_API_RPC);
+    set_mode(BATCH_ELEMENT_ERROR);
+
+    // Napaka enega klica je napaka cikla, ne zavrnitev batcha
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_ERR_INVALID_RESPONSE);
+    TEST_CHECK(posts == 1 && gets == 0);
+    TEST_CHECK(!st.online);
+
+    set_mode(BATCH_OK);
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 0);
+    check_status(&st);
+}
+
+static void test_timeout_keeps_batch(void)
+{
+    shelly_status_t st;
+    uint32_t posts, gets;
+
+    shelly_manager_set_api(SHELLY_API_RPC);
+    set_mode(BATCH_TIMEOUT);
+
+    TEST_CHECK(control_cycle(&posts, &gets, &st) != ESP_OK);
+    TEST_CHECK(gets == 0);
+    TEST_CHECK(!st.online);
+
+    // Strežnik najprej odsluži zakasnjene zahteve
+    set_mode(BATCH_OK);
+    usleep(1500000);
+
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 0);
+    check_status(&st);
+}
+
+static void test_batch_retried_after_hour(void)
+{
+    shelly_status_t st;
+    uint32_t posts, gets;
+
+    shelly_manager_set_api(SHELLY_API_RPC);
+    set_mode(BATCH_HTTP_400);
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 2);
+
+    // Naprava po OTA batch podpira - do poteka ure ostanemo na posamičnih klicih
+    set_mode(BATCH_OK);
+    host_clock_advance_us(3599LL * 1000000);
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 0 && gets == 2);
+
+    host_clock_advance_us(1LL * 1000000);
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 0);
+    check_status(&st);
+
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 0);
+}
+
+static void test_retry_rejected_again(void)
+{
+    shelly_status_t st;
+    uint32_t posts, gets;
+
+    shelly_manager_set_api(SHELLY_API_RPC);
+    set_mode(BATCH_HTTP_404);
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 2);
+
+    // Ponovni poskus po 1 h spet zavrnjen → nov rok, vmes brez POST-a
+    host_clock_advance_us(3600LL * 1000000);
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 1 && gets == 2);
+
+    host_clock_advance_us(1800LL * 1000000);
+    TEST_CHECK(control_cycle(&posts, &gets, &st) == ESP_OK);
+    TEST_CHECK(posts == 0 && gets == 2);
+}
+
+int main(void)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    int port = test_http_server_start(rpc_handler);
+    if (port < 0) {
+        return 1;
+    }
+    char device[32];
+    snprintf(device, sizeof(device), "127.0.0.1:%d", port);
+    host_http_set_timeout_ms(300);
+
+    if (shelly_manager_init(device) != ESP_OK) {
+        return 1;
+    }
+
+    TEST_RUN(test_batch_single_round_trip);
+    TEST_RUN(test_http_400_falls_back);
+    TEST_RUN(test_http_404_falls_back);
+    TEST_RUN(test_top_level_error_falls_back);
+    TEST_RUN(test_element_error_keeps_batch);
+    TEST_RUN(test_timeout_keeps_batch);
+    TEST_RUN(test_batch_retried_after_hour);
+    TEST_RUN(test_retry_rejected_again);
+    return TEST_EXIT();
+}
@@ -0,0 +1,417 @@
+/**
+ * @file test_shelly_json.c
+ * @brief Korpus posnetih Shelly odgovorov + mutacijski fuzz za shelly_json
+ *
+ *   test_shelly_json <korpus> [mutacij na datoteko]
+ *
+ * Za vsako datoteko v korpusu (bad_* so namerno pokvarjene):
+ * - zaporedje callbackov je enako ne glede na razrez na kose,
+ * - izbrane vrednosti se ujemajo s pričakovanimi,
+ * - mutacije (zamenjani/vrinjeni/izbrisani byti, odrez, globoko gnezdenje)
+ *   ne smejo prekoračiti mej parserja in dajo enak rezultat v celem kosu
+ *   in v naključnih kosih.
+ */
+#include "shelly_json.h"
+#include "test_common.h"
+#include <dirent.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CORPUS_MAX_FILES    32
+#define CORPUS_MAX_SIZE     8192
+
+typedef struct {
+    char name[64];
+    char *data;
+    size_t len;
+} corpus_file_t;
+
+static corpus_file_t s_corpus[CORPUS_MAX_FILES];
+static int s_corpus_count = 0;
+
+static uint32_t s_rng = 0x2545F491u;
+
+static uint32_t rand_u32(void)
+{
+    s_rng ^= s_rng << 13;
+    s_rng ^= s_rng >> 17;
+    s_rng ^= s_rng << 5;
+    return s_rng;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Zapis callbackov
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief Povzetek enega prehoda: zgoščena vrednost vseh (pot, tip, vrednost)
+ */
+typedef struct {
+    uint32_t hash;
+    uint32_t events;
+    bool ok;                // shelly_json_feed ni vrnil false
+    bool done;
+    bool bounds_ok;         // Vrednosti in globina vedno znotraj mej
+    const char *want_path;  // Iskana pot (lahko NULL)
+    shelly_json_type_t found_type;
+    char found[SHELLY_JSON_VALUE_LEN];
+    bool has_found;
+} run_result_t;
+
+/**
+ * @brief Pot kot niz: ključi in [indeks], ločeni s piko ("relays.[0].ison")
+ */
+static void build_path(const shelly_json_t *p, char *out, size_t max_len)
+{
+    size_t len = 0;
+    out[0] = '\0';
+
+    for (uint8_t i = 0; i < p->depth && len < max_len; i++) {
+        const shelly_json_frame_t *f = &p->stack[i];
+        if (f->is_array) {
+            len += snprintf(out + len, max_len - len, "%s[%u]", i ? "." : "", f->index);
+        } else {
+            len += snprintf(out + len, max_len - len, "%s%s", i ? "." : "", f->key);
+        }
+    }
+}
+
+static uint32_t fnv1a(uint32_t hash, const void *data, size_t len)
+{
+    const uint8_t *b = data;
+    for (size_t i = 0; i < len; i++) {
+        hash = (hash ^ b[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static void record_cb(const shelly_json_t *parser, shelly_json_type_t type, const char *value, void *ctx)
+{
+    run_result_t *r = ctx;
+    char path[256];
+    uint8_t t = (uint8_t)type;
+
+    if (strlen(value) >= SHELLY_JSON_VALUE_LEN || parser->depth > SHELLY_JSON_MAX_DEPTH) {
+        r->bounds_ok = false;
+    }
+
+    build_path(parser, path, sizeof(path));
+    r->hash = fnv1a(r->hash, path, strlen(path) + 1);
+    r->hash = fnv1a(r->hash, &t, 1);
+    r->hash = fnv1a(r->hash, value, strlen(value) + 1);
+    r->events++;
+
+    if (r->want_path && !r->has_found && strcmp(path, r->want_path) == 0) {
+        r->has_found = true;
+        r->found_type = type;
+        strncpy(r->found, value, sizeof(r->found) - 1);
+    }
+}
+
+/**
+ * @brief Celoten dokument po kosih; chunk = 0 → naključni kosi 1..600 B
+ */
+static void run(const char *data, size_t len, size_t chunk, const char *want_path, run_result_t *r)
+{
+    shelly_json_t parser;
+
+    memset(r, 0, sizeof(*r));
+    r->hash = 2166136261u;
+    r->ok = true;
+    r->bounds_ok = true;
+    r->want_path = want_path;
+    shelly_json_init(&parser, record_cb, r);
+
+    for (size_t off = 0; off < len; ) {
+        size_t n = chunk ? chunk : 1 + rand_u32() % 600;
+        if (n > len - off) {
+            n = len - off;
+        }
+        if (!shelly_json_feed(&parser, data + off, n)) {
+            r->ok = false;
+            // Po napaki parser ne sprejme ničesar več
+            if (shelly_json_feed(&parser, "{}", 2) || parser.bytes > len) {
+                r->bounds_ok = false;
+            }
+            break;
+        }
+        off += n;
+    }
+
+    if (parser.depth > SHELLY_JSON_MAX_DEPTH || parser.buf_len >= SHELLY_JSON_VALUE_LEN) {
+        r->bounds_ok = false;
+    }
+    r->done = shelly_json_done(&parser);
+}
+
+static bool same_result(const run_result_t *a, const run_result_t *b)
+{
+    return a->hash == b->hash && a->events == b->events && a->ok == b->ok && a->done == b->done;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Korpus
+// ═══════════════════════════════════════════════════════════
+
+static int cmp_names(const void *a, const void *b)
+{
+    return strcmp(((const corpus_file_t *)a)->name, ((const corpus_file_t *)b)->name);
+}
+
+static bool load_corpus(const char *dir_path)
+{
+    DIR *dir = opendir(dir_path);
+    struct dirent *ent;
+
+    if (dir == NULL) {
+        fprintf(stderr, "Cannot open corpus %s\n", dir_path);
+        return false;
+    }
+
+    while ((ent = readdir(dir)) != NULL && s_corpus_count < CORPUS_MAX_FILES) {
+        size_t name_len = strlen(ent->d_name);
+        if (name_len < 6 || strcmp(ent->d_name + name_len - 5, ".json") != 0 ||
+            name_len >= sizeof(s_corpus[0].name)) {
+            continue;
+        }
+
+        char path[512];
+        snprintf(path, sizeof(path), "%s/%s", dir_path, ent->d_name);
+        FILE *f = fopen(path, "rb");
+        if (f == NULL) {
+            continue;
+        }
+
+        corpus_file_t *c = &s_corpus[s_corpus_count];
+        c->data = malloc(CORPUS_MAX_SIZE);
+        c->len = fread(c->data, 1, CORPUS_MAX_SIZE, f);
+        fclose(f);
+        strcpy(c->name, ent->d_name);
+        s_corpus_count++;
+    }
+    closedir(dir);
+
+    qsort(s_corpus, s_corpus_count, sizeof(s_corpus[0]), cmp_names);
+    return s_corpus_count > 0;
+}
+
+static bool is_bad(const corpus_file_t *c)
+{
+    return strncmp(c->name, "bad_", 4) == 0;
+}
+
+static const corpus_file_t *find_file(const char *name)
+{
+    for (int i = 0; i < s_corpus_count; i++) {
+        if (strcmp(s_corpus[i].name, name) == 0) {
+            return &s_corpus[i];
+        }
+    }
+    return NULL;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Testi
+// ═══════════════════════════════════════════════════════════
+
+static void test_corpus_parses(void)
+{
+    run_result_t r;
+
+    for (int i = 0; i < s_corpus_count; i++) {
+        const corpus_file_t *c = &s_corpus[i];
+        run(c->data, c->len, c->len, NULL, &r);
+        if (r.done == is_bad(c) || !r.bounds_ok) {
+            fprintf(stderr, "  %s: done=%d events=%u\n", c->name, r.done, (unsigned)r.events);
+        }
+        TEST_CHECK(r.done == !is_bad(c));
+        TEST_CHECK(r.bounds_ok);
+    }
+}
+
+static void test_chunking_invariant(void)
+{
+    static const size_t chunks[] = { 1, 2, 3, 5, 7, 13, 64, 512 };
+    run_result_t whole, part;
+
+    for (int i = 0; i < s_corpus_count; i++) {
+        const corpus_file_t *c = &s_corpus[i];
+        run(c->data, c->len, c->len, NULL, &whole);
+
+        for (size_t k = 0; k < sizeof(chunks) / sizeof(chunks[0]); k++) {
+            run(c->data, c->len, chunks[k], NULL, &part);
+            if (!same_result(&whole, &part)) {
+                fprintf(stderr, "  %s: chunk %zu differs\n", c->name, chunks[k]);
+            }
+            TEST_CHECK(same_result(&whole, &part));
+        }
+    }
+}
+
+typedef struct {
+    const char *file;
+    const char *path;
+    shelly_json_type_t type;
+    const char *value;
+} expected_value_t;
+
+static const expected_value_t s_expected[] = {
+    { "gen1_relay.json",             "ison",                     SHELLY_JSON_TRUE,   "true" },
+    { "gen1_status.json",            "relays.[0].ison",          SHELLY_JSON_TRUE,   "true" },
+    { "gen1_status.json",            "relays.[1].ison",          SHELLY_JSON_FALSE,  "false" },
+    { "gen1_status.json",            "meters.[0].power",         SHELLY_JSON_NUMBER, "1834.27" },
+    { "gen1_status.json",            "tmp.tC",                   SHELLY_JSON_NUMBER, "51.43" },
+    // 32 znakov → odrezano na SHELLY_JSON_VALUE_LEN - 1
+    { "gen1_status.json",            "update.new_version",       SHELLY_JSON_STRING, "20230913-112234/v1.14.0-gcb8462" },
+    { "gen3_shelly_getstatus.json",  "switch:0.output",          SHELLY_JSON_TRUE,   "true" },
+    { "gen3_shelly_getstatus.json",  "switch:0.apower",          SHELLY_JSON_NUMBER, "1834.3" },
+    { "gen3_shelly_getstatus.json",  "switch:0.temperature.tC",  SHELLY_JSON_NUMBER, "52.1" },
+    { "gen3_shelly_getstatus.json",  "switch:1.output",          SHELLY_JSON_FALSE,  "false" },
+    { "gen3_shelly_getstatus.json",  "input:1.state",            SHELLY_JSON_NULL,   "null" },
+    { "gen3_shelly_getstatus.json",  "wifi.ssid",                SHELLY_JSON_STRING, "doma \"zgoraj\"" },
+    { "gen3_shelly_getstatus.json",  "wifi.rssi",                SHELLY_JSON_NUMBER, "-61" },
+    { "gen3_switch_getstatus.json",  "apower",                   SHELLY_JSON_NUMBER, "1523.4" },
+    { "gen3_switch_getstatus.json",  "temperature.tC",           SHELLY_JSON_NUMBER, "48.2" },
+    { "rpc_batch_set_status.json",   "[1].result.output",        SHELLY_JSON_TRUE,   "true" },
+    { "rpc_batch_set_status.json",   "[1].result.temperature.tC", SHELLY_JSON_NUMBER, "48.2" },
+    { "rpc_batch_element_error.json", "[0].error.code",          SHELLY_JSON_NUMBER, "-105" },
+    { "rpc_top_error.json",          "error.code",               SHELLY_JSON_NUMBER, "-32700" },
+    { "ws_notify_status.json",       "params.switch:0.apower",   SHELLY_JSON_NUMBER, "1836.9" },
+    { "ws_notify_deep.json",         "params.events.[0].event",  SHELLY_JSON_STRING, "scheduled_restart" },
+};
+
+static void test_expected_values(void)
+{
+    run_result_t r;
+
+    for (size_t i = 0; i < sizeof(s_expected) / sizeof(s_expected[0]); i++) {
+        const expected_value_t *e = &s_expected[i];
+        const corpus_file_t *c = find_file(e->file);
+
+        TEST_CHECK(c != NULL);
+        if (c == NULL) {
+            continue;
+        }
+        run(c->data, c->len, 7, e->path, &r);
+        if (!r.has_found || r.found_type != e->type || strcmp(r.found, e->value) != 0) {
+            fprintf(stderr, "  %s %s: got '%s'\n", e->file, e->path, r.has_found ? r.found : "(none)");
+        }
+        TEST_CHECK(r.has_found);
+        TEST_CHECK(r.found_type == e->type);
+        TEST_CHECK(strcmp(r.found, e->value) == 0);
+    }
+}
+
+static void test_pattern_match(void)
+{
+    // Pot globlje od SHELLY_JSON_MAX_DEPTH se preskoči, ostanek dokumenta ne
+    const corpus_file_t *c = find_file("ws_notify_deep.json");
+    run_result_t r;
+
+    TEST_CHECK(c != NULL);
+    if (c) {
+        run(c->data, c->len, 1, "params.events.[0].data.a.b.c.d", &r);
+        TEST_CHECK(!r.has_found);
+        TEST_CHECK(r.done);
+    }
+}
+
+/**
+ * @brief Ena naključna mutacija dokumenta v out (vrne dolžino)
+ */
+static size_t mutate(const corpus_file_t *c, char *out, size_t max_len)
+{
+    static const char alphabet[] = "{}[]\":,\\ \n0123456789-.eEtrufalsn";
+    size_t len = c->len < max_len ? c->len : max_len;
+    memcpy(out, c->data, len);
+
+    int ops = 1 + rand_u32() % 4;
+    for (int op = 0; op < ops && len > 0; op++) {
+        size_t pos = rand_u32() % len;
+        switch (rand_u32() % 6) {
+            case 0:     // Zamenjan byte
+                out[pos] = alphabet[rand_u32() % (sizeof(alphabet) - 1)];
+                break;
+            case 1:     // Naključen byte (tudi 0 in visoki biti)
+                out[pos] = (char)(rand_u32() & 0xFF);
+                break;
+            case 2:     // Vrinjen byte
+                if (len < max_len) {
+                    memmove(out + pos + 1, out + pos, len - pos);
+                    out[pos] = alphabet[rand_u32() % (sizeof(alphabet) - 1)];
+                    len++;
+                }
+                break;
+            case 3: {   // Izbrisan odsek
+                size_t n = 1 + rand_u32() % 16;
+                if (n > len - pos) {
+                    n = len - pos;
+                }
+                memmove(out + pos, out + pos + n, len - pos - n);
+                len -= n;
+                break;
+            }
+            case 4:     // Odrezan konec (prekinjena povezava)
+                len = pos;
+                break;
+            case 5: {   // Globoko gnezdenje ali dolg niz/ključ
+                size_t n = 1 + rand_u32() % 64;
+                char fill = (rand_u32() & 1) ? '[' : 'x';
+                if (len + n <= max_len) {
+                    memmove(out + pos + n, out + pos, len - pos);
+                    memset(out + pos, fill, n);
+                    len += n;
+                }
+                break;
+            }
+        }
+    }
+    return len;
+}
+
+static long s_mutations = 2000;
+
+static void test_fuzz_mutations(void)
+{
+    static char buf[CORPUS_MAX_SIZE + 1024];
+    run_result_t whole, part;
+    long runs = 0, accepted = 0;
+
+    for (int i = 0; i < s_corpus_count; i++) {
+        for (long m = 0; m < s_mutations; m++) {
+            size_t len = mutate(&s_corpus[i], buf, sizeof(buf));
+
+            run(buf, len, len ? len : 1, NULL, &whole);
+            run(buf, len, 0, NULL, &part);
+            runs++;
+            accepted += whole.done;
+
+            if (!whole.bounds_ok || !part.bounds_ok || !same_result(&whole, &part)) {
+                fprintf(stderr, "  %s mutation %ld: bounds %d/%d, same %d\n", s_corpus[i].name, m,
+                        whole.bounds_ok, part.bounds_ok, same_result(&whole, &part));
+                TEST_CHECK(false);
+                return;
+            }
+        }
+    }
+    printf("  %ld mutations, %ld still complete documents\n", runs, accepted);
+}
+
+int main(int argc, char **argv)
+{
+    if (argc < 2 || !load_corpus(argv[1])) {
+        fprintf(stderr, "usage: %s <corpus dir> [mutations per file]\n", argv[0]);
+        return 1;
+    }
+    if (argc > 2) {
+        s_mutations = atol(argv[2]);
+    }
+    printf("  corpus: %d files\n", s_corpus_count);
+
+    TEST_RUN(test_corpus_parses);
+    TEST_RUN(test_chunking_invariant);
+    TEST_RUN(test_expected_values);
+    TEST_RUN(test_pattern_match);
+    TEST_RUN(test_fuzz_mutations);
+    return TEST_EXIT();
+}
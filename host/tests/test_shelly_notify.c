@@ -0,0 +1,256 @@
+/**
+ * @file test_shelly_notify.c
+ * @brief Unit testi za shelly_notify.c z nadomestnim WebSocket odjemalcem
+ *
+ * Test sam poda okvirje, kot jih esp_websocket_client dostavi handlerju:
+ * velik okvir v več kosih (payload_offset), sporočilo v več okvirjih
+ * (TEXT + CONTINUATION, FIN na zadnjem) in kontrolne okvirje vmes.
+ */
+#include "shelly_manager.h"
+#include "shelly_notify.h"
+#include "host_port.h"
+#include "esp_log.h"
+#include "test_common.h"
+#include <string.h>
+
+#define OP_CONT     0x00
+#define OP_TEXT     0x01
+#define OP_PING     0x09
+
+static const char s_notify_on[] =
+    "{\"src\":\"shellyplus2pm-1\",\"dst\":\"tbox3\",\"method\":\"NotifyStatus\","
+    "\"params\":{\"ts\":1760000000.12,\"switch:0\":{\"id\":0,\"output\":true,\"apower\":1234.5}}}";
+
+static const char s_notify_ch1[] =
+    "{\"src\":\"shellyplus2pm-1\",\"dst\":\"tbox3\",\"method\":\"NotifyStatus\","
+    "\"params\":{\"ts\":1760000001.50,\"switch:1\":{\"id\":1,\"apower\":42.0}}}";
+
+// ═══════════════════════════════════════════════════════════
+// shelly_manager funkcije, ki jih uporablja shelly_notify.c
+// ═══════════════════════════════════════════════════════════
+
+static char s_ip[32] = "192.168.0.111";
+
+shelly_api_t shelly_manager_get_api(void)
+{
+    return SHELLY_API_RPC;
+}
+
+void shelly_manager_get_ip(char *ip_str, size_t max_len)
+{
+    strncpy(ip_str, s_ip, max_len - 1);
+    ip_str[max_len - 1] = '\0';
+}
+
+static shelly_notify_t s_events[8];
+static int s_event_count = 0;
+
+static void notify_cb(const shelly_notify_t *event)
+{
+    if (s_event_count < (int)(sizeof(s_events) / sizeof(s_events[0]))) {
+        s_events[s_event_count] = *event;
+    }
+    s_event_count++;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Pomožne funkcije
+// ═══════════════════════════════════════════════════════════
+
+/**
+ * @brief En okvir, dostavljen v kosih po chunk bytov
+ */
+static void send_frame(uint8_t op_code, bool fin, const char *payload, int len, int chunk)
+{
+    for (int offset = 0; offset < len || (len == 0 && offset == 0); offset += chunk) {
+        int n = (len - offset < chunk) ? len - offset : chunk;
+        esp_websocket_event_data_t data = {
+            .data_ptr = payload + offset,
+            .data_len = n,
+            .fin = fin,
+            .op_code = op_code,
+            .payload_len = len,
+            .payload_offset = offset,
+        };
+        host_ws_event(WEBSOCKET_EVENT_DATA, &data);
+        if (len == 0) {
+            break;
+        }
+    }
+}
+
+/**
+ * @brief Sporočilo razdeljeno na okvirje po frame_len bytov
+ */
+static void send_fragmented(const char *msg, int frame_len, int chunk)
+{
+    int len = (int)strlen(msg);
+
+    for (int offset = 0; offset < len; offset += frame_len) {
+        int n = (len - offset < frame_len) ? len - offset : frame_len;
+        send_frame(offset == 0 ? OP_TEXT : OP_CONT, offset + n >= len, msg + offset, n, chunk);
+    }
+}
+
+static void reset_events(void)
+{
+    memset(s_events, 0, sizeof(s_events));
+    s_event_count = 0;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Testi
+// ═══════════════════════════════════════════════════════════
+
+static void test_start_and_subscribe(void)
+{
+    host_ws_stats_t ws;
+
+    shelly_manager_register_notify_callback(notify_cb);
+    TEST_CHECK(shelly_manager_notify_start() == ESP_OK);
+    host_ws_get_stats(&ws);
+    TEST_CHECK(ws.running);
+    TEST_CHECK(strcmp(ws.uri, "ws://192.168.0.111/rpc") == 0);
+
+    TEST_CHECK(!shelly_manager_notify_connected());
+    host_ws_event(WEBSOCKET_EVENT_CONNECTED, NULL);
+    TEST_CHECK(shelly_manager_notify_connected());
+
+    // Shelly.GetStatus s "src" vklopi obvestila
+    host_ws_get_stats(&ws);
+    TEST_CHECK(ws.texts_sent == 1);
+}
+
+static void test_single_frame(void)
+{
+    reset_events();
+    send_frame(OP_TEXT, true, s_notify_on, (int)strlen(s_notify_on), 4096);
+
+    TEST_CHECK(s_event_count == 1);
+    TEST_CHECK(s_events[0].channel == 0);
+    TEST_CHECK(s_events[0].has_output && s_events[0].output);
+    TEST_CHECK(s_events[0].has_power);
+    TEST_CHECK_FLOAT(s_events[0].power, 1234.5f, 1e-3);
+}
+
+static void test_frame_in_chunks(void)
+{
+    // Okvir večji od bufferja odjemalca: isti okvir, naraščajoč payload_offset
+    for (int chunk = 1; chunk <= 64; chunk *= 2) {
+        reset_events();
+        send_frame(OP_TEXT, true, s_notify_ch1, (int)strlen(s_notify_ch1), chunk);
+        TEST_CHECK(s_event_count == 1);
+        TEST_CHECK(s_events[0].channel == 1);
+        TEST_CHECK(!s_events[0].has_output);
+        TEST_CHECK_FLOAT(s_events[0].power, 42.0f, 1e-3);
+    }
+}
+
+static void test_fragmented_message(void)
+{
+    // Vsak CONTINUATION okvir ima payload_offset spet 0 - parser se ne sme ponastaviti
+    static const int frame_lens[] = { 1, 7, 32, 100 };
+    static const int chunks[] = { 1, 5, 4096 };
+
+    for (size_t f = 0; f < sizeof(frame_lens) / sizeof(frame_lens[0]); f++) {
+        for (size_t c = 0; c < sizeof(chunks) / sizeof(chunks[0]); c++) {
+            reset_events();
+            send_fragmented(s_notify_on, frame_lens[f], chunks[c]);
+            TEST_CHECK(s_event_count == 1);
+            TEST_CHECK(s_events[0].has_output && s_events[0].output);
+            TEST_CHECK_FLOAT(s_events[0].power, 1234.5f, 1e-3);
+        }
+    }
+}
+
+static void test_control_frame_between_fragments(void)
+{
+    int len = (int)strlen(s_notify_on);
+    int half = len / 2;
+
+    reset_events();
+    send_frame(OP_TEXT, false, s_notify_on, half, 4096);
+    send_frame(OP_PING, true, "", 0, 4096);      // Kontrolni okvir sme biti vmes
+    TEST_CHECK(s_event_count == 0);
+    send_frame(OP_CONT, true, s_notify_on + half, len - half, 4096);
+
+    TEST_CHECK(s_event_count == 1);
+    TEST_CHECK_FLOAT(s_events[0].power, 1234.5f, 1e-3);
+}
+
+static void test_no_dispatch_before_fin(void)
+{
+    int len = (int)strlen(s_notify_on);
+
+    reset_events();
+    // Cel dokument v prvem okvirju, a brez FIN - sporočilo še ni končano
+    send_frame(OP_TEXT, false, s_notify_on, len, 4096);
+    TEST_CHECK(s_event_count == 0);
+    send_frame(OP_CONT, true, "", 0, 4096);
+    TEST_CHECK(s_event_count == 1);
+}
+
+static void test_orphan_continuation_after_reconnect(void)
+{
+    int len = (int)strlen(s_notify_on);
+    int half = len / 2;
+
+    reset_events();
+    send_frame(OP_TEXT, false, s_notify_on, half, 4096);
+    host_ws_event(WEBSOCKET_EVENT_DISCONNECTED, NULL);
+    TEST_CHECK(!shelly_manager_notify_connected());
+    host_ws_event(WEBSOCKET_EVENT_CONNECTED, NULL);
+
+    // Ostanek starega sporočila se zavrže, novo sporočilo pa gre skozi
+    send_frame(OP_CONT, true, s_notify_on + half, len - half, 4096);
+    TEST_CHECK(s_event_count == 0);
+    send_frame(OP_TEXT, true, s_notify_ch1, (int)strlen(s_notify_ch1), 4096);
+    TEST_CHECK(s_event_count == 1);
+    TEST_CHECK(s_events[0].channel == 1);
+}
+
+static void test_ip_change_restarts_client(void)
+{
+    host_ws_stats_t before, after;
+    host_ws_get_stats(&before);
+
+    strcpy(s_ip, "192.168.0.120");
+    shelly_notify_ip_changed();
+
+    host_ws_get_stats(&after);
+    TEST_CHECK(after.running);
+    TEST_CHECK(after.stops == before.stops + 1);
+    TEST_CHECK(after.starts == before.starts + 1);
+    TEST_CHECK(strcmp(after.uri, "ws://192.168.0.120/rpc") == 0);
+    TEST_CHECK(!shelly_manager_notify_connected());
+
+    // Nova povezava se znova naroči na obvestila
+    host_ws_event(WEBSOCKET_EVENT_CONNECTED, NULL);
+    host_ws_get_stats(&after);
+    TEST_CHECK(shelly_manager_notify_connected());
+    TEST_CHECK(after.texts_sent == before.texts_sent + 1);
+
+    shelly_manager_notify_stop();
+    host_ws_get_stats(&after);
+    TEST_CHECK(!after.running);
+
+    // Kanal ni zagnan → sprememba IP ga ne zažene
+    shelly_notify_ip_changed();
+    host_ws_get_stats(&after);
+    TEST_CHECK(!after.running);
+}
+
+int main(void)
+{
+    esp_log_level_set("*", ESP_LOG_ERROR);
+
+    TEST_RUN(test_start_and_subscribe);
+    TEST_RUN(test_single_frame);
+    TEST_RUN(test_frame_in_chunks);
+    TEST_RUN(test_fragmented_message);
+    TEST_RUN(test_control_frame_between_fragments);
+    TEST_RUN(test_no_dispatch_before_fin);
+    TEST_RUN(test_orphan_continuation_after_reconnect);
+    TEST_RUN(test_ip_change_restarts_client);
+    return TEST_EXIT();
+}
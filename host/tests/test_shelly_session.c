@@ -0,0 +1,244 @@
+/**
+ * @file test_shelly_session.c
+ * @brief Keep-alive seja shelly_manager-ja proti lokalnemu HTTP strežniku
+ *
+ * Prevede se pravi shelly_manager.c; esp_http_client je host nadomestek
+ * na POSIX socketih, Shelly pa test_http_server na 127.0.0.1.
+ */
+#include "shelly_manager.h"
+#include "host_port.h"
+#include "esp_log.h"
+#include "test_common.h"
+#include "test_http_server.h"
+#include <stdio.h>
+#include <string.h>
+#include <unistd.h>
+
+// Gen1 /status (Shelly 2.5) - večji od 1 KB, pride v več ON_DATA kosih
+static const char s_gen1_status[] =
+    "{\"wifi_sta\":{\"connected\":true,\"ssid\":\"doma\",\"ip\":\"192.168.0.111\",\"rssi\":-61},"
+    "\"cloud\":{\"enabled\":false,\"connected\":false},\"mqtt\":{\"connected\":false},"
+    "\"time\":\"21:14\",\"unixtime\":1760555640,\"serial\":4412,\"has_update\":false,"
+    "\"mac\":\"C45BBE6A1F20\",\"cfg_changed_cnt\":3,\"actions_stats\":{\"skipped\":0},"
+    "\"relays\":[{\"ison\":true,\"has_timer\":false,\"timer_started\":0,\"timer_duration\":0,"
+    "\"timer_remaining\":0,\"overpower\":false,\"overtemperature\":false,\"is_valid\":true,"
+    "\"source\":\"http\"},{\"ison\":false,\"has_timer\":false,\"timer_started\":0,"
+    "\"timer_duration\":0,\"timer_remaining\":0,\"overpower\":false,\"overtemperature\":false,"
+    "\"is_valid\":true,\"source\":\"input\"}],"
+    "\"meters\":[{\"power\":1834.27,\"overpower\":0.00,\"is_valid\":true,\"timestamp\":1760563840,"
+    "\"counters\":[1830.514,1829.221,1831.002],\"total\":8823411},{\"power\":0.00,"
+    "\"overpower\":0.00,\"is_valid\":true,\"timestamp\":1760563840,\"counters\":[0.000,0.000,0.000],"
+    "\"total\":120}],"
+    "\"inputs\":[{\"input\":0,\"event\":\"\",\"event_cnt\":0},{\"input\":1,\"event\":\"\",\"event_cnt\":0}],"
+    "\"temperature\":51.43,\"overtemperature\":false,\"tmp\":{\"tC\":51.43,\"tF\":124.57,"
+    "\"is_valid\":true},\"temperature_status\":\"Normal\","
+    "\"update\":{\"status\":\"idle\",\"has_update\":false,\"new_version\":\"20230913-112234/v1.14.0-gcb84623\","
+    "\"old_version\":\"20230913-112234/v1.14.0-gcb84623\",\"beta_version\":\"\"},"
+    "\"ram_total\":50264,\"ram_free\":36536,\"fs_size\":233681,\"fs_free\":146333,"
+    "\"voltage\":231.42,\"uptime\":873412}";
+
+static const char s_gen1_relay_ok[] =
+    "{\"ison\":true,\"has_timer\":false,\"timer_started\":0,\"timer_duration\":0,"
+    "\"timer_remaining\":0,\"overpower\":false,\"source\":\"http\"}";
+
+static test_http_request_t s_last_req;
+
+static void gen1_handler(const test_http_request_t *req, test_http_reply_t *reply)
+{
+    s_last_req = *req;
+    if (strcmp(req->path, "/status") == 0) {
+        reply->body = s_gen1_status;
+    } else if (strncmp(req->path, "/relay/", 7) == 0) {
+        reply->body = s_gen1_relay_ok;
+    } else {
+        reply->status = 404;
+    }
+}
+
+static void close_handler(const test_http_request_t *req, test_http_reply_t *reply)
+{
+    gen1_handler(req, reply);
+    reply->close = true;
+}
+
+static char s_device[32];
+
+// ═══════════════════════════════════════════════════════════
+// Testi
+// ═══════════════════════════════════════════════════════════
+
+static void test_status_over_socket(void)
+{
+    shelly_status_t st;
+    shelly_session_stats_t before, after;
+
+    shelly_manager_get_session_stats(&before);
+    TEST_CHECK(shelly_manager_get_status(&st) == ESP_OK);
+    shelly_manager_get_session_stats(&after);
+
+    TEST_CHECK(strcmp(s_last_req.method, "GET") == 0);
+    TEST_CHECK(strcmp(s_last_req.path, "/status") == 0);
+    TEST_CHECK(st.online);
+    TEST_CHECK(st.output_0 && !st.output_1);
+    TEST_CHECK_FLOAT(st.power_0, 1834.27f, 1e-2);
+    TEST_CHECK_FLOAT(st.temperature, 51.43f, 1e-2);
+    TEST_CHECK(after.bytes_rx - before.bytes_rx == sizeof(s_gen1_status) - 1);
+}
+
+static void test_keep_alive_reuse(void)
+{
+    shelly_status_t st;
+    shelly_session_stats_t before, after;
+    test_http_stats_t srv_before, srv_after;
+
+    shelly_manager_get_session_stats(&before);
+    test_http_server_get_stats(&srv_before);
+
+    // En kontrolni cikel je relay + status; 10 ciklov na eni povezavi
+    for (int i = 0; i < 10; i++) {
+        TEST_CHECK(shelly_manager_set_relay(0, i % 2) == ESP_OK);
+        TEST_CHECK(shelly_manager_get_status(&st) == ESP_OK);
+    }
+
+    shelly_manager_get_session_stats(&after);
+    test_http_server_get_stats(&srv_after);
+
+    TEST_CHECK(after.requests - before.requests == 20);
+    TEST_CHECK(after.reused - before.reused == 20);
+    TEST_CHECK(after.connects == before.connects);
+    TEST_CHECK(srv_after.connections == srv_before.connections);
+    TEST_CHECK(srv_after.requests - srv_before.requests == 20);
+    TEST_CHECK(strcmp(s_last_req.path, "/status") == 0);
+}
+
+static void test_reconnect_after_idle_close(void)
+{
+    shelly_status_t st;
+    shelly_session_stats_t before, after;
+    test_http_stats_t srv_before, srv_after;
+
+    shelly_manager_get_session_stats(&before);
+    test_http_server_get_stats(&srv_before);
+
+    // Shelly zapre idle povezavo - klicatelj tega ne sme opaziti
+    test_http_server_close_idle();
+    TEST_CHECK(shelly_manager_set_relay(0, true) == ESP_OK);
+    TEST_CHECK(strcmp(s_last_req.path, "/relay/0?turn=on") == 0);
+
+    shelly_manager_get_session_stats(&after);
+    test_http_server_get_stats(&srv_after);
+    TEST_CHECK(after.failures - before.failures == 1);
+    TEST_CHECK(after.reconnects - before.reconnects == 1);
+    TEST_CHECK(after.requests - before.requests == 2);
+    TEST_CHECK(srv_after.connections - srv_before.connections == 1);
+
+    // Nova povezava se spet uporablja naprej
+    shelly_manager_get_session_stats(&before);
+    TEST_CHECK(shelly_manager_get_status(&st) == ESP_OK);
+    shelly_manager_get_session_stats(&after);
+    TEST_CHECK(after.reused - before.reused == 1);
+    TEST_CHECK(after.connects == before.connects);
+}
+
+static void test_connection_close_reply(void)
+{
+    shelly_status_t st;
+    shelly_session_stats_t before, after;
+    test_http_stats_t srv_before, srv_after;
+
+    test_http_server_set_handler(close_handler);
+    shelly_manager_get_session_stats(&before);
+    test_http_server_get_stats(&srv_before);
+
+    for (int i = 0; i < 3; i++) {
+        TEST_CHECK(shelly_manager_get_status(&st) == ESP_OK);
+    }
+
+    shelly_manager_get_session_stats(&after);
+    test_http_server_get_stats(&srv_after);
+    test_http_server_set_handler(gen1_handler);
+
+    // Strežnik zapre po vsakem odgovoru → nova povezava brez neuspelega poskusa
+    TEST_CHECK(after.failures == before.failures);
+    TEST_CHECK(after.requests - before.requests == 3);
+    TEST_CHECK(srv_after.connections - srv_before.connections >= 2);
+    TEST_CHECK(after.connects - before.connects == srv_after.connections - srv_before.connections);
+}
+
+static void test_device_unreachable(void)
+{
+    shelly_status_t st;
+    char closed_port[32];
+
+    // Port brez strežnika: napaka takoj, brez visenja
+    snprintf(closed_port, sizeof(closed_port), "127.0.0.1:1");
+    shelly_manager_set_ip(closed_port);
+    TEST_CHECK(shelly_manager_get_status(&st) != ESP_OK);
+    TEST_CHECK(!st.online);
+
+    shelly_manager_set_ip(s_device);
+    TEST_CHECK(shelly_manager_get_status(&st) == ESP_OK);
+    TEST_CHECK(st.online);
+}
+
+static shelly_result_t s_result;
+static volatile bool s_result_ready = false;
+
+static void result_cb(const shelly_result_t *result)
+{
+    s_result = *result;
+    s_result_ready = true;
+}
+
+static void test_io_task_queue(void)
+{
+    shelly_cmd_t cmd = { .type = SHELLY_CMD_SET_AND_STATUS, .channel = 0, .on = true };
+
+    shelly_manager_register_result_callback(result_cb);
+    s_result_ready = false;
+    TEST_CHECK(shelly_manager_post(&cmd) == ESP_OK);
+
+    for (int i = 0; i < 500 && !s_result_ready; i++) {
+        usleep(10000);
+    }
+    TEST_CHECK(s_result_ready);
+    TEST_CHECK(s_result.err == ESP_OK);
+    TEST_CHECK(s_result.status.online && s_result.status.output_0);
+    TEST_CHECK_FLOAT(s_result.status.power_0, 1834.27f, 1e-2);
+    shelly_manager_register_result_callback(NULL);
+}
+
+static void test_report(void)
+{
+    shelly_session_stats_t st;
+    shelly_manager_get_session_stats(&st);
+    printf("  requests %u, reused %u, connects %u, reconnects %u, failures %u, rx %u B\n",
+           (unsigned)st.requests, (unsigned)st.reused, (unsigned)st.connects,
+           (unsigned)st.reconnects, (unsigned)st.failures, (unsigned)st.bytes_rx);
+}
+
+int main(void)
+{
+    esp_log_level_set("*", ESP_LOG_NONE);
+
+    int port = test_http_server_start(gen1_handler);
+    if (port < 0) {
+        return 1;
+    }
+    snprintf(s_device, sizeof(s_device), "127.0.0.1:%d", port);
+    host_http_set_timeout_ms(1000);
+
+    shelly_manager_set_api(SHELLY_API_GEN1);
+    if (shelly_manager_init(s_device) != ESP_OK) {
+        return 1;
+    }
+
+    TEST_RUN(test_status_over_socket);
+    TEST_RUN(test_keep_alive_reuse);
+    TEST_RUN(test_reconnect_after_idle_close);
+    TEST_RUN(test_connection_close_reply);
+    TEST_RUN(test_device_unreachable);
+    TEST_RUN(test_io_task_queue);
+    TEST_RUN(test_report);
+    return TEST_EXIT();
+}
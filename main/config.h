@@ -5,6 +5,8 @@
 #ifndef CONFIG_H
 #define CONFIG_H
 
+#include "sdkconfig.h"
+
 // ════════════════════════════════════════════
 // NETWORK CONFIGURATION
 // ════════════════════════════════════════════
@@ -17,7 +19,9 @@
 // ════════════════════════════════════════════
 #define SHELLY_IP_ADDRESS           "192.168.0.111"  // ← SPREMENI TO!
 #define SHELLY_FURNACE_CHANNEL      0    // Kateri relay (0 ali 1)
-#define SHELLY_STATUS_INTERVAL_MS   10000 // Vsakih 10s preveri status
+#define SHELLY_API_MODE             SHELLY_API_RPC  // SHELLY_API_RPC (Gen2+) ali SHELLY_API_GEN1
+#define SHELLY_STATUS_INTERVAL_MS   30000 // Power/status brez push obvestil vsakih 30s
+#define SHELLY_RELAY_REFRESH_MS     300000 // Relay resync tudi brez spremembe (5 min)
 
 // ════════════════════════════════════════════
 // TEMPERATURE SETTINGS
@@ -25,6 +29,32 @@
 #define DEFAULT_TARGET_TEMP         20.0f
 #define MIN_TARGET_TEMP             15.0f
 #define MAX_TARGET_TEMP             30.0f
+#define TARGET_TEMP_STEP            0.5f   // En pritisk +/- gumba
+#define TARGET_TEMP_SETTLE_MS       800    // Furnace dobi target šele ko se nastavljanje umiri
+#define TEMP_HYSTERESIS_BELOW       (CONFIG_THERMOSTAT_TEMP_HYSTERESIS / 10.0f)        // → vklopi
+#define TEMP_HYSTERESIS_ABOVE       (CONFIG_THERMOSTAT_TEMP_HYSTERESIS_ABOVE / 10.0f)  // → izklopi
+
+// ════════════════════════════════════════════
+// SCHEDULE (tedenski urnik je v thermostat_loop.c)
+// ════════════════════════════════════════════
+#define SCHEDULE_COMFORT_TEMP       21.0f
+#define SCHEDULE_SETBACK_TEMP       18.0f  // Noč
+#define SCHEDULE_TIMEZONE           "CET-1CEST,M3.5.0,M10.5.0/3"
+#define SCHEDULE_SNTP_SERVER        "pool.ntp.org"
+
+// ════════════════════════════════════════════
+// CONTROL STRATEGY (menuconfig → Control Settings)
+// ════════════════════════════════════════════
+#if CONFIG_THERMOSTAT_CONTROL_PID
+#define FURNACE_CONTROL_MODE        FURNACE_CONTROL_PID
+#define PID_KP                      (CONFIG_THERMOSTAT_PID_KP / 100.0f)  // Duty na °C
+#define PID_TI_S                    CONFIG_THERMOSTAT_PID_TI_S
+#define PID_TD_S                    CONFIG_THERMOSTAT_PID_TD_S
+#define PID_CYCLE_S                 CONFIG_THERMOSTAT_PID_CYCLE_S
+#define PID_MIN_ON_OFF_S            CONFIG_THERMOSTAT_PID_MIN_ON_OFF_S
+#else
+#define FURNACE_CONTROL_MODE        FURNACE_CONTROL_HYSTERESIS
+#endif
 
 // ════════════════════════════════════════════
 // HARDWARE CONFIGURATION
@@ -34,22 +64,35 @@
 #define SENSOR_I2C_SDA_GPIO         41
 #define SENSOR_I2C_FREQ_HZ          100000
 
+// Filter pred termostatom (median-of-N + EMA/Kalman)
+#define SENSOR_FILTER_MEDIAN_LEN    5
+#define SENSOR_FILTER_SMOOTHER      SENSOR_SMOOTHER_EMA
+
 // ════════════════════════════════════════════
 // DISPLAY SETTINGS
 // ════════════════════════════════════════════
 #define DISPLAY_BRIGHTNESS_DEFAULT  30
 #define DISPLAY_BRIGHTNESS_NIGHT    10
 #define DISPLAY_BRIGHTNESS_MAX      100
+#define DISPLAY_BRIGHTNESS_DIM      5
+#define DISPLAY_DIM_AFTER_MS        30000   // Zatemni po 30 s brez dotika
+#define DISPLAY_BLANK_AFTER_MS      300000  // Izklopi po 5 min brez dotika
+#define DISPLAY_REFR_ACTIVE_MS      33      // ~30 FPS ob uporabi
+#define DISPLAY_REFR_IDLE_MS        250     // 4 FPS ko nihče ne gleda
+#define DISPLAY_NIGHT_START_HOUR    22
+#define DISPLAY_NIGHT_END_HOUR      6
 
 // ════════════════════════════════════════════
 // TIMING CONFIGURATION
 // ════════════════════════════════════════════
 #define SENSOR_READ_INTERVAL_MS     2000   // Vsake 2 sekundi
 #define UI_UPDATE_INTERVAL_MS       100
+#define BOOT_TIMEOUT_MS             (WIFI_CONNECT_TIMEOUT_MS + 15000)  // Boot timeline se izpiše najkasneje po tem
 
 // ════════════════════════════════════════════
 // UI COLORS (RGB HEX)
 // ════════════════════════════════════════════
+#define COLOR_TEXT                  0xFFFFFF
 #define COLOR_TEMP_NORMAL           0x00FF00
 #define COLOR_TEMP_ERROR            0xFF0000
 #define COLOR_HUMIDITY              0x00BFFF
@@ -57,6 +100,7 @@
 #define COLOR_FURNACE_OFF           0x808080
 #define COLOR_FURNACE_ERROR         0xFF6600
 #define COLOR_TARGET_TEMP           0xFFAA00
+#define COLOR_POWER                 0xFFFF00
 #define COLOR_BACKGROUND            0x003a57
 #define COLOR_WIFI_CONNECTED        0x00FF00
 #define COLOR_WIFI_DISCONNECTED     0xFF0000
@@ -3,8 +3,10 @@
  * @brief ESP32-S3-BOX-3 Thermostat z WiFi + Shelly 2PM kontrolo
  */
 #include <stdio.h>
+#include <time.h>
 #include "freertos/FreeRTOS.h"
 #include "freertos/task.h"
+#include "freertos/event_groups.h"
 #include "esp_log.h"
 
 // Config
@@ -17,59 +19,65 @@
 #include "wifi_manager.h"
 #include "shelly_manager.h"
 #include "furnace_controller.h"
+#include "thermostat_loop.h"
+#include "setpoint_manager.h"
+#include "boot_manager.h"
+#include "schedule_manager.h"
 
 static const char *TAG = "main";
 
-// Globalne spremenljivke
-static float target_temperature = DEFAULT_TARGET_TEMP;
+// Shelly/furnace se inicializira ob prvi povezavi (tudi če WiFi ob bootu ni bil na voljo)
+static volatile bool s_bringup_running = false;
+static EventGroupHandle_t s_furnace_events = NULL;
+#define FURNACE_ATTEMPT_BIT     BIT0    // Vsaj en bring-up poskus končan
 
 // ═══════════════════════════════════════════════════════════
-// WiFi Event Callback
+// Shelly & Furnace bring-up
 // ═══════════════════════════════════════════════════════════
-static void wifi_event_cb(bool connected, const char *ip_address)
+static void furnace_bringup_task(void *arg)
 {
-    if (connected) {
-        ESP_LOGI(TAG, "WiFi connected! IP: %s", ip_address);
-        
-        int8_t rssi = wifi_manager_get_rssi();
-        ui_manager_update_wifi_status(true, ip_address, rssi);
-    } else {
-        ESP_LOGW(TAG, "WiFi disconnected!");
-        ui_manager_update_wifi_status(false, NULL, -100);
-    }
+    // HTTP do Shellyja ne sme blokirati event loop-a
+    thermostat_loop_furnace_start();
+    s_bringup_running = false;
+    xEventGroupSetBits(s_furnace_events, FURNACE_ATTEMPT_BIT);
+    vTaskDelete(NULL);
 }
 
 // ═══════════════════════════════════════════════════════════
-// Furnace State Callback
+// WiFi Status Callback (povezava, IP, bar-i)
 // ═══════════════════════════════════════════════════════════
-static void furnace_state_cb(furnace_state_t state, float power_w)
+static void wifi_status_cb(const wifi_manager_status_t *status)
 {
-    const char *status_text;
-    uint32_t status_color;
-    
-    switch (state) {
-        case FURNACE_HEATING:
-            status_text = "HEATING";
-            status_color = COLOR_FURNACE_HEATING;
-            break;
-        case FURNACE_OFF:
-            status_text = "OFF";
-            status_color = COLOR_FURNACE_OFF;
-            break;
-        case FURNACE_ERROR:
-            status_text = "ERROR";
-            status_color = COLOR_FURNACE_ERROR;
-            break;
-        default:
-            status_text = "UNKNOWN";
-            status_color = COLOR_FURNACE_OFF;
-            break;
+    if (status->connected) {
+        ESP_LOGI(TAG, "WiFi connected! IP: %s, RSSI: %d dBm (%d bars)", 
+                 status->ip, status->rssi, status->bars);
+    } else {
+        ESP_LOGW(TAG, "WiFi disconnected!");
     }
     
-    ui_manager_update_furnace_status(status_text, status_color);
-    ui_manager_update_power(power_w, state != FURNACE_ERROR);
+    ui_manager_update_wifi_status(status->connected, status->ip, status->bars);
+    thermostat_loop_set_link(status->connected);
     
-    ESP_LOGI(TAG, "Furnace: %s, Power: %.1fW", status_text, power_w);
+    if (status->connected && !thermostat_loop_is_ready() && !s_bringup_running) {
+        s_bringup_running = true;
+        if (xTaskCreate(furnace_bringup_task, "furnace_up", 4096, NULL, 4, NULL) != pdPASS) {
+            ESP_LOGE(TAG, "Failed to start furnace bring-up task");
+            s_bringup_running = false;
+            // Neuspel poskus je tudi poskus - stage_shelly ne sme čakati v nedogled
+            xEventGroupSetBits(s_furnace_events, FURNACE_ATTEMPT_BIT);
+        }
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// Target temperatura (+/- gumba)
+// ═══════════════════════════════════════════════════════════
+static void ui_target_cb(int steps)
+{
+    // LVGL task: samo prikaz, furnace dobi vrednost ko se nastavljanje umiri
+    // (commit callback v thermostat_loop.c)
+    float target = setpoint_manager_adjust(steps);
+    ui_manager_set_target_temperature(target);
 }
 
 // ═══════════════════════════════════════════════════════════
@@ -77,145 +85,192 @@ static void furnace_state_cb(furnace_state_t state, float power_w)
 // ═══════════════════════════════════════════════════════════
 static void sensor_update_task(void *arg)
 {
-    sensor_data_t data;
-    
     ESP_LOGI(TAG, "Sensor task started");
     
     while (1) {
-        esp_err_t ret = sensor_manager_read(&data);
-        
-        if (ret == ESP_OK && data.valid) {
-            // Update UI
-            ui_manager_update_temperature(data.temperature, true);
-            ui_manager_update_humidity(data.humidity, true);
-            
-            // Update furnace controller (Shelly control logic)
-            if (wifi_manager_is_connected()) {
-                furnace_controller_update_temperature(data.temperature);
-            } else {
-                ESP_LOGW(TAG, "WiFi not connected, skipping Shelly control");
-            }
-            
-            ESP_LOGI(TAG, "Sensor: T=%.1f°C, H=%.1f%%, Target=%.1f°C", 
-                     data.temperature, data.humidity, target_temperature);
-        } else {
-            ESP_LOGW(TAG, "Sensor read failed");
-            ui_manager_show_sensor_error();
-        }
-        
-        vTaskDelay(pdMS_TO_TICKS(SENSOR_READ_INTERVAL_MS));
+        // Vzorec → UI → furnace_controller (thermostat_loop.c, isto poganja host replay)
+        thermostat_loop_sensor_step();
     }
 }
 
 // ═══════════════════════════════════════════════════════════
-// WiFi Status Monitor Task
+// Tedenski urnik
 // ═══════════════════════════════════════════════════════════
-static void wifi_monitor_task(void *arg)
+static void schedule_cb(const schedule_status_t *status, bool changed)
 {
-    char ip[16];
-    
-    while (1) {
-        if (wifi_manager_is_connected()) {
-            wifi_manager_get_ip(ip, sizeof(ip));
-            int8_t rssi = wifi_manager_get_rssi();
-            ui_manager_update_wifi_status(true, ip, rssi);
-        } else {
-            ui_manager_update_wifi_status(false, NULL, -100);
-        }
-        
-        vTaskDelay(pdMS_TO_TICKS(5000));  // Vsake 5 sekund
-    }
+    thermostat_loop_schedule_update(status, changed, time(NULL));
+}
+
+static void manual_target_cb(float target)
+{
+    // +/- gumba: override do naslednjega prehoda urnika
+    schedule_manager_set_override(target, 0);
 }
 
 // ═══════════════════════════════════════════════════════════
-// app_main - Entry Point
+// Boot stage-i (boot_manager jih zažene vzporedno)
 // ═══════════════════════════════════════════════════════════
-void app_main(void)
+enum {
+    STAGE_DISPLAY,
+    STAGE_UI,
+    STAGE_SENSOR,
+    STAGE_READOUT,
+    STAGE_SCHEDULE,
+    STAGE_NETWORK,
+    STAGE_SHELLY,
+    STAGE_COUNT
+};
+
+static esp_err_t stage_display(void)
 {
-    ESP_LOGI(TAG, "╔═══════════════════════════════════════╗");
-    ESP_LOGI(TAG, "║  ESP32-S3-BOX-3 Smart Thermostat     ║");
-    ESP_LOGI(TAG, "║  WiFi + Shelly 2PM Control           ║");
-    ESP_LOGI(TAG, "╚═══════════════════════════════════════╝");
-    
-    // ═══════════════════════════════════════════════════════
-    // FAZA 1: Display inicializacija
-    // ═══════════════════════════════════════════════════════
-    ESP_LOGI(TAG, "[1/6] Initializing display...");
-    ESP_ERROR_CHECK(display_manager_init());
+    esp_err_t ret = display_manager_init();
+    if (ret != ESP_OK) {
+        return ret;
+    }
     display_manager_set_brightness(DISPLAY_BRIGHTNESS_DEFAULT);
     
-    // ═══════════════════════════════════════════════════════
-    // FAZA 2: UI kreacija
-    // ═══════════════════════════════════════════════════════
-    ESP_LOGI(TAG, "[2/6] Creating UI...");
-    ESP_ERROR_CHECK(ui_manager_init());
-    ui_manager_set_target_temperature(target_temperature);
-    
-    // ═══════════════════════════════════════════════════════
-    // FAZA 3: WiFi povezava
-    // ═══════════════════════════════════════════════════════
-    ESP_LOGI(TAG, "[3/6] Connecting to WiFi...");
-    ESP_ERROR_CHECK(wifi_manager_init());
-    wifi_manager_register_callback(wifi_event_cb);
-    
-    esp_err_t wifi_ret = wifi_manager_connect(WIFI_SSID, WIFI_PASSWORD, WIFI_CONNECT_TIMEOUT_MS);
-    if (wifi_ret != ESP_OK) {
-        ESP_LOGE(TAG, "WiFi connection failed! Shelly control disabled.");
-        ui_manager_update_wifi_status(false, NULL, -100);
-        // Nadaljuj brez WiFi (samo local sensor + display)
+    display_power_config_t power_cfg = {
+        .brightness_dim = DISPLAY_BRIGHTNESS_DIM,
+        .brightness_night = DISPLAY_BRIGHTNESS_NIGHT,
+        .dim_after_ms = DISPLAY_DIM_AFTER_MS,
+        .blank_after_ms = DISPLAY_BLANK_AFTER_MS,
+        .refr_active_ms = DISPLAY_REFR_ACTIVE_MS,
+        .refr_idle_ms = DISPLAY_REFR_IDLE_MS,
+        .night_start_hour = DISPLAY_NIGHT_START_HOUR,
+        .night_end_hour = DISPLAY_NIGHT_END_HOUR,
+    };
+    return display_manager_set_power_policy(&power_cfg);
+}
+
+static esp_err_t stage_ui(void)
+{
+    esp_err_t ret = ui_manager_init();
+    if (ret != ESP_OK) {
+        return ret;
     }
+    ui_manager_set_flush_period(UI_UPDATE_INTERVAL_MS);
     
-    vTaskDelay(pdMS_TO_TICKS(500));
-    
-    // ═══════════════════════════════════════════════════════
-    // FAZA 4: Shelly & Furnace controller
-    // ═══════════════════════════════════════════════════════
-    ESP_LOGI(TAG, "[4/6] Initializing Shelly & Furnace controller...");
-    if (wifi_manager_is_connected()) {
-        esp_err_t furnace_ret = furnace_controller_init(SHELLY_IP_ADDRESS, SHELLY_FURNACE_CHANNEL);
-        if (furnace_ret == ESP_OK) {
-            furnace_controller_set_target(target_temperature);
-            furnace_controller_register_callback(furnace_state_cb);
-            ESP_LOGI(TAG, "Furnace controller ready");
-        } else {
-            ESP_LOGE(TAG, "Furnace controller init failed (Shelly offline?)");
-            ui_manager_update_furnace_status("ERROR", COLOR_FURNACE_ERROR);
-        }
-    } else {
-        ESP_LOGW(TAG, "WiFi not connected - skipping Shelly init");
+    thermostat_loop_config_t loop_cfg = THERMOSTAT_LOOP_DEFAULT_CONFIG();
+    loop_cfg.manual_cb = manual_target_cb;
+    ret = thermostat_loop_init(&loop_cfg);
+    if (ret != ESP_OK) {
+        return ret;
     }
-    
-    // ═══════════════════════════════════════════════════════
-    // FAZA 5: Sensor inicializacija
-    // ═══════════════════════════════════════════════════════
-    ESP_LOGI(TAG, "[5/6] Initializing sensor...");
-    esp_err_t sensor_ret = sensor_manager_init();
-    if (sensor_ret != ESP_OK) {
+    ui_manager_register_target_callback(ui_target_cb);
+    ui_manager_set_target_temperature(setpoint_manager_get());
+    return ESP_OK;
+}
+
+static esp_err_t stage_sensor(void)
+{
+    // Lasten I2C bus - ne čaka na display
+    esp_err_t ret = sensor_manager_init();
+    if (ret != ESP_OK) {
         ESP_LOGE(TAG, "Sensor init failed!");
         ESP_LOGE(TAG, "Check I2C connections: SCL=GPIO%d, SDA=GPIO%d", 
                  SENSOR_I2C_SCL_GPIO, SENSOR_I2C_SDA_GPIO);
-        ui_manager_show_sensor_error();
+        return ret;
+    }
+    
+    sensor_filter_config_t filter_cfg = SENSOR_FILTER_DEFAULT_CONFIG();
+    filter_cfg.median_len = SENSOR_FILTER_MEDIAN_LEN;
+    filter_cfg.smoother = SENSOR_FILTER_SMOOTHER;
+    sensor_manager_set_filter(&filter_cfg);
+    return sensor_manager_start(SENSOR_READ_INTERVAL_MS);
+}
+
+static esp_err_t stage_readout(void)
+{
+    if (!boot_manager_stage_ok(STAGE_SENSOR)) {
         // Nadaljuj brez senzorja (za debug UI + Shelly)
+        ui_manager_show_sensor_error();
+    }
+    
+    if (xTaskCreate(sensor_update_task, "sensor", 4096, NULL, 5, NULL) != pdPASS) {
+        return ESP_ERR_NO_MEM;
+    }
+    return ESP_OK;
+}
+
+static esp_err_t stage_schedule(void)
+{
+    esp_err_t ret = schedule_manager_init(thermostat_loop_schedule, thermostat_loop_schedule_count,
+                                          SCHEDULE_TIMEZONE);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    schedule_manager_register_callback(schedule_cb);
+    return ESP_OK;
+}
+
+static esp_err_t stage_network(void)
+{
+    esp_err_t ret = wifi_manager_init();
+    if (ret != ESP_OK) {
+        return ret;
     }
+    wifi_manager_register_status_callback(wifi_status_cb);
     
-    // ═══════════════════════════════════════════════════════
-    // FAZA 6: Štart FreeRTOS taskov
-    // ═══════════════════════════════════════════════════════
-    ESP_LOGI(TAG, "[6/6] Starting tasks...");
+    if (boot_manager_stage_ok(STAGE_SCHEDULE)) {
+        // SNTP čaka na povezavo sam; urnik začne veljati ob prvi sinhronizaciji
+        schedule_manager_start_sntp(SCHEDULE_SNTP_SERVER);
+    }
+    
+    ret = wifi_manager_connect(WIFI_SSID, WIFI_PASSWORD, WIFI_CONNECT_TIMEOUT_MS);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "WiFi connection failed! Reconnecting in background.");
+        ui_manager_update_wifi_status(false, NULL, 0);
+        // Nadaljuj brez WiFi (local sensor + display), Shelly pride ob povezavi
+    }
+    return ret;
+}
+
+static esp_err_t stage_shelly(void)
+{
+    // Bring-up sproži wifi_status_cb ob link-up - tu le počakamo na prvi poskus
+    xEventGroupWaitBits(s_furnace_events, FURNACE_ATTEMPT_BIT, pdFALSE, pdTRUE, portMAX_DELAY);
+    return thermostat_loop_is_ready() ? ESP_OK : ESP_FAIL;
+}
+
+static const boot_stage_t s_boot_stages[STAGE_COUNT] = {
+    [STAGE_DISPLAY]  = { .name = "display",  .fn = stage_display,  .stack_size = 6144 },
+    [STAGE_UI]       = { .name = "ui",       .fn = stage_ui,       .requires = BOOT_STAGE_BIT(STAGE_DISPLAY) },
+    [STAGE_SENSOR]   = { .name = "sensor",   .fn = stage_sensor },
+    [STAGE_READOUT]  = { .name = "readout",  .fn = stage_readout,  .requires = BOOT_STAGE_BIT(STAGE_UI),
+                         .after = BOOT_STAGE_BIT(STAGE_SENSOR) },
+    [STAGE_SCHEDULE] = { .name = "schedule", .fn = stage_schedule, .requires = BOOT_STAGE_BIT(STAGE_UI) },
+    [STAGE_NETWORK]  = { .name = "network",  .fn = stage_network,  .requires = BOOT_STAGE_BIT(STAGE_UI),
+                         .after = BOOT_STAGE_BIT(STAGE_SCHEDULE) },
+    [STAGE_SHELLY]   = { .name = "shelly",   .fn = stage_shelly,   .requires = BOOT_STAGE_BIT(STAGE_NETWORK) },
+};
+
+// ═══════════════════════════════════════════════════════════
+// app_main - Entry Point
+// ═══════════════════════════════════════════════════════════
+void app_main(void)
+{
+    ESP_LOGI(TAG, "╔═══════════════════════════════════════╗");
+    ESP_LOGI(TAG, "║  ESP32-S3-BOX-3 Smart Thermostat     ║");
+    ESP_LOGI(TAG, "║  WiFi + Shelly 2PM Control           ║");
+    ESP_LOGI(TAG, "╚═══════════════════════════════════════╝");
     
-    // Sensor reading task
-    xTaskCreate(sensor_update_task, "sensor", 4096, NULL, 5, NULL);
+    s_furnace_events = xEventGroupCreate();
+    ESP_ERROR_CHECK(s_furnace_events ? ESP_OK : ESP_ERR_NO_MEM);
     
-    // WiFi monitor task
-    xTaskCreate(wifi_monitor_task, "wifi_monitor", 2048, NULL, 4, NULL);
+    // Display → UI → (readout, schedule → network → shelly); senzor teče vzporedno od začetka
+    esp_err_t boot_ret = boot_manager_run(s_boot_stages, STAGE_COUNT, BOOT_TIMEOUT_MS);
+    if (!boot_manager_stage_ok(STAGE_DISPLAY) || !boot_manager_stage_ok(STAGE_UI)) {
+        // Brez UI-ja termostat ni uporaben - enako kot prej ESP_ERROR_CHECK
+        ESP_ERROR_CHECK(ESP_FAIL);
+    }
     
     ESP_LOGI(TAG, "");
     ESP_LOGI(TAG, "╔═══════════════════════════════════════╗");
-    ESP_LOGI(TAG, "║      System Running Successfully!    ║");
+    ESP_LOGI(TAG, "║  %-36s ║", boot_ret == ESP_OK ? "System Running Successfully!" : "System Running (degraded)");
     ESP_LOGI(TAG, "╠═══════════════════════════════════════╣");
-    ESP_LOGI(TAG, "║  Target: %.1f°C                       ║", target_temperature);
+    ESP_LOGI(TAG, "║  Target: %.1f°C                       ║", setpoint_manager_get());
     ESP_LOGI(TAG, "║  Shelly: %-20s        ║", SHELLY_IP_ADDRESS);
     ESP_LOGI(TAG, "║  WiFi:   %-20s        ║", WIFI_SSID);
     ESP_LOGI(TAG, "╚═══════════════════════════════════════╝");
     ESP_LOGI(TAG, "");
-}
\ No newline at end of file
+}
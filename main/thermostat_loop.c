@@ -0,0 +1,189 @@
+/**
+ * @file thermostat_loop.c
+ * @brief Kontrolna zanka termostata (skupna firmware-u in host replay-u)
+ */
+#include "thermostat_loop.h"
+#include "furnace_controller.h"
+#include "sensor_manager.h"
+#include "setpoint_manager.h"
+#include "ui_manager.h"
+#include "esp_log.h"
+
+static const char *TAG = "main";
+
+static thermostat_loop_config_t s_config = THERMOSTAT_LOOP_DEFAULT_CONFIG();
+static volatile bool s_link_up = false;
+static volatile bool s_furnace_ready = false;
+
+const schedule_period_t thermostat_loop_schedule[] = {
+    { SCHEDULE_WEEKDAYS,  6,  0, SCHEDULE_COMFORT_TEMP },
+    { SCHEDULE_WEEKDAYS, 22,  0, SCHEDULE_SETBACK_TEMP },
+    { SCHEDULE_WEEKEND,   7, 30, SCHEDULE_COMFORT_TEMP },
+    { SCHEDULE_WEEKEND,  23,  0, SCHEDULE_SETBACK_TEMP },
+};
+const size_t thermostat_loop_schedule_count =
+    sizeof(thermostat_loop_schedule) / sizeof(thermostat_loop_schedule[0]);
+
+// ═══════════════════════════════════════════════════════════
+// Target temperatura (commit iz setpoint_manager)
+// ═══════════════════════════════════════════════════════════
+static void setpoint_commit_cb(float target, bool manual)
+{
+    ESP_LOGI(TAG, "New target: %.1f°C%s", target, manual ? " (manual)" : "");
+
+    if (manual && s_config.manual_cb) {
+        // Ročna sprememba velja do naslednjega prehoda urnika
+        s_config.manual_cb(target);
+    }
+
+    furnace_controller_set_target(target);
+    if (s_link_up && s_furnace_ready) {
+        // Ne čakaj na naslednji sensor tick
+        furnace_controller_reevaluate();
+    }
+}
+
+esp_err_t thermostat_loop_init(const thermostat_loop_config_t *config)
+{
+    const thermostat_loop_config_t defaults = THERMOSTAT_LOOP_DEFAULT_CONFIG();
+
+    s_config = config ? *config : defaults;
+
+    esp_err_t ret = setpoint_manager_init(s_config.target, MIN_TARGET_TEMP, MAX_TARGET_TEMP,
+                                          TARGET_TEMP_STEP, TARGET_TEMP_SETTLE_MS);
+    if (ret != ESP_OK) {
+        return ret;
+    }
+    setpoint_manager_register_callback(setpoint_commit_cb);
+    return ESP_OK;
+}
+
+void thermostat_loop_set_link(bool up)
+{
+    s_link_up = up;
+}
+
+bool thermostat_loop_is_ready(void)
+{
+    return s_furnace_ready;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Furnace State Callback
+// ═══════════════════════════════════════════════════════════
+static void furnace_state_cb(furnace_state_t state, float power_w)
+{
+    const char *status_text;
+    uint32_t status_color;
+
+    switch (state) {
+        case FURNACE_HEATING:
+            status_text = "HEATING";
+            status_color = COLOR_FURNACE_HEATING;
+            break;
+        case FURNACE_OFF:
+            status_text = "OFF";
+            status_color = COLOR_FURNACE_OFF;
+            break;
+        case FURNACE_ERROR:
+            status_text = "ERROR";
+            status_color = COLOR_FURNACE_ERROR;
+            break;
+        default:
+            status_text = "UNKNOWN";
+            status_color = COLOR_FURNACE_OFF;
+            break;
+    }
+
+    ui_manager_update_furnace_status(status_text, status_color);
+    ui_manager_update_power(power_w, state != FURNACE_ERROR);
+
+    ESP_LOGI(TAG, "Furnace: %s, Power: %.1fW", status_text, power_w);
+}
+
+// ═══════════════════════════════════════════════════════════
+// Shelly & Furnace bring-up
+// ═══════════════════════════════════════════════════════════
+esp_err_t thermostat_loop_furnace_start(void)
+{
+    shelly_manager_set_api(s_config.api);
+    esp_err_t ret = furnace_controller_init(SHELLY_IP_ADDRESS, SHELLY_FURNACE_CHANNEL);
+    if (ret != ESP_OK) {
+        ESP_LOGE(TAG, "Furnace controller init failed (Shelly offline?)");
+        ui_manager_update_furnace_status("ERROR", COLOR_FURNACE_ERROR);
+        return ret;
+    }
+
+    furnace_controller_set_target(setpoint_manager_get());
+    furnace_controller_set_intervals(SHELLY_RELAY_REFRESH_MS, SHELLY_STATUS_INTERVAL_MS);
+
+    furnace_control_config_t control_cfg = FURNACE_CONTROL_DEFAULT_CONFIG();
+    control_cfg.mode = FURNACE_CONTROL_MODE;
+    control_cfg.hysteresis.below = TEMP_HYSTERESIS_BELOW;
+    control_cfg.hysteresis.above = TEMP_HYSTERESIS_ABOVE;
+#if CONFIG_THERMOSTAT_CONTROL_PID
+    control_cfg.kp = PID_KP;
+    control_cfg.ti_s = PID_TI_S;
+    control_cfg.td_s = PID_TD_S;
+    control_cfg.cycle_s = PID_CYCLE_S;
+    control_cfg.min_on_s = PID_MIN_ON_OFF_S;
+    control_cfg.min_off_s = PID_MIN_ON_OFF_S;
+#endif
+    furnace_controller_set_control(&control_cfg);
+    furnace_controller_register_callback(furnace_state_cb);
+    s_furnace_ready = true;
+    ESP_LOGI(TAG, "Furnace controller ready");
+    return ESP_OK;
+}
+
+// ═══════════════════════════════════════════════════════════
+// Sensor Update (en obhod sensor taska)
+// ═══════════════════════════════════════════════════════════
+void thermostat_loop_sensor_step(void)
+{
+    sensor_data_t data;
+
+    // Vzorce objavlja sampling task v sensor_manager - tu nikoli ne čakamo na I2C
+    esp_err_t ret = sensor_manager_wait(&data, SENSOR_READ_INTERVAL_MS * 2);
+
+    if (ret == ESP_OK && data.valid) {
+        // Update UI
+        ui_manager_update_temperature(data.temperature, true);
+        ui_manager_update_humidity(data.humidity, true);
+
+        // Update furnace controller (Shelly control logic)
+        // Termostat dobi filtrirano vrednost (manj preklapljanja releja ob šumu)
+        if (!s_link_up) {
+            ESP_LOGW(TAG, "WiFi not connected, skipping Shelly control");
+        } else if (!s_furnace_ready) {
+            ESP_LOGW(TAG, "Furnace controller not ready, skipping Shelly control");
+        } else {
+            furnace_controller_update_temperature(data.temperature_filtered);
+        }
+
+        ESP_LOGI(TAG, "Sensor: T=%.1f°C (filt %.2f°C), H=%.1f%%, Target=%.1f°C",
+                 data.temperature, data.temperature_filtered, data.humidity, setpoint_manager_get());
+    } else {
+        ESP_LOGW(TAG, "Sensor read failed");
+        ui_manager_show_sensor_error();
+    }
+}
+
+// ═══════════════════════════════════════════════════════════
+// Tedenski urnik
+// ═══════════════════════════════════════════════════════════
+void thermostat_loop_schedule_update(const schedule_status_t *status, bool changed, time_t now)
+{
+    if (changed) {
+        // Commit gre prek setpoint_commit_cb → furnace_controller_set_target
+        setpoint_manager_set(status->target);
+        ui_manager_set_target_temperature(setpoint_manager_get());
+    }
+
+    // Optimal start: kontroler sam odloči, kdaj začeti greti
+    if (s_config.optimal_start && status->next_change > now && status->next_target > status->target) {
+        furnace_controller_set_upcoming_target(status->next_target, (uint32_t)(status->next_change - now));
+    } else {
+        furnace_controller_set_upcoming_target(0.0f, 0);
+    }
+}
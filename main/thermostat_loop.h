@@ -0,0 +1,98 @@
+/**
+ * @file thermostat_loop.h
+ * @brief Kontrolna zanka termostata: vzorec → UI → furnace_controller
+ *
+ * Brez FreeRTOS, WiFi in display klicev - main.c jo poganja iz svojih
+ * taskov, host replay (host/replay) pa z navidezno uro nad posnetim ali
+ * simuliranim potekom temperature. Tako replay izvaja isto pot kot firmware.
+ */
+#ifndef THERMOSTAT_LOOP_H
+#define THERMOSTAT_LOOP_H
+
+#include "config.h"
+#include "esp_err.h"
+#include "shelly_manager.h"
+#include "schedule_table.h"
+#include <stdbool.h>
+#include <stddef.h>
+#include <time.h>
+
+/**
+ * @brief Callback ob ročnem commit-u targeta (+/- gumba)
+ * @param target Nova target temperatura v °C
+ */
+typedef void (*thermostat_loop_manual_cb_t)(float target);
+
+/**
+ * @brief Nastavitve zanke (firmware uporablja privzete iz config.h)
+ */
+typedef struct {
+    float target;                           // Začetni target (°C)
+    shelly_api_t api;                       // Shelly backend
+    bool optimal_start;                     // Kontroler dobi naslednji target iz urnika
+    thermostat_loop_manual_cb_t manual_cb;  // Main: override urnika (NULL = brez)
+} thermostat_loop_config_t;
+
+#define THERMOSTAT_LOOP_DEFAULT_CONFIG() {  \
+    .target = DEFAULT_TARGET_TEMP,          \
+    .api = SHELLY_API_MODE,                 \
+    .optimal_start = true,                  \
+    .manual_cb = NULL,                      \
+}
+
+/** Tedenski urnik (schedule_manager v firmware-u, navidezna ura v replay-u) */
+extern const schedule_period_t thermostat_loop_schedule[];
+extern const size_t thermostat_loop_schedule_count;
+
+/**
+ * @brief Nastavi zanko (pred thermostat_loop_furnace_start)
+ *
+ * Inicializira setpoint_manager z začetnim targetom in nanj priklopi
+ * commit callback (furnace_controller target + takojšnja ponovna ocena).
+ * Target se potem bere s setpoint_manager_get().
+ *
+ * @param config Nastavitve (NULL = THERMOSTAT_LOOP_DEFAULT_CONFIG)
+ * @return ESP_OK če uspešno
+ */
+esp_err_t thermostat_loop_init(const thermostat_loop_config_t *config);
+
+/**
+ * @brief Shelly & furnace controller: API, init, target, intervali, callback
+ *
+ * Main jo kliče iz bring-up taska ob vsaki povezavi, dokler ne uspe.
+ *
+ * @return ESP_OK če je kontroler pripravljen
+ */
+esp_err_t thermostat_loop_furnace_start(void);
+
+/**
+ * @brief Ali je furnace controller pripravljen (furnace_start je uspel)
+ */
+bool thermostat_loop_is_ready(void);
+
+/**
+ * @brief Stanje povezave do Shellyja (main: WiFi event, replay: vedno gor)
+ * @param up Ali je povezava vzpostavljena
+ */
+void thermostat_loop_set_link(bool up);
+
+/**
+ * @brief En obhod sensor taska: počakaj na vzorec in ga obdelaj
+ *
+ * Blokira v sensor_manager_wait() največ 2 periodi vzorčenja.
+ */
+void thermostat_loop_sensor_step(void);
+
+/**
+ * @brief Obdelaj stanje urnika (schedule_manager callback)
+ *
+ * Ob spremembi nastavi target prek setpoint_manager, ob vsakem klicu pa
+ * kontrolerju poda naslednji višji target za optimal start.
+ *
+ * @param status Stanje urnika
+ * @param changed Ali se je target spremenil
+ * @param now Trenutni čas (main: time(NULL), replay: navidezna ura)
+ */
+void thermostat_loop_schedule_update(const schedule_status_t *status, bool changed, time_t now);
+
+#endif // THERMOSTAT_LOOP_H